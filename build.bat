@@ -7,6 +7,8 @@ echo Building Opra - Cross-platform PDF Reader AI
 
 if "%1"=="macos" goto build_macos
 if "%1"=="windows" goto build_windows
+if "%1"=="cli" goto build_cli
+if "%1"=="bench" goto build_bench
 if "%1"=="all" goto build_all
 if "%1"=="" goto build_all
 goto usage
@@ -29,15 +31,31 @@ echo macOS build completed
 cd ..
 goto end
 
+:build_cli
+echo Building command-line converter...
+dotnet build windows\Opra.Cli\Opra.Cli.csproj -c Release
+if errorlevel 1 exit /b 1
+echo Windows CLI build completed
+goto end
+
+:build_bench
+echo Building benchmarks...
+dotnet build windows\Opra.Benchmarks\Opra.Benchmarks.csproj -c Release
+if errorlevel 1 exit /b 1
+echo Run: dotnet run -c Release --project windows\Opra.Benchmarks -- --filter *
+goto end
+
 :build_all
 call :build_macos
 call :build_windows
 goto end
 
 :usage
-echo Usage: %0 [macos^|windows^|all]
+echo Usage: %0 [macos^|windows^|cli^|bench^|all]
 echo   macos   - Build macOS app only
 echo   windows - Build Windows app only
+echo   cli     - Build the headless opra-cli converter only
+echo   bench   - Build the pipeline benchmarks
 echo   all     - Build everything (default)
 exit /b 1
 
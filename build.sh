@@ -41,6 +41,32 @@ build_windows() {
     cd ..
 }
 
+# Function to build the headless command-line converter
+build_cli() {
+    echo "Building command-line converter..."
+    if [[ "$(uname)" == "Darwin" ]]; then
+        swift build -c release --package-path macos
+        echo "macOS CLI built at macos/.build/release/opra-cli"
+    fi
+    if command -v dotnet >/dev/null 2>&1; then
+        dotnet build windows/Opra.Cli/Opra.Cli.csproj -c Release
+        echo "Windows CLI build completed"
+    fi
+}
+
+# Function to build the pipeline benchmarks
+build_bench() {
+    echo "Building benchmarks..."
+    if [[ "$(uname)" == "Darwin" ]]; then
+        swift build -c release --package-path macos
+        echo "Run: macos/.build/release/opra-cli benchmark --help"
+    fi
+    if command -v dotnet >/dev/null 2>&1; then
+        dotnet build windows/Opra.Benchmarks/Opra.Benchmarks.csproj -c Release
+        echo "Run: dotnet run -c Release --project windows/Opra.Benchmarks -- --filter '*'"
+    fi
+}
+
 # Main build logic
 case "${1:-all}" in
     "macos")
@@ -49,14 +75,22 @@ case "${1:-all}" in
     "windows")
         build_windows
         ;;
+    "cli")
+        build_cli
+        ;;
+    "bench")
+        build_bench
+        ;;
     "all")
         build_macos
         build_windows
         ;;
     *)
-        echo "Usage: $0 [macos|windows|all] [--no-sign]"
+        echo "Usage: $0 [macos|windows|cli|bench|all] [--no-sign]"
         echo "  macos   - Build macOS app only"
         echo "  windows - Build Windows app only"
+        echo "  cli     - Build the headless opra-cli converter only"
+        echo "  bench   - Build the pipeline benchmarks"
         echo "  all     - Build everything (default)"
         echo ""
         echo "Options:"
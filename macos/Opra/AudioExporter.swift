@@ -0,0 +1,237 @@
+//
+//  AudioExporter.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import AVFoundation
+import os
+
+struct AudioExportResult {
+    let pageCount: Int // pages that had text to speak
+    let duration: TimeInterval
+}
+
+/// Renders a whole document to an AAC audiobook file, without playing it.
+///
+/// Pages are synthesized one after another with `AVSpeechSynthesizer.write(_:toBufferCallback:)`,
+/// which runs as fast as the voice can render rather than in real time. Every buffer goes straight
+/// into the AAC encoder, so only the buffer being written is ever held in memory. Page starts are
+/// written next to the audio as `<name>.chapters.txt` (`HH:MM:SS.mmm Page N` per line), the format
+/// `mp4chaps -i` imports as chapter markers.
+@MainActor
+final class AudioExporter: ObservableObject {
+    @Published var isExporting: Bool = false
+    @Published var progress: Double = 0.0
+    @Published var statusMessage: String = ""
+    @Published var errorMessage: String?
+
+    private var exportTask: Task<Void, Never>?
+
+    /// Renders the pages delivered by `pages` into `url`; `pageCount` is only used for progress
+    func export(_ pages: ExtractedPageQueue, pageCount: Int, voice: AVSpeechSynthesisVoice?, rate: Float, to url: URL) {
+        cancel()
+
+        isExporting = true
+        progress = 0.0
+        errorMessage = nil
+        statusMessage = "Preparing export..."
+
+        exportTask = Task { [weak self] in
+            do {
+                let result = try await Self.renderDocument(pages, voice: voice, rate: rate, to: url) { pageNumber in
+                    await self?.beginPage(pageNumber, of: pageCount)
+                }
+                Log.export.info("Exported \(result.duration) s of audio to \(url.path, privacy: .private)")
+                self?.progress = 1.0
+                self?.statusMessage = "Exported \(url.lastPathComponent)"
+            } catch {
+                if error is CancellationError {
+                    self?.statusMessage = "Export cancelled"
+                } else {
+                    Log.export.error("Audio export failed: \(error.localizedDescription, privacy: .public)")
+                    self?.errorMessage = "Export failed: \(error.localizedDescription)"
+                    self?.statusMessage = ""
+                }
+            }
+            self?.isExporting = false
+            self?.exportTask = nil
+        }
+    }
+
+    func cancel() {
+        exportTask?.cancel()
+        exportTask = nil
+    }
+
+    private func beginPage(_ pageNumber: Int, of pageCount: Int) {
+        statusMessage = "Rendering page \(pageNumber) of \(pageCount)"
+        progress = pageCount > 0 ? min(1.0, Double(pageNumber - 1) / Double(pageCount)) : 0.0
+    }
+
+    /// Renders every page delivered by `pages` into `url` plus its chapter sidecar, calling
+    /// `onPage` before each page. Throws `CancellationError` if the calling task is cancelled, in
+    /// which case nothing is left on disk. Also used by the command-line converter.
+    nonisolated static func renderDocument(_ pages: ExtractedPageQueue, voice: AVSpeechSynthesisVoice?, rate: Float, to url: URL, onPage: @Sendable (Int) async -> Void = { _ in }) async throws -> AudioExportResult {
+        let synthesizer = AVSpeechSynthesizer()
+        let sink = AudioExportSink(url: url)
+        var renderedPages = 0
+        do {
+            while let page = await pages.next() {
+                try Task.checkCancellation()
+                await onPage(page.pageNumber)
+
+                let text = TextNormalizer.shared.normalize(page.text, options: .speechSafe)
+                guard !text.isEmpty else { continue }
+
+                let interval = Signpost.export.beginInterval("Render page", id: Signpost.export.makeSignpostID(), "page \(page.pageNumber)")
+                defer { Signpost.export.endInterval("Render page", interval) }
+                sink.beginChapter("Page \(page.pageNumber)")
+                let startDate = Date()
+                let startDuration = sink.duration
+                try await render(text, voice: voice, rate: rate, with: synthesizer, into: sink)
+                PipelineMetrics.shared.recordSynthesis(of: sink.duration - startDuration, in: Date().timeIntervalSince(startDate), by: .system)
+                renderedPages += 1
+            }
+            try Task.checkCancellation()
+
+            try sink.finish()
+            return AudioExportResult(pageCount: renderedPages, duration: sink.duration)
+        } catch {
+            pages.cancel()
+            sink.discard()
+            throw error
+        }
+    }
+
+    /// Synthesizes `text` into `sink`, returning once the synthesizer has delivered its last buffer
+    nonisolated private static func render(_ text: String, voice: AVSpeechSynthesisVoice?, rate: Float, with synthesizer: AVSpeechSynthesizer, into sink: AudioExportSink) async throws {
+        let utterance = AVSpeechUtterance(string: text)
+        utterance.voice = voice
+        utterance.rate = rate
+
+        let completion = RenderCompletion()
+        try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { (continuation: CheckedContinuation<Void, Error>) in
+                completion.set(continuation)
+                synthesizer.write(utterance) { buffer in
+                    guard let pcmBuffer = buffer as? AVAudioPCMBuffer else { return }
+                    // An empty buffer marks the end of the utterance
+                    guard pcmBuffer.frameLength > 0 else {
+                        completion.resume(with: .success(()))
+                        return
+                    }
+                    do {
+                        try sink.write(pcmBuffer)
+                    } catch {
+                        synthesizer.stopSpeaking(at: .immediate)
+                        completion.resume(with: .failure(error))
+                    }
+                }
+            }
+        } onCancel: {
+            synthesizer.stopSpeaking(at: .immediate)
+            completion.resume(with: .failure(CancellationError()))
+        }
+    }
+}
+
+/// Resumes a continuation once, whichever of the buffer callback or cancellation gets there first
+private final class RenderCompletion: @unchecked Sendable {
+    private let lock = NSLock()
+    private var continuation: CheckedContinuation<Void, Error>?
+    private var pendingResult: Result<Void, Error>?
+    private var isResumed = false
+
+    func set(_ continuation: CheckedContinuation<Void, Error>) {
+        lock.lock()
+        if let result = pendingResult {
+            isResumed = true
+            lock.unlock()
+            continuation.resume(with: result)
+            return
+        }
+        self.continuation = continuation
+        lock.unlock()
+    }
+
+    func resume(with result: Result<Void, Error>) {
+        lock.lock()
+        guard !isResumed else {
+            lock.unlock()
+            return
+        }
+        guard let continuation = continuation else {
+            pendingResult = pendingResult ?? result // Cancelled before the render started
+            lock.unlock()
+            return
+        }
+        isResumed = true
+        self.continuation = nil
+        lock.unlock()
+        continuation.resume(with: result)
+    }
+}
+
+/// The AAC file being exported plus its chapter list. Only used by one render at a time.
+private final class AudioExportSink: @unchecked Sendable {
+    static let encoderBitRate = 64_000
+
+    let url: URL
+    private var file: AVAudioFile?
+    private var sampleRate: Double = 0
+    private var framesWritten: AVAudioFramePosition = 0
+    private var chapters: [(title: String, start: TimeInterval)] = []
+
+    init(url: URL) {
+        self.url = url
+    }
+
+    var duration: TimeInterval {
+        return sampleRate > 0 ? Double(framesWritten) / sampleRate : 0
+    }
+
+    var chaptersURL: URL {
+        return url.deletingPathExtension().appendingPathExtension("chapters.txt")
+    }
+
+    func beginChapter(_ title: String) {
+        chapters.append((title, duration))
+    }
+
+    func write(_ buffer: AVAudioPCMBuffer) throws {
+        if file == nil {
+            // The encoder takes the synthesizer's own format, so buffers are written without conversion
+            let format = buffer.format
+            let settings: [String: Any] = [
+                AVFormatIDKey: kAudioFormatMPEG4AAC,
+                AVSampleRateKey: format.sampleRate,
+                AVNumberOfChannelsKey: format.channelCount,
+                AVEncoderBitRateKey: Self.encoderBitRate
+            ]
+            try? FileManager.default.removeItem(at: url)
+            file = try AVAudioFile(forWriting: url, settings: settings, commonFormat: format.commonFormat, interleaved: format.isInterleaved)
+            sampleRate = format.sampleRate
+        }
+        try file?.write(from: buffer)
+        framesWritten += AVAudioFramePosition(buffer.frameLength)
+    }
+
+    func finish() throws {
+        file = nil // Releasing the file flushes the encoder and closes it
+
+        let lines = chapters.map { chapter -> String in
+            let milliseconds = Int((chapter.start * 1000).rounded())
+            return String(format: "%02d:%02d:%02d.%03d %@", milliseconds / 3_600_000, milliseconds / 60_000 % 60, milliseconds / 1000 % 60, milliseconds % 1000, chapter.title)
+        }
+        try (lines.joined(separator: "\n") + "\n").write(to: chaptersURL, atomically: true, encoding: .utf8)
+    }
+
+    func discard() {
+        file = nil
+        try? FileManager.default.removeItem(at: url)
+        try? FileManager.default.removeItem(at: chaptersURL)
+    }
+}
@@ -0,0 +1,158 @@
+//
+//  AudioRenderCache.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import AVFoundation
+import CryptoKit
+import os
+
+/// Identifies one synthesized segment by its normalized text, model and voice. The playback rate is
+/// applied by the player at play time, so the same audio serves every speed and is not in the key.
+struct AudioRenderKey: Hashable {
+    let digest: String
+
+    init(text: String, model: String, voice: String?) {
+        var hasher = SHA256()
+        for part in [model, voice ?? "", text] {
+            hasher.update(data: Data(part.utf8))
+            hasher.update(data: Data([0]))
+        }
+        digest = hasher.finalize().map { String(format: "%02x", $0) }.joined()
+    }
+}
+
+/// Content-addressed store of synthesized speech, compressed as AAC in `.m4a` files.
+///
+/// Files are named after their key, so a segment is synthesized once however often it is played,
+/// across sessions. Writes go to a temporary file that is only moved into place once the segment is
+/// complete, and the least recently played files are removed when the cache grows past `maxSize`.
+final class AudioRenderCache {
+    static let shared = AudioRenderCache()
+
+    static let maxSize: Int64 = 1 << 30 // 1 GB
+    static let readBufferDuration: TimeInterval = 0.5
+    static let encoderBitRate = 48_000
+
+    let directory: URL
+    private let lock = NSLock()
+
+    init(directory: URL? = nil) {
+        let baseDirectory = directory ?? FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent("Opra", isDirectory: true)
+            .appendingPathComponent("AudioCache", isDirectory: true)
+        self.directory = baseDirectory
+
+        try? FileManager.default.createDirectory(at: baseDirectory, withIntermediateDirectories: true)
+    }
+
+    func fileURL(for key: AudioRenderKey) -> URL {
+        return directory.appendingPathComponent("\(key.digest).m4a")
+    }
+
+    func contains(_ key: AudioRenderKey) -> Bool {
+        return FileManager.default.fileExists(atPath: fileURL(for: key).path)
+    }
+
+    /// Decodes a cached segment into `onBuffer`, a few hundred milliseconds at a time.
+    /// Returns false without calling `onBuffer` if the segment is not cached.
+    func readBuffers(for key: AudioRenderKey, onBuffer: (AVAudioPCMBuffer) async throws -> Void) async throws -> Bool {
+        let url = fileURL(for: key)
+        guard let file = try? AVAudioFile(forReading: url) else { return false }
+
+        // Playing a segment counts as using it when evicting
+        try? FileManager.default.setAttributes([.modificationDate: Date()], ofItemAtPath: url.path)
+
+        let format = file.processingFormat
+        let capacity = AVAudioFrameCount(format.sampleRate * Self.readBufferDuration)
+        while file.framePosition < file.length {
+            guard let buffer = AVAudioPCMBuffer(pcmFormat: format, frameCapacity: capacity) else { break }
+            try file.read(into: buffer)
+            guard buffer.frameLength > 0 else { break }
+            try await onBuffer(buffer)
+        }
+        return true
+    }
+
+    /// Starts recording a segment whose audio arrives in buffers of `format`
+    func makeWriter(for key: AudioRenderKey, format: AVAudioFormat) throws -> Writer {
+        let settings: [String: Any] = [
+            AVFormatIDKey: kAudioFormatMPEG4AAC,
+            AVSampleRateKey: format.sampleRate,
+            AVNumberOfChannelsKey: format.channelCount,
+            AVEncoderBitRateKey: Self.encoderBitRate
+        ]
+        let temporaryURL = directory.appendingPathComponent("\(key.digest)-\(UUID().uuidString).partial.m4a")
+        let file = try AVAudioFile(forWriting: temporaryURL, settings: settings, commonFormat: format.commonFormat, interleaved: format.isInterleaved)
+        return Writer(file: file, temporaryURL: temporaryURL, destinationURL: fileURL(for: key), cache: self)
+    }
+
+    final class Writer {
+        private var file: AVAudioFile?
+        private let temporaryURL: URL
+        private let destinationURL: URL
+        private let cache: AudioRenderCache
+
+        fileprivate init(file: AVAudioFile, temporaryURL: URL, destinationURL: URL, cache: AudioRenderCache) {
+            self.file = file
+            self.temporaryURL = temporaryURL
+            self.destinationURL = destinationURL
+            self.cache = cache
+        }
+
+        func write(_ buffer: AVAudioPCMBuffer) throws {
+            try file?.write(from: buffer)
+        }
+
+        /// Finishes the file and makes it visible under its key
+        func commit() throws {
+            guard file != nil else { return }
+            file = nil // Releasing the file flushes and closes it
+
+            if FileManager.default.fileExists(atPath: destinationURL.path) {
+                // Rendered by someone else in the meantime
+                try? FileManager.default.removeItem(at: temporaryURL)
+            } else {
+                try FileManager.default.moveItem(at: temporaryURL, to: destinationURL)
+            }
+            cache.prune()
+        }
+
+        func discard() {
+            file = nil
+            try? FileManager.default.removeItem(at: temporaryURL)
+        }
+    }
+
+    /// Removes the least recently played segments until the cache fits in `maxSize`
+    private func prune() {
+        lock.lock()
+        defer { lock.unlock() }
+
+        let resourceKeys: [URLResourceKey] = [.fileSizeKey, .contentModificationDateKey]
+        guard let files = try? FileManager.default.contentsOfDirectory(at: directory, includingPropertiesForKeys: resourceKeys) else {
+            return
+        }
+
+        var entries: [(url: URL, size: Int64, date: Date)] = files.compactMap { url in
+            guard url.pathExtension == "m4a", !url.lastPathComponent.contains(".partial"),
+                  let values = try? url.resourceValues(forKeys: Set(resourceKeys)) else {
+                return nil
+            }
+            return (url, Int64(values.fileSize ?? 0), values.contentModificationDate ?? .distantPast)
+        }
+
+        var totalSize = entries.reduce(0) { $0 + $1.size }
+        guard totalSize > Self.maxSize else { return }
+
+        entries.sort { $0.date < $1.date }
+        for entry in entries where totalSize > Self.maxSize {
+            try? FileManager.default.removeItem(at: entry.url)
+            totalSize -= entry.size
+        }
+        Log.cache.info("Pruned audio cache to \(totalSize / (1 << 20)) MB")
+    }
+}
@@ -0,0 +1,181 @@
+//
+//  AudioRenderScheduler.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import AVFoundation
+import os
+
+/// Synthesizes upcoming segments into the audio cache while the current one plays.
+///
+/// Segments are rendered one request at a time, so render-ahead never competes with itself for the
+/// speech server. When the server supports it, consecutive segments that together stay under
+/// `maxBatchCharacters` share one request. Playback calls `waitForRender(of:)` before it needs a
+/// segment: a render that is already under way is finished rather than started over, and one that
+/// has not started yet is dropped so playback can stream it directly.
+///
+/// Idle segments, such as the opening of the next document in the reading queue, are rendered
+/// only while render-ahead has nothing to do, and a render-ahead request preempts them.
+@MainActor
+final class AudioRenderScheduler {
+    struct Segment {
+        let key: AudioRenderKey
+        let text: String
+    }
+
+    static let maxBatchCharacters = 4000
+
+    private let cache: AudioRenderCache
+    private var client: SpeechStreamClient?
+    private var pending: [Segment] = []
+    private var idle: [(segment: Segment, client: SpeechStreamClient)] = []
+    private var current: (keys: Set<AudioRenderKey>, idleWork: (segment: Segment, client: SpeechStreamClient)?, task: Task<Void, Never>)?
+
+    init(cache: AudioRenderCache = .shared) {
+        self.cache = cache
+    }
+
+    /// Replaces the segments waiting to be rendered. Segments that are already cached are skipped.
+    func prefetch(_ segments: [Segment], using client: SpeechStreamClient) {
+        self.client = client
+        pending = segments.filter { !cache.contains($0.key) && !(current?.keys.contains($0.key) ?? false) }
+        if !pending.isEmpty, let current = current, let work = current.idleWork {
+            // Started over once render-ahead is done
+            current.task.cancel()
+            self.current = nil
+            idle.insert(work, at: 0)
+        }
+        startNextIfIdle()
+    }
+
+    /// Adds segments to render once render-ahead has nothing left to do, each with the client it
+    /// is for. Segments that are already cached or waiting are skipped.
+    func prefetchWhenIdle(_ segments: [Segment], using client: SpeechStreamClient) {
+        for segment in segments where !cache.contains(segment.key) && !idle.contains(where: { $0.segment.key == segment.key }) {
+            idle.append((segment, client))
+        }
+        startNextIfIdle()
+    }
+
+    func waitForRender(of key: AudioRenderKey) async {
+        pending.removeAll { $0.key == key }
+        idle.removeAll { $0.segment.key == key }
+        if let current = current, current.keys.contains(key) {
+            await current.task.value
+        }
+    }
+
+    /// Cancels render-ahead. Idle segments are kept, including one that was being rendered, and
+    /// carry on with `resumeIdleRenders()`.
+    func cancelAll() {
+        pending.removeAll()
+        if let work = current?.idleWork {
+            idle.insert(work, at: 0)
+        }
+        current?.task.cancel()
+        current = nil
+    }
+
+    func resumeIdleRenders() {
+        startNextIfIdle()
+    }
+
+    private func startNextIfIdle() {
+        guard current == nil else { return }
+        if let client = client, !pending.isEmpty {
+            startRenderAhead(using: client)
+        } else if !idle.isEmpty {
+            let work = idle.removeFirst()
+            guard !cache.contains(work.segment.key) else {
+                startNextIfIdle()
+                return
+            }
+            start([work.segment], client: work.client, idleWork: work)
+        }
+    }
+
+    private func startRenderAhead(using client: SpeechStreamClient) {
+        var batch = [pending.removeFirst()]
+        if client.supportsBatching {
+            var characters = batch[0].text.count
+            while let next = pending.first, characters + next.text.count <= Self.maxBatchCharacters {
+                batch.append(pending.removeFirst())
+                characters += next.text.count
+            }
+        }
+        start(batch, client: client, idleWork: nil)
+    }
+
+    private func start(_ batch: [Segment], client: SpeechStreamClient, idleWork: (segment: Segment, client: SpeechStreamClient)?) {
+        let cache = self.cache
+        let task = Task(priority: idleWork == nil ? nil : .utility) { [weak self] in
+            do {
+                if batch.count == 1 {
+                    try await Self.render(batch[0], client: client, cache: cache)
+                } else {
+                    try await Self.renderBatch(batch, client: client, cache: cache)
+                }
+                Log.speech.debug("Rendered \(idleWork == nil ? "ahead" : "while idle", privacy: .public): \(batch.count) segment(s)")
+            } catch {
+                if !Task.isCancelled {
+                    Log.speech.error("Render-ahead failed: \(error.localizedDescription, privacy: .public)")
+                }
+            }
+
+            guard let self = self, !Task.isCancelled else { return }
+            self.current = nil
+            self.startNextIfIdle()
+        }
+        current = (Set(batch.map(\.key)), idleWork, task)
+    }
+
+    nonisolated private static func render(_ segment: Segment, client: SpeechStreamClient, cache: AudioRenderCache) async throws {
+        var writer: AudioRenderCache.Writer?
+        let startDate = Date()
+        var audio: TimeInterval = 0
+        do {
+            try await client.synthesize(segment.text) { buffer in
+                try Task.checkCancellation()
+                if writer == nil {
+                    writer = try cache.makeWriter(for: segment.key, format: buffer.format)
+                }
+                try writer?.write(buffer)
+                audio += buffer.duration
+            }
+            try writer?.commit()
+            PipelineMetrics.shared.recordSynthesis(of: audio, in: Date().timeIntervalSince(startDate), by: .ollama)
+        } catch {
+            writer?.discard()
+            throw error
+        }
+    }
+
+    nonisolated private static func renderBatch(_ segments: [Segment], client: SpeechStreamClient, cache: AudioRenderCache) async throws {
+        var writers: [Int: AudioRenderCache.Writer] = [:]
+        let startDate = Date()
+        var audio: TimeInterval = 0
+        do {
+            try await client.synthesizeBatch(segments.map(\.text)) { index, buffer in
+                try Task.checkCancellation()
+                guard segments.indices.contains(index) else { throw SpeechStreamError.invalidFrame }
+                if writers[index] == nil {
+                    writers[index] = try cache.makeWriter(for: segments[index].key, format: buffer.format)
+                }
+                try writers[index]?.write(buffer)
+                audio += buffer.duration
+            }
+            for writer in writers.values {
+                try writer.commit()
+            }
+            PipelineMetrics.shared.recordSynthesis(of: audio, in: Date().timeIntervalSince(startDate), by: .ollama)
+        } catch {
+            for writer in writers.values {
+                writer.discard()
+            }
+            throw error
+        }
+    }
+}
@@ -6,12 +6,16 @@
 //
 
 import SwiftUI
+import os
 
 struct ContentView: View {
     @StateObject private var pdfExtractor = PDFTextExtractor()
     @StateObject private var ttsProviderManager = TTSProviderManager()
     @StateObject private var settingsManager = SettingsManager()
+    @StateObject private var readingQueue = ReadingQueue()
+    @StateObject private var documentSearch = DocumentSearch()
     @State private var showingFilePicker = false
+    @State private var filePickerAppendsToQueue = false
     @State private var selectedFileURL: URL?
     @State private var showingVoicePicker = false
     @State private var showingSettings = false
@@ -33,6 +37,7 @@ struct ContentView: View {
             // Top Navigation Bar
             HStack {
                 Button("Select PDF") {
+                    filePickerAppendsToQueue = false
                     showingFilePicker = true
                 }
                 .buttonStyle(.borderedProminent)
@@ -47,6 +52,16 @@ struct ContentView: View {
                             .lineLimit(1)
                     }
                     
+                    ReadingQueueView(
+                        queue: readingQueue,
+                        onSelect: { openQueued(readingQueue.select($0)) },
+                        onNext: { openQueued(readingQueue.advance()) },
+                        onAdd: {
+                            filePickerAppendsToQueue = true
+                            showingFilePicker = true
+                        }
+                    )
+                    
                     Spacer()
                     
                     Text("Pages: \(pdfExtractor.totalPages) total")
@@ -62,6 +77,12 @@ struct ContentView: View {
                         showingTextPanel.toggle()
                     }
                     .buttonStyle(.bordered)
+                    
+                    Button("Export Audio") {
+                        exportAudio()
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(ttsProviderManager.isExporting)
                 } else {
                     Text("PDF Reader")
                         .font(.headline)
@@ -76,8 +97,9 @@ struct ContentView: View {
                 .buttonStyle(.bordered)
                 .keyboardShortcut(",", modifiers: .command)
                 
-                if ttsProviderManager.currentProvider == .ollama && !ttsProviderManager.ollamaTTSManager.isAvailable {
+                if ttsProviderManager.currentProvider == .ollama && ttsProviderManager.ollamaTTSManager?.isAvailable != true {
                     Button("Setup Ollama") {
+                        ttsProviderManager.ensureOllamaManager()
                         showingOllamaSetup = true
                     }
                     .buttonStyle(.bordered)
@@ -88,6 +110,35 @@ struct ContentView: View {
             .padding(.vertical, 12)
             .background(Color(NSColor.controlBackgroundColor).opacity(0.5))
             
+            // Offline audio export progress
+            if ttsProviderManager.isExporting || ttsProviderManager.audioExporter.errorMessage != nil {
+                HStack(spacing: 12) {
+                    if ttsProviderManager.isExporting {
+                        ProgressView(value: ttsProviderManager.audioExporter.progress)
+                            .frame(maxWidth: 300)
+                        
+                        Text(ttsProviderManager.audioExporter.statusMessage)
+                            .font(.caption)
+                            .foregroundColor(.secondary)
+                    } else if let error = ttsProviderManager.audioExporter.errorMessage {
+                        Text(error)
+                            .font(.caption)
+                            .foregroundColor(.orange)
+                    }
+                    
+                    Spacer()
+                    
+                    if ttsProviderManager.isExporting {
+                        Button("Cancel") {
+                            ttsProviderManager.cancelExport()
+                        }
+                        .buttonStyle(.bordered)
+                    }
+                }
+                .padding(.horizontal, 20)
+                .padding(.vertical, 8)
+            }
+            
             // Page Selection Controls (collapsible)
             if showingPageControls && pdfExtractor.isReadyToRead {
                 VStack(spacing: 12) {
@@ -168,7 +219,7 @@ struct ContentView: View {
                                 .foregroundColor(.secondary)
                             
                             if !pdfExtractor.extractedText.isEmpty {
-                                let wordCount = pdfExtractor.extractedText.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }.count
+                                let wordCount = pdfExtractor.wordCount
                                 if pdfExtractor.isChunked {
                                     Text("\(wordCount) words in chunk \(pdfExtractor.currentChunk + 1) of \(pdfExtractor.totalChunks)")
                                         .font(.caption)
@@ -198,16 +249,8 @@ struct ContentView: View {
                                 ttsProviderManager.stopSpeaking()
                             }
 
-                            // Ensure text is ready before starting TTS
-                            if !pdfExtractor.isReadyForTTS() {
-                                pdfExtractor.startReading()
-                                // After preparing text, start audio as soon as possible
-                                DispatchQueue.main.asyncAfter(deadline: .now() + 0.5) {
-                                    self.startTTSIfReady()
-                                }
-                            } else {
-                                startTTSIfReady()
-                            }
+                            // Streams pages to TTS if the text is not ready yet
+                            startTTSIfReady()
                         }
                         .buttonStyle(.borderedProminent)
                         .disabled(!pdfExtractor.isReadyToRead)
@@ -223,7 +266,13 @@ struct ContentView: View {
                 HStack(spacing: 0) {
                     // PDF Viewer
                     if let pdfDocument = pdfExtractor.pdfDocumentForViewing {
-                        PDFViewerView(pdfDocument: pdfDocument, currentPage: $pdfExtractor.currentPage, ttsProviderManager: ttsProviderManager)
+                        PDFViewerView(
+                            pdfDocument: pdfDocument,
+                            currentPage: $pdfExtractor.currentPage,
+                            ttsProviderManager: ttsProviderManager,
+                            search: documentSearch,
+                            onSpeakFromHere: speak(from:)
+                        )
                             .frame(maxWidth: .infinity, maxHeight: .infinity)
                     }
                     
@@ -252,17 +301,14 @@ struct ContentView: View {
                                                 .font(.caption)
                                                 .foregroundColor(.secondary)
                                             
-                                            let wordCount = pdfExtractor.extractedText.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }.count
+                                            let wordCount = pdfExtractor.wordCount
                                             Text("\(wordCount) words")
                                                 .font(.caption2)
                                                 .foregroundColor(.orange)
                                             
                                             // Show current word being read (if follow text is enabled)
-                                            if settingsManager.enableFollowText && ttsProviderManager.isSpeaking && !pdfExtractor.highlightedWord.isEmpty {
-                                                Text("Reading: \"\(pdfExtractor.highlightedWord)\"")
-                                                    .font(.caption2)
-                                                    .foregroundColor(.blue)
-                                                    .fontWeight(.medium)
+                                            if settingsManager.enableFollowText && ttsProviderManager.isSpeaking {
+                                                SpokenWordCaption(text: pdfExtractor.extractedText, spokenWord: pdfExtractor.spokenWord)
                                             }
                                         }
                                         
@@ -277,18 +323,15 @@ struct ContentView: View {
                                 } else {
                                     // Word count display for non-chunked text
                                     if !pdfExtractor.extractedText.isEmpty {
-                                        let wordCount = pdfExtractor.extractedText.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }.count
+                                        let wordCount = pdfExtractor.wordCount
                                         VStack(spacing: 2) {
                                             Text("\(wordCount) words ready for TTS")
                                                 .font(.caption)
                                                 .foregroundColor(.green)
                                             
                                             // Show current word being read (if follow text is enabled)
-                                            if settingsManager.enableFollowText && ttsProviderManager.isSpeaking && !pdfExtractor.highlightedWord.isEmpty {
-                                                Text("Reading: \"\(pdfExtractor.highlightedWord)\"")
-                                                    .font(.caption2)
-                                                    .foregroundColor(.blue)
-                                                    .fontWeight(.medium)
+                                            if settingsManager.enableFollowText && ttsProviderManager.isSpeaking {
+                                                SpokenWordCaption(text: pdfExtractor.extractedText, spokenWord: pdfExtractor.spokenWord)
                                             }
                                         }
                                         .padding(.horizontal, 12)
@@ -299,22 +342,12 @@ struct ContentView: View {
                             
                             Divider()
                             
-                            ScrollView {
-                                if settingsManager.enableFollowText && ttsProviderManager.isSpeaking && !pdfExtractor.highlightedWord.isEmpty {
-                                    // Show highlighted text when speaking
-                                    Text(pdfExtractor.getHighlightedText())
-                                        .textSelection(.enabled)
-                                        .frame(maxWidth: .infinity, alignment: .leading)
-                                        .padding()
-                                } else {
-                                    // Show normal text when not speaking
-                                    Text(pdfExtractor.extractedText)
-                                        .font(.system(.body, design: .monospaced))
-                                        .textSelection(.enabled)
-                                        .frame(maxWidth: .infinity, alignment: .leading)
-                                        .padding()
-                                }
-                            }
+                            // Long chunks are laid out lazily; only the spoken word's highlight changes while speaking
+                            SpokenTextView(
+                                text: pdfExtractor.extractedText,
+                                spokenWord: pdfExtractor.spokenWord,
+                                isFollowing: settingsManager.enableFollowText && ttsProviderManager.isSpeaking
+                            )
                             .frame(maxWidth: .infinity, maxHeight: .infinity)
                         }
                         .frame(width: 400)
@@ -388,6 +421,10 @@ struct ContentView: View {
                 VStack(spacing: 0) {
                     Divider()
                     
+                    if settingsManager.showDiagnostics {
+                        DiagnosticsPanelView(diagnostics: ttsProviderManager.diagnostics)
+                    }
+                    
                     HStack(spacing: 20) {
                         // Play/Pause Button
                         Button(action: {
@@ -452,6 +489,7 @@ struct ContentView: View {
                             if ttsProviderManager.currentProvider == .system {
                                 showingVoicePicker = true
                             } else {
+                                ttsProviderManager.ensureOllamaManager()
                                 showingOllamaSetup = true
                             }
                         }) {
@@ -488,29 +526,8 @@ struct ContentView: View {
                                     .foregroundColor(.secondary)
                             }
                         } else if ttsProviderManager.isSpeaking {
-                            VStack(spacing: 4) {
-                                ProgressView(value: ttsProviderManager.readingProgress)
-                                    .progressViewStyle(LinearProgressViewStyle())
-                                    .frame(width: 150)
-                                
-                                HStack(spacing: 8) {
-                                    if settingsManager.enableFollowText {
-                                        Text("\(Int(ttsProviderManager.readingProgress * 100))% - Word \(ttsProviderManager.currentWordIndex) of \(ttsProviderManager.totalWords)")
-                                            .font(.caption2)
-                                            .foregroundColor(.secondary)
-                                    } else {
-                                        Text("\(Int(ttsProviderManager.readingProgress * 100))%")
-                                            .font(.caption2)
-                                            .foregroundColor(.secondary)
-                                    }
-                                    
-                                    // Timer display
-                                    Text(formatTime(ttsProviderManager.elapsedTime))
-                                        .font(.caption2)
-                                        .foregroundColor(.blue)
-                                        .fontWeight(.medium)
-                                }
-                            }
+                            // Observes the provider's telemetry itself, so progress ticks only redraw it
+                            PlaybackProgressView(telemetry: ttsProviderManager.playbackTelemetry, showsWordPosition: settingsManager.enableFollowText)
                         }
                     }
                     .padding(.horizontal, 20)
@@ -522,17 +539,17 @@ struct ContentView: View {
         .fileImporter(
             isPresented: $showingFilePicker,
             allowedContentTypes: [.pdf],
-            allowsMultipleSelection: false
+            allowsMultipleSelection: true
         ) { result in
             switch result {
             case .success(let urls):
-                if let url = urls.first {
-                    let isAccessing = url.startAccessingSecurityScopedResource()
-                    if !isAccessing {
-                        pdfExtractor.errorMessage = "Could not access the selected file. Please try again."
-                        return
-                    }
-                    
+                // The queue holds the files' access for as long as they may be read
+                let appends = filePickerAppendsToQueue && selectedFileURL != nil
+                let accessibleURLs = appends ? readingQueue.append(urls) : readingQueue.replace(with: urls)
+                if accessibleURLs.count < urls.count {
+                    pdfExtractor.errorMessage = "Could not access the selected file. Please try again."
+                }
+                if !appends, let url = accessibleURLs.first {
                     selectedFileURL = url
                     pdfExtractor.extractText(from: url)
                 }
@@ -549,14 +566,35 @@ struct ContentView: View {
                 .frame(maxWidth: 800, maxHeight: 700)
         }
         .sheet(isPresented: $showingOllamaSetup) {
-            OllamaSetupView(ollamaTTSManager: ttsProviderManager.ollamaTTSManager)
-                .frame(minWidth: 600, minHeight: 500)
-                .frame(maxWidth: 800, maxHeight: 700)
+            if let ollamaTTSManager = ttsProviderManager.ollamaTTSManager {
+                OllamaSetupView(ollamaTTSManager: ollamaTTSManager)
+                    .frame(minWidth: 600, minHeight: 500)
+                    .frame(maxWidth: 800, maxHeight: 700)
+            }
         }
         .onAppear {
             ttsProviderManager.systemTTSManager.setSettingsManager(settingsManager)
-            ttsProviderManager.systemTTSManager.setPDFExtractor(pdfExtractor)
+            ttsProviderManager.setPDFExtractor(pdfExtractor)
             pdfExtractor.setSettingsManager(settingsManager)
+            readingQueue.setSettingsManager(settingsManager)
+            readingQueue.onPrepared = { [ttsProviderManager] document in
+                ttsProviderManager.prepareOpening(of: document)
+            }
+            ttsProviderManager.setDiagnosticsEnabled(settingsManager.showDiagnostics)
+        }
+        .onReceive(pdfExtractor.$searchIndex) { index in
+            documentSearch.setIndex(index) { [pdfExtractor] page in
+                pdfExtractor.pageText(page)
+            }
+        }
+        .onChange(of: settingsManager.enableLayoutExtraction) { _, _ in
+            // Layout-aware text lives in its own cache file, so switching back is instant
+            guard let fileURL = selectedFileURL else { return }
+            ttsProviderManager.stopSpeaking()
+            pdfExtractor.extractText(from: fileURL)
+        }
+        .onChange(of: settingsManager.showDiagnostics) { _, enabled in
+            ttsProviderManager.setDiagnosticsEnabled(enabled)
         }
         .onReceive(NotificationCenter.default.publisher(for: NSApplication.willTerminateNotification)) { _ in
             ttsProviderManager.stopSpeaking()
@@ -564,48 +602,73 @@ struct ContentView: View {
     }
     
     private func startTTSIfReady() {
-        print("=== START TTS IF READY ===")
-        print("isReadyToRead: \(pdfExtractor.isReadyToRead)")
-        print("extractedText.isEmpty: \(pdfExtractor.extractedText.isEmpty)")
-        print("isProcessing: \(pdfExtractor.isProcessing)")
-        print("isReadyForTTS: \(pdfExtractor.isReadyForTTS())")
-        print("isChunked: \(pdfExtractor.isChunked)")
-        print("totalChunks: \(pdfExtractor.totalChunks)")
-        print("currentChunk: \(pdfExtractor.currentChunk)")
-        print("chunkedTextsArray.count: \(pdfExtractor.chunkedTextsArray.count)")
+        // Pick up exactly where reading stopped, in this session or the last one
+        if let position = pdfExtractor.takeResumePosition(), ttsProviderManager.seek(to: position) {
+            Log.speech.debug("Resuming at \(String(describing: position), privacy: .public)")
+            return
+        }
         
-        guard pdfExtractor.isReadyForTTS() else {
-            print("Text not ready for TTS yet - waiting...")
-            // Wait a bit more and try again
-            DispatchQueue.main.asyncAfter(deadline: .now() + 1.0) {
-                self.startTTSIfReady()
-            }
+        // A windowed document only has the text around the reading position, so it always streams
+        guard pdfExtractor.isReadyForTTS() && !pdfExtractor.isWindowed else {
+            guard pdfExtractor.isReadyToRead else { return }
+            // Speak pages as they are extracted instead of waiting for the whole range
+            ttsProviderManager.speakPageStream(pdfExtractor.streamPages())
             return
         }
         
-        print("Start Reading - isChunked: \(pdfExtractor.isChunked), totalChunks: \(pdfExtractor.totalChunks)")
         if pdfExtractor.isChunked {
-            print("Using speakChunkedText with \(pdfExtractor.chunkedTextsArray.count) chunks")
             ttsProviderManager.speakChunkedText(pdfExtractor.chunkedTextsArray, startChunk: pdfExtractor.currentChunk)
         } else {
-            print("Using regular speak method")
             ttsProviderManager.speak(pdfExtractor.getCurrentChunkText())
         }
-        print("=== END START TTS IF READY ===")
+    }
+    
+    /// Reads on from a search hit. A hit before or after the selection widens it to run from the
+    /// hit's page to the end of the document.
+    private func speak(from hit: SearchIndex.Hit) {
+        if !(pdfExtractor.startPage...pdfExtractor.endPage).contains(hit.page) {
+            pdfExtractor.setPageRange(start: hit.page, end: pdfExtractor.totalPages)
+        }
+        if !ttsProviderManager.seek(to: .page(hit.page, word: hit.word)) {
+            Log.speech.notice("Could not read from the search hit on page \(hit.page)")
+        }
+    }
+    
+    /// Opens a document from the reading queue, the prepared one when it is ready
+    private func openQueued(_ entry: (url: URL, document: PreparedDocument?)?) {
+        guard let entry = entry else { return }
+        ttsProviderManager.stopSpeaking()
+        selectedFileURL = entry.url
+        if let document = entry.document {
+            pdfExtractor.open(document)
+        } else {
+            pdfExtractor.extractText(from: entry.url)
+        }
+    }
+    
+    private func exportAudio() {
+        // A folder rather than a file, so the chapter list can be written next to the audio
+        let panel = NSOpenPanel()
+        panel.canChooseDirectories = true
+        panel.canChooseFiles = false
+        panel.canCreateDirectories = true
+        panel.prompt = "Export"
+        panel.message = "Choose a folder for the audiobook and its chapter list"
+        guard panel.runModal() == .OK, let folderURL = panel.url else { return }
+        
+        let name = selectedFileURL?.deletingPathExtension().lastPathComponent ?? "Opra"
+        let url = folderURL.appendingPathComponent(name).appendingPathExtension("m4a")
+        ttsProviderManager.exportAudio(pdfExtractor.streamDocumentPages(), pageCount: pdfExtractor.totalPages, to: url)
     }
     
     private func clearAll() {
         ttsProviderManager.stopSpeaking()
         pdfExtractor.clearText()
+        readingQueue.clear()
+        documentSearch.clear()
         selectedFileURL = nil
         showingPageControls = false
     }
-    
-    private func formatTime(_ timeInterval: TimeInterval) -> String {
-        let minutes = Int(timeInterval) / 60
-        let seconds = Int(timeInterval) % 60
-        return String(format: "%02d:%02d", minutes, seconds)
-    }
 }
 
 #Preview {
@@ -0,0 +1,100 @@
+//
+//  DocumentSearch.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+
+/// Phrase search over the open document, for the search field in the PDF viewer.
+///
+/// Every change of the query searches the document's `SearchIndex` off the main thread and
+/// replaces the results, dropping a search that is still running. Results carry a short snippet
+/// of the page around the hit and the UTF-16 range of the hit in the page's text, which is also
+/// the range PDFKit selects on pages with a text layer.
+@MainActor
+final class DocumentSearch: ObservableObject {
+    struct Result: Identifiable, Hashable {
+        let hit: SearchIndex.Hit
+        let range: NSRange? // UTF-16 range of the hit in the page's text
+        let snippet: String
+
+        var id: SearchIndex.Hit { hit }
+    }
+
+    static let resultLimit = 500
+    private static let snippetWords = 6 // words shown on each side of the hit
+
+    @Published var query: String = "" {
+        didSet {
+            guard query != oldValue else { return }
+            search()
+        }
+    }
+    @Published private(set) var results: [Result] = []
+    @Published var selected: Result?
+    @Published private(set) var isSearching = false
+
+    private var index: SearchIndex?
+    private var pageText: ((Int) -> String?)?
+    private var searchTask: Task<Void, Never>?
+
+    /// Searches `index` from now on, reading snippets through `pageText` (1-based pages)
+    func setIndex(_ index: SearchIndex?, pageText: @escaping (Int) -> String?) {
+        guard index !== self.index else { return }
+        self.index = index
+        self.pageText = pageText
+        search()
+    }
+
+    func clear() {
+        query = ""
+    }
+
+    private func search() {
+        searchTask?.cancel()
+        selected = nil
+        let phrase = query.trimmingCharacters(in: .whitespacesAndNewlines)
+        guard let index = index, let pageText = pageText, !phrase.isEmpty else {
+            results = []
+            isSearching = false
+            return
+        }
+
+        isSearching = true
+        let limit = Self.resultLimit
+        searchTask = Task {
+            let hits = await Task.detached(priority: .userInitiated) {
+                index.search(phrase, limit: limit)
+            }.value
+            guard !Task.isCancelled else { return }
+
+            // Each page's text is read and split once for all of its hits
+            var pages: [Int: (text: String, words: WordIndex)] = [:]
+            results = hits.map { hit in
+                if pages[hit.page] == nil, let text = pageText(hit.page) {
+                    pages[hit.page] = (text, WordIndex(text))
+                }
+                guard let page = pages[hit.page] else {
+                    return Result(hit: hit, range: nil, snippet: "")
+                }
+                return Self.result(for: hit, in: page.text, words: page.words)
+            }
+            isSearching = false
+        }
+    }
+
+    private static func result(for hit: SearchIndex.Hit, in text: String, words: WordIndex) -> Result {
+        guard hit.word + hit.wordCount <= words.count else {
+            return Result(hit: hit, range: nil, snippet: "")
+        }
+        let first = words.range(at: hit.word)
+        let last = words.range(at: hit.word + hit.wordCount - 1)
+        let range = NSRange(location: first.location, length: NSMaxRange(last) - first.location)
+
+        let snippetWords = max(0, hit.word - snippetWords)..<min(words.count, hit.word + hit.wordCount + snippetWords)
+        let snippet = snippetWords.compactMap { words.word(at: $0, in: text) }.joined(separator: " ")
+        return Result(hit: hit, range: range, snippet: (snippetWords.lowerBound > 0 ? "…" : "") + snippet + (snippetWords.upperBound < words.count ? "…" : ""))
+    }
+}
@@ -0,0 +1,110 @@
+//
+//  ExtractedPageQueue.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+
+/// A page of text produced by `PDFTextExtractor` for the streaming reading pipeline.
+struct ExtractedPage {
+    let pageNumber: Int
+    let text: String
+    var firstWord = 0 // word of the page `text` starts at, when reading resumes mid-page
+}
+
+/// Bounded queue between page extraction (producer) and speech (consumer).
+///
+/// The producer runs on an extraction thread and blocks in `push` while the queue is full, so
+/// extraction never runs more than `capacity` pages ahead of what the speech side has taken.
+/// The consumer awaits pages in order with `next()`.
+final class ExtractedPageQueue: @unchecked Sendable {
+    private let capacity: Int
+    private let condition = NSCondition()
+    private var buffer: [ExtractedPage] = []
+    private var isFinished = false
+    private var isCancelled = false
+    private var waitingConsumer: CheckedContinuation<ExtractedPage?, Never>?
+
+    init(capacity: Int = 4) {
+        self.capacity = max(1, capacity)
+    }
+
+    /// Hands a page to the consumer, waiting while the queue is full.
+    /// Returns false if the queue was cancelled or `shouldStop` returned true before the page was accepted.
+    @discardableResult
+    func push(_ page: ExtractedPage, shouldStop: () -> Bool = { false }) -> Bool {
+        condition.lock()
+        while buffer.count >= capacity && !isCancelled && !shouldStop() {
+            // Timed wait so the producer also notices cancellation of its own work item
+            _ = condition.wait(until: Date().addingTimeInterval(0.25))
+        }
+        guard !isCancelled && !isFinished && !shouldStop() else {
+            condition.unlock()
+            return false
+        }
+
+        if let consumer = waitingConsumer {
+            waitingConsumer = nil
+            condition.unlock()
+            consumer.resume(returning: page)
+            return true
+        }
+
+        buffer.append(page)
+        condition.unlock()
+        return true
+    }
+
+    /// Marks the end of the page stream; `next()` returns nil once the buffer is drained.
+    func finish() {
+        condition.lock()
+        isFinished = true
+        let consumer = waitingConsumer
+        waitingConsumer = nil
+        condition.unlock()
+        consumer?.resume(returning: nil)
+    }
+
+    /// Drops buffered pages and releases both sides. Extraction may continue without streaming.
+    func cancel() {
+        condition.lock()
+        isCancelled = true
+        buffer.removeAll()
+        let consumer = waitingConsumer
+        waitingConsumer = nil
+        condition.broadcast()
+        condition.unlock()
+        consumer?.resume(returning: nil)
+    }
+
+    /// Returns the next page if the buffer already holds it, without waiting for extraction.
+    func nextIfReady() -> ExtractedPage? {
+        condition.lock()
+        defer { condition.unlock() }
+        guard !buffer.isEmpty && !isCancelled else { return nil }
+        let page = buffer.removeFirst()
+        condition.signal()
+        return page
+    }
+
+    /// Returns the next page in reading order, or nil when the stream has finished or was cancelled.
+    func next() async -> ExtractedPage? {
+        await withCheckedContinuation { continuation in
+            condition.lock()
+            if !buffer.isEmpty && !isCancelled {
+                let page = buffer.removeFirst()
+                condition.signal()
+                condition.unlock()
+                continuation.resume(returning: page)
+            } else if isFinished || isCancelled {
+                condition.unlock()
+                continuation.resume(returning: nil)
+            } else {
+                waitingConsumer = continuation
+                condition.unlock()
+            }
+        }
+    }
+}
@@ -0,0 +1,382 @@
+//
+//  ExtractionCache.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import CryptoKit
+import os
+
+/// How a cached page's text was obtained. Raw values are part of the on-disk format.
+enum CachedPageState: UInt32 {
+    case missing = 0      // never extracted
+    case text = 1         // PDF text layer
+    case empty = 2        // page has no text layer, not run through OCR yet
+    case recognized = 3   // no text layer, text recognized with OCR
+    case unrecognized = 4 // no text layer and OCR found no text
+    
+    var hasText: Bool {
+        return self == .text || self == .recognized
+    }
+}
+
+struct CachedPage {
+    let state: CachedPageState
+    let text: String?
+}
+
+/// Identity of a PDF on disk: its content hash plus the size and modification time it was hashed at.
+struct DocumentCacheKey: Codable, Equatable {
+    let contentHash: String // hex SHA-256 of the file contents
+    let fileSize: UInt64
+    let modificationTime: Double // seconds since 1970
+}
+
+/// Persistent per-page text cache for extracted PDFs, stored under Application Support.
+///
+/// Each document gets one `<sha256>.opracache` file per extraction mode, with `-layout` after the
+/// hash for `ExtractionMode.layout`, little-endian throughout:
+///
+///     header  64 bytes          "OPRX", version:u32, pageCount:u32, reserved:u32,
+///                               fileSize:u64, modificationTime:f64, sha256:[32]
+///     pages   16 × pageCount    offset:u64, length:u32, state:u32
+///     text    UTF-8 page text referenced by the page table (offsets are from the start of the file)
+///
+/// Cache files are read memory-mapped, so opening a large document only touches the pages that are
+/// actually read. `windows/Opra/ExtractionCache.cs` reads and writes the same format.
+final class ExtractionCache {
+    static let shared = ExtractionCache()
+
+    static let magic: [UInt8] = Array("OPRX".utf8)
+    static let formatVersion: UInt32 = 1
+    static let headerSize = 64
+    static let pageEntrySize = 16
+
+    let directory: URL
+    private let indexURL: URL
+    private var index: [String: DocumentCacheKey] = [:] // file path -> key it was last hashed to
+    private let lock = NSLock()
+    // Open caches by file path, so every user of a document appends through one instance; two
+    // would append at the same offset and point their page tables at each other's text
+    private let openDocuments = NSMapTable<NSString, DocumentTextCache>.strongToWeakObjects()
+
+    init(directory: URL? = nil) {
+        let baseDirectory = directory ?? FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent("Opra", isDirectory: true)
+            .appendingPathComponent("ExtractionCache", isDirectory: true)
+        self.directory = baseDirectory
+        self.indexURL = baseDirectory.appendingPathComponent("index.json")
+
+        try? FileManager.default.createDirectory(at: baseDirectory, withIntermediateDirectories: true)
+        if let data = try? Data(contentsOf: indexURL),
+           let savedIndex = try? JSONDecoder().decode([String: DocumentCacheKey].self, from: data) {
+            index = savedIndex
+        }
+    }
+
+    /// Returns the cache key for `url`. The file is only re-hashed when its size or modification
+    /// time no longer match what was recorded the last time it was opened.
+    func key(for url: URL) -> DocumentCacheKey? {
+        guard let attributes = try? FileManager.default.attributesOfItem(atPath: url.path),
+              let fileSize = (attributes[.size] as? NSNumber)?.uint64Value,
+              let modificationDate = attributes[.modificationDate] as? Date else {
+            return nil
+        }
+        let modificationTime = modificationDate.timeIntervalSince1970
+
+        lock.lock()
+        let known = index[url.path]
+        lock.unlock()
+        if let known = known, known.fileSize == fileSize, known.modificationTime == modificationTime {
+            return known
+        }
+
+        guard let contentHash = Self.sha256(of: url) else { return nil }
+        let key = DocumentCacheKey(contentHash: contentHash, fileSize: fileSize, modificationTime: modificationTime)
+
+        lock.lock()
+        index[url.path] = key
+        let snapshot = index
+        lock.unlock()
+        if let data = try? JSONEncoder().encode(snapshot) {
+            try? data.write(to: indexURL, options: .atomic)
+        }
+        return key
+    }
+
+    /// Opens the cached pages for a document, or an empty cache if none exists yet. Each mode
+    /// has its own file, so switching modes never mixes page texts. Opening a document that is
+    /// still in use returns the same instance.
+    func document(for key: DocumentCacheKey, pageCount: Int, mode: ExtractionMode = .plain) -> DocumentTextCache {
+        let name = mode == .plain ? key.contentHash : "\(key.contentHash)-\(mode.rawValue)"
+        let fileURL = directory.appendingPathComponent("\(name).opracache")
+        lock.lock()
+        defer { lock.unlock() }
+        if let open = openDocuments.object(forKey: fileURL.path as NSString), open.pageCount == pageCount {
+            return open
+        }
+        let document = DocumentTextCache(key: key, pageCount: pageCount, fileURL: fileURL, mode: mode)
+        openDocuments.setObject(document, forKey: fileURL.path as NSString)
+        return document
+    }
+
+    private static func sha256(of url: URL) -> String? {
+        guard let handle = try? FileHandle(forReadingFrom: url) else { return nil }
+        defer { try? handle.close() }
+
+        var hasher = SHA256()
+        while let chunk = try? handle.read(upToCount: 1 << 20), !chunk.isEmpty {
+            hasher.update(data: chunk)
+        }
+        return hasher.finalize().map { String(format: "%02x", $0) }.joined()
+    }
+}
+
+/// Per-page text for one document. Safe to use from the extraction threads.
+///
+/// Without a key or file URL the cache lives only in memory for as long as the document is open.
+final class DocumentTextCache {
+    let key: DocumentCacheKey?
+    let pageCount: Int
+    let fileURL: URL?
+    let mode: ExtractionMode
+    /// Reading order and header detection for the pages extracted into this cache, with `.layout`
+    let pageLayout: PageLayout?
+
+    private struct PageEntry {
+        var offset: Int
+        var length: Int
+        var state: CachedPageState
+    }
+
+    private var mapped: Data?
+    private var entries: [PageEntry]
+    private var pending: [Int: CachedPage] = [:]
+    private var openedSearchIndex: SearchIndex?
+    private let lock = NSLock()
+
+    init(key: DocumentCacheKey?, pageCount: Int, fileURL: URL?, mode: ExtractionMode = .plain) {
+        self.key = key
+        self.pageCount = pageCount
+        self.fileURL = fileURL
+        self.mode = mode
+        self.pageLayout = mode == .layout ? PageLayout(pageCount: pageCount) : nil
+        self.entries = Array(repeating: PageEntry(offset: 0, length: 0, state: .missing), count: pageCount)
+        load()
+    }
+
+    /// Number of pages that have been extracted at least once
+    var cachedPageCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return (0..<pageCount).filter { pending[$0] != nil || entries[$0].state != .missing }.count
+    }
+
+    /// Returns the cached page, or nil if the page was never extracted.
+    func page(at index: Int) -> CachedPage? {
+        guard index >= 0 && index < pageCount else { return nil }
+        lock.lock()
+        defer { lock.unlock() }
+
+        if let page = pending[index] {
+            return page
+        }
+        let entry = entries[index]
+        switch entry.state {
+        case .missing:
+            return nil
+        case .empty, .unrecognized:
+            return CachedPage(state: entry.state, text: nil)
+        case .text, .recognized:
+            guard let mapped = mapped else { return nil }
+            let bytes = mapped[(mapped.startIndex + entry.offset)..<(mapped.startIndex + entry.offset + entry.length)]
+            return CachedPage(state: entry.state, text: String(decoding: bytes, as: UTF8.self))
+        }
+    }
+
+    /// Records a freshly extracted page. A nil text marks the page as having no text layer, unless
+    /// `state` already says why there is none.
+    func store(_ text: String?, forPage index: Int, state: CachedPageState = .text) {
+        guard index >= 0 && index < pageCount else { return }
+        lock.lock()
+        pending[index] = text.map { CachedPage(state: state, text: $0) } ?? CachedPage(state: state.hasText ? .empty : state, text: nil)
+        let searchIndex = openedSearchIndex
+        lock.unlock()
+        searchIndex?.add(text, forPage: index)
+    }
+
+    /// The search index over this document's pages, kept next to the cache file. Created on first
+    /// use, when the pages stored so far are indexed in the background; later pages are indexed
+    /// as they are stored.
+    func searchIndex() -> SearchIndex {
+        lock.lock()
+        if let searchIndex = openedSearchIndex {
+            lock.unlock()
+            return searchIndex
+        }
+        let created = SearchIndex(pageCount: pageCount, fileURL: key == nil ? nil : fileURL?.deletingPathExtension().appendingPathExtension("oprasearch"))
+        openedSearchIndex = created
+        lock.unlock()
+        created.addMissingPages(from: self)
+        return created
+    }
+
+    /// Frees the text held in memory for pages outside `window`. With a cache file the pages are
+    /// written out and read back through the mapping when needed; without one they are dropped
+    /// and will be extracted again.
+    func releasePages(outside window: Range<Int>) {
+        guard key == nil || fileURL == nil else {
+            save(includingSearchIndex: false)
+            return
+        }
+        lock.lock()
+        pending = pending.filter { window.contains($0.key) }
+        lock.unlock()
+    }
+
+    /// Writes the pages added since the cache was loaded or last saved.
+    ///
+    /// An existing file is only appended to: the new pages' text goes at the end and their page
+    /// table entries are rewritten in place, so unchanged pages are never read or copied and a
+    /// save costs what was added, however large the document. The text is written before the
+    /// entries that point at it, so an interrupted save leaves the old pages readable. When a page
+    /// that already had text is stored again, its old bytes stay in the file unused.
+    ///
+    /// The search index is written whole, so saves made while pages are still coming in can leave
+    /// it out with `includingSearchIndex` and write it once at the end.
+    func save(includingSearchIndex: Bool = true) {
+        lock.lock()
+        defer { lock.unlock() }
+        if includingSearchIndex {
+            openedSearchIndex?.save()
+        }
+        guard !pending.isEmpty, let key = key, let fileURL = fileURL else { return }
+
+        do {
+            if mapped != nil {
+                try appendPending(to: fileURL)
+            } else {
+                try writeNewFile(key: key, to: fileURL)
+            }
+            mapped = try? Data(contentsOf: fileURL, options: .alwaysMapped)
+            pending.removeAll()
+        } catch {
+            Log.cache.error("Could not write extraction cache: \(error.localizedDescription, privacy: .public)")
+        }
+    }
+
+    /// Appends the pending pages to the mapped file and points their table entries at them
+    private func appendPending(to fileURL: URL) throws {
+        let handle = try FileHandle(forUpdating: fileURL)
+        defer { try? handle.close() }
+
+        var newEntries = entries
+        var text = Data()
+        var offset = Int(try handle.seekToEnd())
+        for (index, page) in pending {
+            let bytes = page.text.map { Data($0.utf8) } ?? Data()
+            newEntries[index] = PageEntry(offset: offset, length: bytes.count, state: page.state)
+            text.append(bytes)
+            offset += bytes.count
+        }
+        try handle.write(contentsOf: text)
+        try handle.synchronize()
+
+        for index in pending.keys.sorted() {
+            try handle.seek(toOffset: UInt64(ExtractionCache.headerSize + index * ExtractionCache.pageEntrySize))
+            try handle.write(contentsOf: Self.tableEntry(newEntries[index]))
+        }
+        entries = newEntries
+    }
+
+    /// Writes a file holding only the pending pages, when there is none to append to yet
+    private func writeNewFile(key: DocumentCacheKey, to fileURL: URL) throws {
+        let tableSize = pageCount * ExtractionCache.pageEntrySize
+        var newEntries = Array(repeating: PageEntry(offset: 0, length: 0, state: .missing), count: pageCount)
+        var offset = ExtractionCache.headerSize + tableSize
+        for index in pending.keys.sorted() {
+            let page = pending[index]!
+            let length = page.text?.utf8.count ?? 0
+            newEntries[index] = PageEntry(offset: offset, length: length, state: page.state)
+            offset += length
+        }
+
+        var data = Data(capacity: offset)
+        data.append(contentsOf: ExtractionCache.magic)
+        data.appendLittleEndian(ExtractionCache.formatVersion)
+        data.appendLittleEndian(UInt32(pageCount))
+        data.appendLittleEndian(UInt32(0))
+        data.appendLittleEndian(key.fileSize)
+        data.appendLittleEndian(key.modificationTime.bitPattern)
+        data.append(contentsOf: Self.digestBytes(fromHex: key.contentHash))
+        for entry in newEntries {
+            data.append(Self.tableEntry(entry))
+        }
+        for index in pending.keys.sorted() {
+            if let text = pending[index]?.text {
+                data.append(contentsOf: text.utf8)
+            }
+        }
+
+        try data.write(to: fileURL, options: .atomic)
+        entries = newEntries
+    }
+
+    private static func tableEntry(_ entry: PageEntry) -> Data {
+        var data = Data(capacity: ExtractionCache.pageEntrySize)
+        data.appendLittleEndian(UInt64(entry.offset))
+        data.appendLittleEndian(UInt32(entry.length))
+        data.appendLittleEndian(entry.state.rawValue)
+        return data
+    }
+
+    private func load() {
+        guard let key = key, let fileURL = fileURL,
+              let data = try? Data(contentsOf: fileURL, options: .alwaysMapped),
+              data.count >= ExtractionCache.headerSize,
+              Array(data.prefix(4)) == ExtractionCache.magic,
+              data.readLittleEndian(UInt32.self, at: 4) == ExtractionCache.formatVersion,
+              Int(data.readLittleEndian(UInt32.self, at: 8)) == pageCount,
+              Array(data[(data.startIndex + 32)..<(data.startIndex + 64)]) == Self.digestBytes(fromHex: key.contentHash),
+              data.count >= ExtractionCache.headerSize + pageCount * ExtractionCache.pageEntrySize else {
+            return
+        }
+
+        var loaded = entries
+        for index in 0..<pageCount {
+            let base = ExtractionCache.headerSize + index * ExtractionCache.pageEntrySize
+            let offset = Int(data.readLittleEndian(UInt64.self, at: base))
+            let length = Int(data.readLittleEndian(UInt32.self, at: base + 8))
+            guard let state = CachedPageState(rawValue: data.readLittleEndian(UInt32.self, at: base + 12)),
+                  offset + length <= data.count else {
+                return // Treat a damaged table as an empty cache
+            }
+            loaded[index] = PageEntry(offset: offset, length: length, state: state)
+        }
+        entries = loaded
+        mapped = data
+    }
+
+    private static func digestBytes(fromHex hex: String) -> [UInt8] {
+        var bytes: [UInt8] = []
+        bytes.reserveCapacity(32)
+        var index = hex.startIndex
+        while index < hex.endIndex, let next = hex.index(index, offsetBy: 2, limitedBy: hex.endIndex) {
+            bytes.append(UInt8(hex[index..<next], radix: 16) ?? 0)
+            index = next
+        }
+        return bytes
+    }
+}
+
+private extension Data {
+    mutating func appendLittleEndian<T: FixedWidthInteger>(_ value: T) {
+        withUnsafeBytes(of: value.littleEndian) { append(contentsOf: $0) }
+    }
+
+    func readLittleEndian<T: FixedWidthInteger>(_ type: T.Type, at offset: Int) -> T {
+        withUnsafeBytes { T(littleEndian: $0.loadUnaligned(fromByteOffset: offset, as: T.self)) }
+    }
+}
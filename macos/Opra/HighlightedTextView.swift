@@ -0,0 +1,125 @@
+//
+//  HighlightedTextView.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import SwiftUI
+import AppKit
+
+/// Read-only text view for the extracted text that highlights the word being spoken.
+///
+/// Backed by a TextKit 2 `NSTextView`, which only lays out the visible part of the text, so long
+/// chunks stay cheap to show. The highlight is a rendering attribute on the spoken word's range:
+/// moving it touches two words and never rebuilds or re-lays out the whole text.
+struct HighlightedTextView: NSViewRepresentable {
+    let text: String
+    let highlightedRange: NSRange? // UTF-16 range of the spoken word, nil for no highlight
+
+    private static let textFont = NSFont.monospacedSystemFont(ofSize: NSFont.systemFontSize, weight: .regular)
+    private static let highlightAttributes: [NSAttributedString.Key: Any] = [
+        .backgroundColor: NSColor.systemBlue,
+        .foregroundColor: NSColor.white,
+    ]
+
+    func makeCoordinator() -> Coordinator {
+        Coordinator()
+    }
+
+    func makeNSView(context: Context) -> NSScrollView {
+        let textView = NSTextView(usingTextLayoutManager: true)
+        textView.isEditable = false
+        textView.isSelectable = true
+        textView.isRichText = false
+        textView.drawsBackground = false
+        textView.font = Self.textFont
+        textView.textColor = .labelColor
+        textView.textContainerInset = NSSize(width: 12, height: 12)
+        textView.isVerticallyResizable = true
+        textView.isHorizontallyResizable = false
+        textView.autoresizingMask = [.width]
+        textView.textContainer?.widthTracksTextView = true
+
+        let scrollView = NSScrollView()
+        scrollView.documentView = textView
+        scrollView.hasVerticalScroller = true
+        scrollView.drawsBackground = false
+        return scrollView
+    }
+
+    func updateNSView(_ scrollView: NSScrollView, context: Context) {
+        guard let textView = scrollView.documentView as? NSTextView else { return }
+        let coordinator = context.coordinator
+
+        // Identical strings share storage, so this is cheap on every highlight update
+        if coordinator.text != text {
+            coordinator.text = text
+            coordinator.highlightedRange = nil
+            textView.string = text
+            textView.font = Self.textFont
+            textView.textColor = .labelColor
+        }
+
+        guard coordinator.highlightedRange != highlightedRange else { return }
+        if let previous = coordinator.highlightedRange {
+            setHighlight(false, on: previous, in: textView)
+        }
+        coordinator.highlightedRange = highlightedRange
+        if let range = highlightedRange {
+            setHighlight(true, on: range, in: textView)
+            textView.scrollRangeToVisible(range)
+        }
+    }
+
+    private func setHighlight(_ isHighlighted: Bool, on range: NSRange, in textView: NSTextView) {
+        guard let layoutManager = textView.textLayoutManager,
+              let contentManager = layoutManager.textContentManager,
+              NSMaxRange(range) <= (textView.string as NSString).length,
+              let start = contentManager.location(contentManager.documentRange.location, offsetBy: range.location),
+              let end = contentManager.location(start, offsetBy: range.length),
+              let textRange = NSTextRange(location: start, end: end) else {
+            return
+        }
+
+        if isHighlighted {
+            layoutManager.setRenderingAttributes(Self.highlightAttributes, for: textRange)
+        } else {
+            for key in Self.highlightAttributes.keys {
+                layoutManager.removeRenderingAttribute(key, for: textRange)
+            }
+        }
+    }
+
+    final class Coordinator {
+        var text = ""
+        var highlightedRange: NSRange?
+    }
+}
+
+/// `HighlightedTextView` following the spoken word. Only this view observes the word, so moving
+/// the highlight doesn't re-render the window around it.
+struct SpokenTextView: View {
+    let text: String
+    @ObservedObject var spokenWord: SpokenWordHighlight
+    let isFollowing: Bool
+
+    var body: some View {
+        HighlightedTextView(text: text, highlightedRange: isFollowing ? spokenWord.range : nil)
+    }
+}
+
+/// "Reading: <word>" for the spoken word, read out of the text only when the caption is drawn
+struct SpokenWordCaption: View {
+    let text: String
+    @ObservedObject var spokenWord: SpokenWordHighlight
+
+    var body: some View {
+        if let range = spokenWord.range, NSMaxRange(range) <= (text as NSString).length {
+            Text("Reading: \"\((text as NSString).substring(with: range))\"")
+                .font(.caption2)
+                .foregroundColor(.blue)
+                .fontWeight(.medium)
+        }
+    }
+}
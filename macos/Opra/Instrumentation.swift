@@ -0,0 +1,61 @@
+//
+//  Instrumentation.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import os
+
+/// Loggers for each stage of the reading pipeline, all under the subsystem `Log.subsystem`.
+///
+/// Debug messages are neither formatted nor stored unless something is streaming them, e.g.
+/// Console with debug messages on or `log stream --level debug --predicate 'subsystem == "com.opra.pdfreader"'`,
+/// so they can stay in per-page and per-utterance paths. Strings are redacted in stored logs unless
+/// marked public; document text never is.
+enum Log {
+    static let subsystem = "com.opra.pdfreader"
+
+    static let extraction = Logger(subsystem: subsystem, category: "Extraction")
+    static let recognition = Logger(subsystem: subsystem, category: "OCR")
+    static let chunking = Logger(subsystem: subsystem, category: "Chunking")
+    static let speech = Logger(subsystem: subsystem, category: "Speech")
+    static let export = Logger(subsystem: subsystem, category: "Export")
+    static let cache = Logger(subsystem: subsystem, category: "Cache")
+    static let launch = Logger(subsystem: subsystem, category: "Launch")
+}
+
+/// Signpost intervals for the same stages, shown on a timeline by the os_signpost instrument in
+/// Instruments. Until a recording is running, each interval costs one enabled check.
+///
+/// Extraction: "Extract pages" per batch, "Extract page" per streamed page. OCR: "Recognize
+/// page". Chunking: "Assemble text" and "Chunk". Speech: "Normalize" per segment, "Speech start"
+/// from handing an utterance to the synthesizer until it starts, then "Utterance" while it plays.
+/// Export: "Render page".
+enum Signpost {
+    static let extraction = OSSignposter(logger: Log.extraction)
+    static let recognition = OSSignposter(logger: Log.recognition)
+    static let chunking = OSSignposter(logger: Log.chunking)
+    static let speech = OSSignposter(logger: Log.speech)
+    static let export = OSSignposter(logger: Log.export)
+}
+
+/// Time from the process starting to the first window taking input, logged by the app on every
+/// launch and measured across launches by `opra-cli benchmark --app`.
+enum LaunchTiming {
+    /// Launch argument followed by a file: the app writes its time to interactive there, in
+    /// milliseconds, and quits
+    static let measureArgument = "--measure-launch"
+
+    /// Seconds since the kernel started this process, including loading the binary and its
+    /// libraries, which a timer started in `main` would miss
+    static var sinceProcessStart: TimeInterval? {
+        var info = kinfo_proc()
+        var size = MemoryLayout<kinfo_proc>.stride
+        var mib: [Int32] = [CTL_KERN, KERN_PROC, KERN_PROC_PID, getpid()]
+        guard sysctl(&mib, u_int(mib.count), &info, &size, nil, 0) == 0 else { return nil }
+        let start = info.kp_proc.p_un.__p_starttime
+        return Date().timeIntervalSince1970 - (TimeInterval(start.tv_sec) + TimeInterval(start.tv_usec) / 1_000_000)
+    }
+}
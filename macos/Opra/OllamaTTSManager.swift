@@ -7,9 +7,10 @@
 
 import Foundation
 import AVFoundation
+import os
 
 @MainActor
-class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
+class OllamaTTSManager: NSObject, ObservableObject {
     @Published var isAvailable: Bool = false
     @Published var isProcessing: Bool = false
     @Published var availableModels: [String] = []
@@ -18,25 +19,73 @@ class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
     @Published var isSpeaking: Bool = false
     @Published var isPaused: Bool = false
     @Published var speechRate: Float = 1.0
-    @Published var readingProgress: Double = 0.0
     @Published var isRetrying: Bool = false
-    @Published var currentWordIndex: Int = 0
-    @Published var totalWords: Int = 0
-    @Published var elapsedTime: TimeInterval = 0.0
+    @Published var speechEndpoint: String = SpeechStreamClient.defaultEndpoint
+    @Published var batchRequests: Bool = false
+    
+    // Change with every word and timer tick, so they are published through `telemetry` instead
+    let telemetry = PlaybackTelemetry()
+    private(set) var readingProgress: Double = 0.0 {
+        didSet { telemetry.report(readingProgress: readingProgress) }
+    }
+    private(set) var currentWordIndex: Int = 0 {
+        didSet { telemetry.report(currentWordIndex: currentWordIndex) }
+    }
+    private(set) var totalWords: Int = 0 {
+        didSet { telemetry.report(totalWords: totalWords) }
+    }
+    private(set) var elapsedTime: TimeInterval = 0.0 {
+        didSet { telemetry.report(elapsedTime: elapsedTime) }
+    }
     
     private let ollamaBaseURL = "http://localhost:11434"
-    private var audioPlayer: AVAudioPlayer?
-    private var currentAudioData: Data?
+    private static let lastKnownModelsKey = "ollamaLastKnownModels"
+    private let requestScheduler = SpeechRequestScheduler.shared
+    private let audioPlayer = StreamingAudioPlayer()
+    private var playbackTask: Task<Void, Never>?
+    private var progressTimer: Timer?
+    
+    // Render-ahead: segments after the one playing are synthesized into the audio cache
+    private let renderCache = AudioRenderCache.shared
+    private let renderScheduler = AudioRenderScheduler()
+    private let renderAheadCount = 2
+    private var segmentTexts: [TextRange] = []
+    private var pageQueue: ExtractedPageQueue? // pages still to come, appended to segmentTexts as they arrive
+    private var preparedSegments: [Int: SpeechSegment] = [:]
+    private var scheduledSegments: [(segment: SpeechSegment, start: TimeInterval)] = [] // start on the player's timeline
+    private var completedSegmentCount = 0 // leading entries of scheduledSegments whose audio is fully scheduled
+    private var playingSegment: Int?
     private var fullText: String = ""
-    private var words: [String] = []
+    private var words = WordIndex.empty
     private var elapsedTimeTimer: DispatchSourceTimer?
     private var playbackStartDate: Date?
     
+    private struct SpeechSegment {
+        let index: Int // chunk index
+        let text: String // preprocessed text
+        let words: WordIndex
+        let key: AudioRenderKey
+    }
+    
     override init() {
         super.init()
+        speechEndpoint = UserDefaults.standard.string(forKey: "ollamaSpeechEndpoint") ?? SpeechStreamClient.defaultEndpoint
+        batchRequests = UserDefaults.standard.bool(forKey: "ollamaBatchRequests")
+        audioPlayer.onFinished = { [weak self] in
+            self?.playbackDidFinish()
+        }
+        
+        // The last probe's result stands in until this one answers, which takes up to the
+        // request timeout when the server isn't running
+        if let models = UserDefaults.standard.stringArray(forKey: Self.lastKnownModelsKey) {
+            isAvailable = true
+            availableModels = models
+            selectBestTTSModel()
+        }
         checkOllamaAvailability()
     }
     
+    /// Asks the server for its models in the background, remembering the answer for the next launch
     func checkOllamaAvailability() {
         guard let url = URL(string: "\(ollamaBaseURL)/api/tags") else {
             isAvailable = false
@@ -48,7 +97,7 @@ class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
         request.httpMethod = "GET"
         request.timeoutInterval = 5.0 // Add timeout
         
-        URLSession.shared.dataTask(with: request) { [weak self] data, response, error in
+        requestScheduler.session.dataTask(with: request) { [weak self] data, response, error in
             DispatchQueue.main.async {
                 if let error = error {
                     self?.isAvailable = false
@@ -59,6 +108,7 @@ class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
                     } else {
                         self?.errorMessage = "Ollama not available: \(error.localizedDescription)"
                     }
+                    UserDefaults.standard.removeObject(forKey: Self.lastKnownModelsKey)
                     return
                 }
                 
@@ -72,6 +122,8 @@ class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
                             self?.errorMessage = nil
                             self?.availableModels = models.compactMap { $0["name"] as? String }
                             self?.selectBestTTSModel()
+                            UserDefaults.standard.set(self?.availableModels, forKey: Self.lastKnownModelsKey)
+                            return
                         } else {
                             self?.isAvailable = false
                             self?.errorMessage = "Could not parse Ollama response"
@@ -84,6 +136,7 @@ class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
                     self?.isAvailable = false
                     self?.errorMessage = "Invalid response from Ollama server"
                 }
+                UserDefaults.standard.removeObject(forKey: Self.lastKnownModelsKey)
             }
         }.resume()
     }
@@ -100,154 +153,271 @@ class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
     }
     
     func speak(_ text: String) {
+        speakChunkedText([TextStore(text).all], startChunk: 0)
+    }
+    
+    func speakChunkedText(_ texts: [TextRange], startChunk: Int = 0) {
         guard isAvailable && !selectedModel.isEmpty else {
             errorMessage = "Ollama TTS not available or no model selected"
             return
         }
         
-        isProcessing = true
-        errorMessage = nil
-        readingProgress = 0.0
-        
-        // Preprocess text to handle formulas and special characters
-        let processedText = preprocessTextForTTS(text)
-        
-        // Set up word tracking
-        fullText = processedText
-        words = processedText.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }
-        totalWords = words.count
-        currentWordIndex = 0
+        // Replace whatever is playing or still being synthesized
+        stopSpeaking()
         
-        generateSpeech(text: processedText) { [weak self] audioData in
-            DispatchQueue.main.async {
-                self?.isProcessing = false
-                
-                if let audioData = audioData {
-                    self?.playAudio(audioData)
-                } else {
-                    self?.errorMessage = "Failed to generate speech"
-                }
-            }
+        guard startChunk >= 0 && startChunk < texts.count else {
+            Log.speech.notice("Nothing to speak: no chunks")
+            return
         }
+        
+        segmentTexts = texts
+        startPlayback(from: startChunk)
     }
     
-    private func generateSpeech(text: String, completion: @escaping (Data?) -> Void) {
-        // Check if we have a valid TTS model
-        guard !selectedModel.isEmpty else {
-            DispatchQueue.main.async {
-                self.errorMessage = "No TTS model selected"
-                completion(nil)
-            }
+    /// Speaks pages as they are extracted, each page being one segment. Pages the queue already
+    /// holds are rendered ahead like upcoming chunks.
+    func speakPageStream(_ queue: ExtractedPageQueue) {
+        guard isAvailable && !selectedModel.isEmpty else {
+            errorMessage = "Ollama TTS not available or no model selected"
             return
         }
         
-        // For now, we'll disable Ollama TTS since sematre/orpheus is a language model, not TTS
-        // In a real implementation, you'd need a proper TTS model like bark, xtts, or similar
-        DispatchQueue.main.async {
-            self.errorMessage = "Ollama TTS is not yet fully implemented. sematre/orpheus is a language model, not a TTS model. Please use System TTS for now."
-            completion(nil)
-        }
-        
-        // TODO: Implement proper TTS model support
-        // This would require installing a TTS model like:
-        // - bark (text-to-speech)
-        // - xtts (multilingual TTS)
-        // - or similar TTS-specific models
+        Log.speech.debug("Speaking pages as they are extracted")
+        stopSpeaking()
+        pageQueue = queue
+        startPlayback(from: 0)
     }
     
-    private func playAudio(_ audioData: Data) {
-        // Validate audio data before attempting to play
-        guard !audioData.isEmpty else {
-            errorMessage = "No audio data received from Ollama"
-            isProcessing = false
+    private func startPlayback(from startChunk: Int) {
+        guard let endpoint = URL(string: speechEndpoint) else {
+            errorMessage = "Invalid speech server URL"
             return
         }
         
-        // Check if data looks like valid audio (basic validation)
-        guard audioData.count > 100 else {
-            errorMessage = "Audio data too small, may be invalid"
-            isProcessing = false
-            return
-        }
+        isProcessing = true
+        errorMessage = nil
+        readingProgress = 0.0
         
-        do {
-            audioPlayer = try AVAudioPlayer(data: audioData)
-            
-            // Additional validation after creating player
-            guard audioPlayer?.duration ?? 0 > 0 else {
-                errorMessage = "Invalid audio duration, cannot play"
-                isProcessing = false
-                return
+        var client = SpeechStreamClient(endpoint: endpoint, model: selectedModel, scheduler: requestScheduler)
+        client.supportsBatching = batchRequests
+        playbackTask = Task { [weak self] in
+            await self?.playSegments(from: startChunk, client: client)
+        }
+    }
+    
+    /// Schedules the segments back to back on the player. Each one is read from the audio cache when
+    /// it has been synthesized before, and streamed from the server (and cached) otherwise.
+    private func playSegments(from startIndex: Int, client: SpeechStreamClient) async {
+        var index = startIndex
+        while await loadSegment(index) {
+            guard !Task.isCancelled else { return }
+            let segment = prepareSegment(index, client: client)
+            if index == startIndex {
+                showSegment(segment)
             }
             
-            audioPlayer?.delegate = self
-            audioPlayer?.prepareToPlay()
+            // A render-ahead already under way for this segment is finished instead of started over
+            await renderScheduler.waitForRender(of: segment.key)
+            guard !Task.isCancelled else { return }
             
-            // Final check before playing
-            guard audioPlayer?.play() == true else {
-                errorMessage = "Failed to start audio playback"
-                isProcessing = false
-                return
+            // Synthesize the next few segments in the background while this one plays
+            takeReadyPages(through: index + renderAheadCount)
+            let upcoming = (index + 1)..<min(index + 1 + renderAheadCount, segmentTexts.count)
+            renderScheduler.prefetch(upcoming.map { i in
+                let next = prepareSegment(i, client: client)
+                return AudioRenderScheduler.Segment(key: next.key, text: next.text)
+            }, using: client)
+            
+            scheduledSegments.append((segment, audioPlayer.scheduledDuration))
+            do {
+                let isCached = try await renderCache.readBuffers(for: segment.key) { buffer in
+                    try await self.enqueue(buffer)
+                }
+                if isCached {
+                    Log.speech.debug("Playing chunk \(index + 1) from the audio cache")
+                } else {
+                    try await streamSegment(segment, client: client)
+                }
+            } catch {
+                guard !Task.isCancelled else { return }
+                Log.speech.error("Speech stream failed: \(error.localizedDescription, privacy: .public)")
+                errorMessage = "Failed to generate speech: \(error.localizedDescription)"
+                break
             }
+            guard !Task.isCancelled else { return }
+            completedSegmentCount = scheduledSegments.count
+            index += 1
+        }
+        guard !Task.isCancelled else { return }
+        
+        isProcessing = false
+        if audioPlayer.isStarted {
+            // Let whatever is queued play out
+            audioPlayer.finishScheduling()
+        } else if errorMessage == nil {
+            errorMessage = "No audio data received from the speech server"
+        }
+    }
+    
+    /// Whether there is a segment `index`, waiting for the page stream to deliver it if needed
+    private func loadSegment(_ index: Int) async -> Bool {
+        if index < segmentTexts.count {
+            return true
+        }
+        guard let queue = pageQueue, let page = await queue.next(), !Task.isCancelled else { return false }
+        segmentTexts.append(TextStore(page.text).all)
+        return index < segmentTexts.count
+    }
+    
+    /// Moves the pages the stream already holds into `segmentTexts`, up to segment `last`
+    private func takeReadyPages(through last: Int) {
+        guard let queue = pageQueue else { return }
+        while segmentTexts.count <= last, let page = queue.nextIfReady() {
+            segmentTexts.append(TextStore(page.text).all)
+        }
+    }
+    
+    /// Streams a segment that is not cached yet, keeping a copy for the next time it is played
+    private func streamSegment(_ segment: SpeechSegment, client: SpeechStreamClient) async throws {
+        var writer: AudioRenderCache.Writer?
+        let startDate = Date()
+        var audio: TimeInterval = 0
+        var playerWait: TimeInterval = 0
+        do {
+            try await client.synthesize(segment.text) { buffer in
+                try Task.checkCancellation()
+                if writer == nil {
+                    writer = try? self.renderCache.makeWriter(for: segment.key, format: buffer.format)
+                }
+                // A failing cache never interrupts playback
+                try? writer?.write(buffer)
+                audio += buffer.duration
+                // Time spent waiting for room in the player is playback, not synthesis
+                let enqueueDate = Date()
+                try await self.enqueue(buffer)
+                playerWait += Date().timeIntervalSince(enqueueDate)
+            }
+            try? writer?.commit()
+            PipelineMetrics.shared.recordSynthesis(of: audio, in: Date().timeIntervalSince(startDate) - playerWait, by: .ollama)
+        } catch {
+            writer?.discard()
+            throw error
+        }
+    }
+    
+    private func prepareSegment(_ index: Int, client: SpeechStreamClient) -> SpeechSegment {
+        if let segment = preparedSegments[index] {
+            return segment
+        }
+        
+        // Preprocess text to handle formulas and special characters
+        let processedText = preprocessTextForTTS(segmentTexts[index].string)
+        let segment = SpeechSegment(
+            index: index,
+            text: processedText,
+            words: WordIndex(processedText),
+            key: AudioRenderKey(text: processedText, model: client.model, voice: client.voice)
+        )
+        preparedSegments[index] = segment
+        return segment
+    }
+    
+    /// Renders the opening `text` of a document that is queued to be read next into the audio
+    /// cache, so it starts without waiting for the server. The render only uses the speech server
+    /// while render-ahead for the current document has nothing to do.
+    func prerender(_ text: TextRange) {
+        guard isAvailable && !selectedModel.isEmpty, let endpoint = URL(string: speechEndpoint) else { return }
+        var client = SpeechStreamClient(endpoint: endpoint, model: selectedModel, scheduler: requestScheduler)
+        client.supportsBatching = batchRequests
+        
+        // Keyed exactly like `prepareSegment`, so playback finds it
+        let processedText = preprocessTextForTTS(text.string)
+        let key = AudioRenderKey(text: processedText, model: client.model, voice: client.voice)
+        renderScheduler.prefetchWhenIdle([AudioRenderScheduler.Segment(key: key, text: processedText)], using: client)
+    }
+    
+    /// Chunks after the playing one that are ready to play: already scheduled on the player, or
+    /// rendered into the audio cache and next in line
+    var renderedAheadCount: Int {
+        guard isSpeaking, let playing = playingSegment, playing < scheduledSegments.count else { return 0 }
+        let scheduled = scheduledSegments.count - 1 - playing
+        let nextIndex = scheduledSegments[scheduledSegments.count - 1].segment.index + 1
+        let cached = (nextIndex..<max(nextIndex, segmentTexts.count)).prefix { index in
+            preparedSegments[index].map { renderCache.contains($0.key) } ?? false
+        }.count
+        return scheduled + cached
+    }
+    
+    private func showSegment(_ segment: SpeechSegment) {
+        // Set up word tracking
+        fullText = segment.text
+        words = segment.words
+        totalWords = words.count
+        currentWordIndex = 0
+    }
+    
+    private func enqueue(_ buffer: AVAudioPCMBuffer) async throws {
+        if !audioPlayer.isStarted {
+            try audioPlayer.start(format: buffer.format)
+            audioPlayer.rate = speechRate
             
+            isProcessing = false
             isSpeaking = true
             isPaused = false
-            currentAudioData = audioData
             playbackStartDate = Date()
             
             // Start progress tracking
             startProgressTracking()
             startElapsedTimeTracking()
-        } catch {
-            errorMessage = "Failed to play audio: \(error.localizedDescription)"
-            isProcessing = false
         }
+        
+        // Waits while the player already has enough audio queued
+        await audioPlayer.schedule(buffer)
     }
     
     private func startProgressTracking() {
-        var timeoutCounter = 0
-        let maxTimeout = 100 // 10 seconds timeout
-        
-        Timer.scheduledTimer(withTimeInterval: 0.1, repeats: true) { [weak self] timer in
+        progressTimer?.invalidate()
+        progressTimer = Timer.scheduledTimer(withTimeInterval: 0.1, repeats: true) { [weak self] timer in
             Task { @MainActor in
-                guard let self = self, let player = self.audioPlayer else {
+                guard let self = self, self.isSpeaking else {
                     timer.invalidate()
                     return
                 }
-                
-                if !player.isPlaying {
-                    timer.invalidate()
-                    return
-                }
-                
-                // Check for timeout (audio stuck)
-                timeoutCounter += 1
-                if timeoutCounter > maxTimeout {
-                    print("Audio player timeout detected, stopping playback")
-                    self.stopSpeaking()
-                    self.errorMessage = "Audio playback timed out"
-                    timer.invalidate()
-                    return
-                }
-                
-                // Check for valid duration
-                guard player.duration > 0 else {
-                    print("Invalid audio duration detected, stopping playback")
-                    self.stopSpeaking()
-                    self.errorMessage = "Invalid audio duration"
-                    timer.invalidate()
-                    return
-                }
-                
-                let progress = player.currentTime / player.duration
-                self.readingProgress = Double(progress)
-                
-                // Update word index based on progress
-                self.currentWordIndex = Int(progress * Double(self.totalWords))
+                self.updateProgress()
             }
         }
     }
     
+    private func updateProgress() {
+        let played = audioPlayer.playedDuration
+        guard let position = scheduledSegments.lastIndex(where: { $0.start <= played }) else { return }
+        
+        let entry = scheduledSegments[position]
+        if position != playingSegment {
+            playingSegment = position
+            showSegment(entry.segment)
+        }
+        
+        // A segment's length is known once the next one starts or its stream has ended; until then estimate it from the text
+        let end: TimeInterval
+        if position + 1 < scheduledSegments.count {
+            end = scheduledSegments[position + 1].start
+        } else if position < completedSegmentCount {
+            end = audioPlayer.scheduledDuration
+        } else {
+            let estimated = Double(entry.segment.text.count) / TextChunker.charactersPerSecondAtDefaultRate
+            end = entry.start + max(audioPlayer.scheduledDuration - entry.start, estimated)
+        }
+        let duration = end - entry.start
+        guard duration > 0 else { return }
+        
+        let progress = min(1.0, (played - entry.start) / duration)
+        readingProgress = progress
+        
+        // Update word index based on progress
+        currentWordIndex = min(Int(progress * Double(totalWords)), max(0, totalWords - 1))
+    }
+    
     private func startElapsedTimeTracking() {
         // Cancel any existing elapsed time timer
         elapsedTimeTimer?.cancel()
@@ -277,26 +447,35 @@ class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
     }
     
     func pauseSpeaking() {
-        audioPlayer?.pause()
+        audioPlayer.pause()
         isPaused = true
     }
     
     func resumeSpeaking() {
-        audioPlayer?.play()
+        audioPlayer.resume()
         isPaused = false
     }
     
     func stopSpeaking() {
-        audioPlayer?.stop()
+        playbackTask?.cancel()
+        playbackTask = nil
+        renderScheduler.cancelAll()
+        requestScheduler.cancelAll() // Requests for audio that will no longer be played
+        renderScheduler.resumeIdleRenders()
+        audioPlayer.stop()
+        resetSegments()
+        isProcessing = false
         isSpeaking = false
         isPaused = false
         readingProgress = 0.0
         currentWordIndex = 0
         elapsedTime = 0.0
-        currentAudioData = nil
+        telemetry.flush()
         playbackStartDate = nil
         
-        // Cancel elapsed time timer
+        // Cancel progress and elapsed time timers
+        progressTimer?.invalidate()
+        progressTimer = nil
         stopElapsedTimeTracking()
     }
     
@@ -307,13 +486,23 @@ class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
     
     func setSpeechRate(_ rate: Float) {
         speechRate = rate
-        audioPlayer?.rate = rate
+        audioPlayer.rate = rate
     }
     
     func setModel(_ model: String) {
         selectedModel = model
     }
     
+    func setSpeechEndpoint(_ endpoint: String) {
+        speechEndpoint = endpoint
+        UserDefaults.standard.set(endpoint, forKey: "ollamaSpeechEndpoint")
+    }
+    
+    func setBatchRequests(_ enabled: Bool) {
+        batchRequests = enabled
+        UserDefaults.standard.set(enabled, forKey: "ollamaBatchRequests")
+    }
+    
     func retryConnection() {
         isRetrying = true
         errorMessage = nil
@@ -345,7 +534,7 @@ class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
             return
         }
         
-        URLSession.shared.dataTask(with: request) { data, response, error in
+        requestScheduler.session.dataTask(with: request) { data, response, error in
             DispatchQueue.main.async {
                 if error == nil {
                     self.checkOllamaAvailability()
@@ -358,141 +547,38 @@ class OllamaTTSManager: NSObject, ObservableObject, AVAudioPlayerDelegate {
     }
     
     private func preprocessTextForTTS(_ text: String) -> String {
-        var processedText = text
-        
-        // Handle LaTeX math delimiters more carefully to preserve content
-        processedText = processedText.replacingOccurrences(of: "\\(", with: " (")
-        processedText = processedText.replacingOccurrences(of: "\\)", with: ") ")
-        processedText = processedText.replacingOccurrences(of: "\\[", with: " [")
-        processedText = processedText.replacingOccurrences(of: "\\]", with: "] ")
-        processedText = processedText.replacingOccurrences(of: "$$", with: " ")
-        processedText = processedText.replacingOccurrences(of: "$", with: " ")
-        
-        // Handle common LaTeX commands
-        processedText = processedText.replacingOccurrences(of: "\\frac{", with: " fraction ")
-        processedText = processedText.replacingOccurrences(of: "\\sqrt{", with: " square root of ")
-        processedText = processedText.replacingOccurrences(of: "\\sum", with: " sum ")
-        processedText = processedText.replacingOccurrences(of: "\\int", with: " integral ")
-        processedText = processedText.replacingOccurrences(of: "\\lim", with: " limit ")
-        processedText = processedText.replacingOccurrences(of: "\\infty", with: " infinity ")
-        processedText = processedText.replacingOccurrences(of: "\\alpha", with: " alpha ")
-        processedText = processedText.replacingOccurrences(of: "\\beta", with: " beta ")
-        processedText = processedText.replacingOccurrences(of: "\\gamma", with: " gamma ")
-        processedText = processedText.replacingOccurrences(of: "\\delta", with: " delta ")
-        processedText = processedText.replacingOccurrences(of: "\\epsilon", with: " epsilon ")
-        processedText = processedText.replacingOccurrences(of: "\\theta", with: " theta ")
-        processedText = processedText.replacingOccurrences(of: "\\lambda", with: " lambda ")
-        processedText = processedText.replacingOccurrences(of: "\\mu", with: " mu ")
-        processedText = processedText.replacingOccurrences(of: "\\pi", with: " pi ")
-        processedText = processedText.replacingOccurrences(of: "\\sigma", with: " sigma ")
-        processedText = processedText.replacingOccurrences(of: "\\tau", with: " tau ")
-        processedText = processedText.replacingOccurrences(of: "\\phi", with: " phi ")
-        processedText = processedText.replacingOccurrences(of: "\\omega", with: " omega ")
-        
-        // Handle mathematical operators
-        processedText = processedText.replacingOccurrences(of: "\\times", with: " times ")
-        processedText = processedText.replacingOccurrences(of: "\\div", with: " divided by ")
-        processedText = processedText.replacingOccurrences(of: "\\pm", with: " plus or minus ")
-        processedText = processedText.replacingOccurrences(of: "\\mp", with: " minus or plus ")
-        processedText = processedText.replacingOccurrences(of: "\\leq", with: " less than or equal to ")
-        processedText = processedText.replacingOccurrences(of: "\\geq", with: " greater than or equal to ")
-        processedText = processedText.replacingOccurrences(of: "\\neq", with: " not equal to ")
-        processedText = processedText.replacingOccurrences(of: "\\approx", with: " approximately equal to ")
-        processedText = processedText.replacingOccurrences(of: "\\equiv", with: " equivalent to ")
-        processedText = processedText.replacingOccurrences(of: "\\propto", with: " proportional to ")
-        processedText = processedText.replacingOccurrences(of: "\\in", with: " in ")
-        processedText = processedText.replacingOccurrences(of: "\\notin", with: " not in ")
-        processedText = processedText.replacingOccurrences(of: "\\subset", with: " subset of ")
-        processedText = processedText.replacingOccurrences(of: "\\supset", with: " superset of ")
-        processedText = processedText.replacingOccurrences(of: "\\cup", with: " union ")
-        processedText = processedText.replacingOccurrences(of: "\\cap", with: " intersection ")
-        processedText = processedText.replacingOccurrences(of: "\\emptyset", with: " empty set ")
-        processedText = processedText.replacingOccurrences(of: "\\forall", with: " for all ")
-        processedText = processedText.replacingOccurrences(of: "\\exists", with: " there exists ")
-        processedText = processedText.replacingOccurrences(of: "\\rightarrow", with: " implies ")
-        processedText = processedText.replacingOccurrences(of: "\\leftarrow", with: " implied by ")
-        processedText = processedText.replacingOccurrences(of: "\\leftrightarrow", with: " if and only if ")
-        
-        // Handle superscripts and subscripts
-        processedText = processedText.replacingOccurrences(of: "^{", with: " to the power of ")
-        processedText = processedText.replacingOccurrences(of: "_{", with: " sub ")
-        processedText = processedText.replacingOccurrences(of: "}", with: " ")
-        
-        // Handle common mathematical symbols
-        processedText = processedText.replacingOccurrences(of: "∑", with: " sum ")
-        processedText = processedText.replacingOccurrences(of: "∏", with: " product ")
-        processedText = processedText.replacingOccurrences(of: "∫", with: " integral ")
-        processedText = processedText.replacingOccurrences(of: "√", with: " square root ")
-        processedText = processedText.replacingOccurrences(of: "∞", with: " infinity ")
-        processedText = processedText.replacingOccurrences(of: "α", with: " alpha ")
-        processedText = processedText.replacingOccurrences(of: "β", with: " beta ")
-        processedText = processedText.replacingOccurrences(of: "γ", with: " gamma ")
-        processedText = processedText.replacingOccurrences(of: "δ", with: " delta ")
-        processedText = processedText.replacingOccurrences(of: "ε", with: " epsilon ")
-        processedText = processedText.replacingOccurrences(of: "θ", with: " theta ")
-        processedText = processedText.replacingOccurrences(of: "λ", with: " lambda ")
-        processedText = processedText.replacingOccurrences(of: "μ", with: " mu ")
-        processedText = processedText.replacingOccurrences(of: "π", with: " pi ")
-        processedText = processedText.replacingOccurrences(of: "σ", with: " sigma ")
-        processedText = processedText.replacingOccurrences(of: "τ", with: " tau ")
-        processedText = processedText.replacingOccurrences(of: "φ", with: " phi ")
-        processedText = processedText.replacingOccurrences(of: "ω", with: " omega ")
-        processedText = processedText.replacingOccurrences(of: "×", with: " times ")
-        processedText = processedText.replacingOccurrences(of: "÷", with: " divided by ")
-        processedText = processedText.replacingOccurrences(of: "±", with: " plus or minus ")
-        processedText = processedText.replacingOccurrences(of: "≤", with: " less than or equal to ")
-        processedText = processedText.replacingOccurrences(of: "≥", with: " greater than or equal to ")
-        processedText = processedText.replacingOccurrences(of: "≠", with: " not equal to ")
-        processedText = processedText.replacingOccurrences(of: "≈", with: " approximately equal to ")
-        processedText = processedText.replacingOccurrences(of: "≡", with: " equivalent to ")
-        processedText = processedText.replacingOccurrences(of: "∝", with: " proportional to ")
-        processedText = processedText.replacingOccurrences(of: "∈", with: " in ")
-        processedText = processedText.replacingOccurrences(of: "∉", with: " not in ")
-        processedText = processedText.replacingOccurrences(of: "⊂", with: " subset of ")
-        processedText = processedText.replacingOccurrences(of: "⊃", with: " superset of ")
-        processedText = processedText.replacingOccurrences(of: "∪", with: " union ")
-        processedText = processedText.replacingOccurrences(of: "∩", with: " intersection ")
-        processedText = processedText.replacingOccurrences(of: "∅", with: " empty set ")
-        processedText = processedText.replacingOccurrences(of: "∀", with: " for all ")
-        processedText = processedText.replacingOccurrences(of: "∃", with: " there exists ")
-        processedText = processedText.replacingOccurrences(of: "→", with: " implies ")
-        processedText = processedText.replacingOccurrences(of: "←", with: " implied by ")
-        processedText = processedText.replacingOccurrences(of: "↔", with: " if and only if ")
-        
-        // Clean up excessive whitespace but preserve word boundaries
-        processedText = processedText.replacingOccurrences(of: "\\s{2,}", with: " ", options: .regularExpression)
-        processedText = processedText.trimmingCharacters(in: .whitespacesAndNewlines)
-        
-        return processedText
+        // Same math/symbol rules as the system voice, applied in a single pass
+        return TextNormalizer.shared.normalize(text)
     }
 }
 
-// MARK: - AVAudioPlayerDelegate
+// MARK: - Playback completion
 extension OllamaTTSManager {
-    nonisolated func audioPlayerDidFinishPlaying(_ player: AVAudioPlayer, successfully flag: Bool) {
-        Task { @MainActor in
-            isSpeaking = false
-            isPaused = false
-            readingProgress = 0.0
-            currentWordIndex = 0
-            elapsedTime = 0.0
-            playbackStartDate = nil
-            
-            // Cancel elapsed time timer
-            stopElapsedTimeTracking()
-        }
+    private func playbackDidFinish() {
+        playbackTask = nil
+        audioPlayer.stop()
+        resetSegments()
+        isSpeaking = false
+        isPaused = false
+        readingProgress = 0.0
+        currentWordIndex = 0
+        elapsedTime = 0.0
+        telemetry.flush()
+        playbackStartDate = nil
+        
+        // Cancel progress and elapsed time timers
+        progressTimer?.invalidate()
+        progressTimer = nil
+        stopElapsedTimeTracking()
     }
     
-    nonisolated func audioPlayerDecodeErrorDidOccur(_ player: AVAudioPlayer, error: Error?) {
-        Task { @MainActor in
-            errorMessage = "Audio playback error: \(error?.localizedDescription ?? "Unknown error")"
-            isSpeaking = false
-            isPaused = false
-            elapsedTime = 0.0
-            playbackStartDate = nil
-            
-            // Cancel elapsed time timer
-            stopElapsedTimeTracking()
-        }
+    private func resetSegments() {
+        pageQueue?.cancel()
+        pageQueue = nil
+        segmentTexts = []
+        preparedSegments = [:]
+        scheduledSegments = []
+        completedSegmentCount = 0
+        playingSegment = nil
     }
 }
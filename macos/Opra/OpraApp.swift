@@ -12,8 +12,34 @@ struct OpraApp: App {
     var body: some Scene {
         WindowGroup {
             ContentView()
+                .onAppear {
+                    // The next pass of the run loop starts after the first frame is committed
+                    DispatchQueue.main.async {
+                        Self.reportLaunch()
+                    }
+                }
         }
         .windowStyle(.hiddenTitleBar)
         .windowResizability(.contentSize)
     }
+    
+    private static var hasReportedLaunch = false
+    
+    /// Logs the time to an interactive window for the first window. With
+    /// `LaunchTiming.measureArgument`, also writes it to the file that follows and quits.
+    private static func reportLaunch() {
+        guard !hasReportedLaunch, let elapsed = LaunchTiming.sinceProcessStart else { return }
+        hasReportedLaunch = true
+        Log.launch.info("Interactive \(Int(elapsed * 1000)) ms after the process started")
+        
+        let arguments = ProcessInfo.processInfo.arguments
+        guard let flag = arguments.firstIndex(of: LaunchTiming.measureArgument), flag + 1 < arguments.count else { return }
+        let outputURL = URL(fileURLWithPath: arguments[flag + 1])
+        do {
+            try Data(String(elapsed * 1000).utf8).write(to: outputURL)
+        } catch {
+            Log.launch.error("Could not write the launch time: \(error.localizedDescription, privacy: .public)")
+        }
+        NSApplication.shared.terminate(nil)
+    }
 }
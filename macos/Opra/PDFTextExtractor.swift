@@ -7,26 +7,118 @@
 
 import Foundation
 import PDFKit
+import os
+
+/// A place in the document to read from. Pages are 1-based; paragraphs and words count from the
+/// start of the selected range. Page positions don't depend on the selection or the chunking, so
+/// they are what gets saved when reading stops.
+enum ReadingPosition: Codable, Equatable {
+    case page(Int, word: Int = 0) // word of that page's text
+    case paragraph(Int)
+    case word(Int)
+}
+
+/// A reading position resolved against the assembled text: the chunks to speak, with the first
+/// one starting at the position, and how many words of that chunk were skipped.
+struct ReadingLocation {
+    let chunks: [TextRange]
+    let chunk: Int
+    let word: Int
+    let page: Int
+}
+
+/// A document opened, extracted and chunked ahead of time by `PDFTextExtractor.prepareDocument`,
+/// ready for `PDFTextExtractor.open(_:)`
+struct PreparedDocument {
+    let url: URL
+    fileprivate let pdfDocument: PDFDocument
+    fileprivate let pageStore: DocumentTextCache
+    fileprivate let recognizer: PageRecognizer
+    fileprivate let text: TextStore
+    fileprivate let chunkRanges: [Range<Int>]
+    fileprivate let chunkTargetLength: Int
+    
+    /// The text reading starts with once the document is open: its first chunk, or all of its
+    /// text when it fits in one
+    var openingText: TextRange {
+        return chunkRanges.count > 1 ? text[chunkRanges[0]] : text.all
+    }
+}
+
+/// The word being spoken in the extractor's text. It moves with every word, so it is kept out of
+/// `PDFTextExtractor`, whose changes re-render the whole window; only the text panel's highlight
+/// and caption observe it.
+final class SpokenWordHighlight: ObservableObject {
+    @Published private(set) var range: NSRange? // UTF-16 range in `PDFTextExtractor.extractedText`
+
+    func update(_ range: NSRange?) {
+        if self.range != range {
+            self.range = range
+        }
+    }
+}
 
 class PDFTextExtractor: ObservableObject {
-    @Published var extractedText: String = ""
+    @Published var extractedText: String = "" {
+        didSet {
+            words = WordIndex(extractedText)
+            spokenWord.update(nil)
+        }
+    }
     @Published var isProcessing: Bool = false
     @Published var errorMessage: String?
     @Published var totalPages: Int = 0
-    @Published var currentPage: Int = 1
+    @Published var currentPage: Int = 1 {
+        didSet {
+            // In windowed mode the text follows the reading position, unless that would cut off
+            // pages being streamed to speech
+            if isReadyToRead && !isStreamingPages && pageWindowNeedsUpdate {
+                extractTextFromPages()
+            }
+            if isReadyToRead && currentPage != oldValue {
+                scheduleRecognition()
+            }
+        }
+    }
     @Published var startPage: Int = 1
     @Published var endPage: Int = 1
     @Published var isReadyToRead: Bool = false
     @Published var isChunked: Bool = false
     @Published var currentChunk: Int = 0
     @Published var totalChunks: Int = 0
-    @Published var chunkedTexts: [String] = []
-    @Published var currentWordIndex: Int = 0
-    @Published var highlightedWord: String = ""
+    @Published var chunkedTexts: [TextRange] = []
+    let spokenWord = SpokenWordHighlight()
+    
+    // Word offsets of extractedText, rebuilt once whenever the text changes
+    private(set) var words = WordIndex.empty
     
-    private var pdfDocument: PDFDocument?
+    @Published private var pdfDocument: PDFDocument?
     private var settingsManager: SettingsManager?
     private var extractionWorkItem: DispatchWorkItem?
+    // Text of every page extracted so far; range changes are served from here
+    private var pageStore: DocumentTextCache?
+    // OCR for pages of the open document without a text layer
+    private var pageRecognizer: PageRecognizer?
+    // Search over every page of the open document, filled in the background
+    @Published private(set) var searchIndex: SearchIndex?
+    private var indexingWorkItem: DispatchWorkItem?
+    private static let indexingBatchSize = 100
+    
+    // Text of the range that was last applied, kept so range changes only touch what changed
+    private var assembled = TextStore()
+    private var chunkRanges: [Range<Int>] = [] // UTF-8 range of each chunk in the assembled text
+    private var chunkTargetLength = 0
+    private var recognizedPages: Set<Int> = [] // recognized in the background, not spliced in yet
+    private static let recognitionSpliceDelay: TimeInterval = 1.0
+    
+    // Where reading stopped last time; the next start of reading picks up from here
+    private var resumePosition: ReadingPosition?
+    
+    // Windowed loading: only the pages within `pageWindowRadius` of the reading position are
+    // extracted and assembled, and the document is reopened whenever the window moves so PDFKit
+    // drops the pages it materialized outside it
+    private var pageWindow: (center: Int, pages: Range<Int>)?
+    private var isStreamingPages = false
     
     var pdfDocumentForViewing: PDFDocument? {
         return pdfDocument
@@ -40,6 +132,7 @@ class PDFTextExtractor: ObservableObject {
         isProcessing = true
         errorMessage = nil
         extractedText = ""
+        let mode = extractionMode
         
         DispatchQueue.global(qos: .userInitiated).async {
             // Start accessing the security-scoped resource
@@ -86,180 +179,825 @@ class PDFTextExtractor: ObservableObject {
                 return
             }
             
+            let pageStore = Self.pageStore(for: url, pageCount: pdfDocument.pageCount, mode: mode)
+            Log.extraction.info("\(pageStore.cachedPageCount) of \(pdfDocument.pageCount) pages already in the extraction cache")
+            
+            let pageRecognizer = PageRecognizer(document: pdfDocument, store: pageStore)
+            
             DispatchQueue.main.async {
-                self.pdfDocument = pdfDocument
-                self.totalPages = pdfDocument.pageCount
-                self.startPage = 1
-                self.endPage = pdfDocument.pageCount
-                self.currentPage = 1
-                self.isReadyToRead = true
+                self.install(pdfDocument, pageStore: pageStore, recognizer: pageRecognizer)
+                self.extractTextFromPages()
             }
-            
-            self.extractTextFromPages()
         }
     }
     
+    /// Shows a document the reading queue prepared in the background. Its text is taken over as
+    /// it was assembled and chunked there, so opening it extracts and chunks nothing, unless the
+    /// chunk size changed in the meantime or the selection needs pages it doesn't have.
+    func open(_ prepared: PreparedDocument) {
+        guard prepared.pageStore.mode == extractionMode else {
+            // Prepared before the extraction mode changed
+            extractText(from: prepared.url)
+            return
+        }
+        errorMessage = nil
+        extractedText = ""
+        install(prepared.pdfDocument, pageStore: prepared.pageStore, recognizer: prepared.recognizer)
+        if prepared.chunkTargetLength == currentChunker.targetLength {
+            assembled = prepared.text
+            chunkRanges = prepared.chunkRanges
+            chunkTargetLength = prepared.chunkTargetLength
+        }
+        extractTextFromPages()
+    }
+    
+    /// Makes `pdfDocument` the open document, with the whole of it selected and nothing assembled
+    private func install(_ pdfDocument: PDFDocument, pageStore: DocumentTextCache, recognizer pageRecognizer: PageRecognizer) {
+        self.pageRecognizer?.cancel()
+        pageRecognizer.onRecognized = { [weak self] pageIndex in
+            self?.insertRecognizedPage(pageIndex)
+        }
+        self.pdfDocument = pdfDocument
+        self.pageStore = pageStore
+        self.pageRecognizer = pageRecognizer
+        searchIndex = pageStore.searchIndex()
+        indexRemainingPages()
+        resumePosition = pageStore.key.flatMap { settingsManager?.readingPosition(forDocument: $0.contentHash) }
+        pageWindow = nil
+        resetAssembledText()
+        currentChunk = 0
+        totalPages = pdfDocument.pageCount
+        startPage = 1
+        endPage = pdfDocument.pageCount
+        currentPage = 1
+        isReadyToRead = true
+    }
+    
+    /// Brings the text in line with `startPage...endPage`.
+    ///
+    /// Pages already in the page store are never extracted again, so moving the end page from 300
+    /// to 301 extracts one page. When every selected page is already stored the range is applied
+    /// right away on the calling (main) thread.
     func extractTextFromPages() {
-        guard let pdfDocument = pdfDocument else { return }
+        updatePageWindow()
+        guard let pdfDocument = pdfDocument, let pageStore = pageStore else { return }
         
         // Cancel any pending extraction
         extractionWorkItem?.cancel()
-        
-        isProcessing = true
+        extractionWorkItem = nil
+        isStreamingPages = false
         errorMessage = nil
-        extractedText = ""
         
-        print("=== STARTING TEXT EXTRACTION ===")
-        print("Page range: \(startPage)-\(endPage)")
-        print("Current chunking state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
+        let pageRange = assemblyRange
+        let window = pageWindow?.pages
+        let missingPages = pageRange.filter { pageStore.page(at: $0) == nil }
+        
+        Log.extraction.debug("Pages \(self.startPage)-\(self.endPage): \(missingPages.count) of \(pageRange.count) to extract")
         
-        // Create a new work item with debouncing
+        guard !missingPages.isEmpty else {
+            applySelectedRange()
+            return
+        }
+        
+        isProcessing = true
+        let workers = max(1, settingsManager?.extractionConcurrency ?? 1)
+        
+        // Create a new work item with debouncing. The weak reference lets the running block see
+        // its own cancellation without the work item retaining itself.
+        weak var weakWorkItem: DispatchWorkItem?
         let workItem = DispatchWorkItem { [weak self] in
-            guard let self = self else { return }
+            let isCancelled = { weakWorkItem?.isCancelled ?? true }
             
-            var fullText = ""
-            let startIndex = max(0, self.startPage - 1)
-            let endIndex = min(pdfDocument.pageCount, self.endPage)
+            Self.extractPages(missingPages, from: pdfDocument, workers: workers, into: pageStore, isCancelled: isCancelled)
+            guard !isCancelled() else { return }
             
-            print("Extracting pages \(startIndex + 1) to \(endIndex)")
+            if let window = window {
+                pageStore.releasePages(outside: window)
+            } else {
+                pageStore.save()
+            }
             
-            for pageIndex in startIndex..<endIndex {
-                guard let page = pdfDocument.page(at: pageIndex) else { 
-                    print("Warning: Could not access page \(pageIndex + 1)")
-                    continue 
+            DispatchQueue.main.async {
+                // A newer range change owns the text now
+                guard let self = self, !isCancelled() else { return }
+                self.applySelectedRange()
+            }
+        }
+        
+        weakWorkItem = workItem
+        extractionWorkItem = workItem
+        DispatchQueue.global(qos: .userInitiated).asyncAfter(deadline: .now() + 0.1, execute: workItem)
+    }
+    
+    /// Extracts the selected pages in reading order and hands each one to the returned queue as soon
+    /// as it is ready, so speech can start after the first page instead of after the whole range.
+    ///
+    /// The queue is bounded: extraction pauses while the speech side is `capacity` pages behind.
+    /// The range is still applied once every page is stored, and extraction keeps going (without
+    /// streaming) if the consumer cancels the queue. With a `start` position the stream begins at
+    /// its page, and mid-page at its word.
+    func streamPages(from start: ReadingPosition? = nil, capacity: Int = 4) -> ExtractedPageQueue {
+        let queue = ExtractedPageQueue(capacity: capacity)
+        guard let pdfDocument = pdfDocument, let pageStore = pageStore else {
+            queue.finish()
+            return queue
+        }
+        
+        // Streaming replaces any extraction that is still running for this range
+        extractionWorkItem?.cancel()
+        
+        isStreamingPages = true
+        isProcessing = true
+        errorMessage = nil
+        
+        var pageRange = selectedPageRange
+        var firstWord = 0
+        if let start = start.flatMap({ pagePosition(of: $0) }), case let .page(page, word) = start, pageRange.contains(page - 1) {
+            pageRange = (page - 1)..<pageRange.upperBound
+            firstWord = word
+        }
+        let windowSpan = pageWindow.map { $0.pages.count }
+        let recognizer = activeRecognizer
+        Log.extraction.debug("Streaming pages \(pageRange.lowerBound + 1)-\(self.endPage)")
+        
+        weak var weakWorkItem: DispatchWorkItem?
+        let workItem = DispatchWorkItem { [weak self] in
+            let isCancelled = { weakWorkItem?.isCancelled ?? true }
+            var isStreaming = true
+            var hasDeliveredFirstPage = false
+            // A windowed stream reads from its own copy of the document, never the viewer's
+            var document = windowSpan == nil ? pdfDocument : Self.reopened(pdfDocument)
+            var extractedPages = 0
+            PipelineMetrics.shared.extractionStarted(pages: pageRange.count)
+            defer { PipelineMetrics.shared.extractionEnded(pages: pageRange.count, extracted: extractedPages) }
+            
+            for pageIndex in pageRange {
+                if isCancelled() {
+                    queue.cancel()
+                    return
                 }
-                if let pageText = page.string {
-                    print("Page \(pageIndex + 1): Extracted \(pageText.count) characters")
-                    fullText += "--- Page \(pageIndex + 1) ---\n"
-                    fullText += pageText + "\n\n"
-                } else {
-                    print("Warning: No text found on page \(pageIndex + 1)")
+                Self.advanceWindow(at: pageIndex, from: pageRange.lowerBound, span: windowSpan, document: &document, store: pageStore)
+                let pageState = Signpost.extraction.beginInterval("Extract page", id: Signpost.extraction.makeSignpostID(), "page \(pageIndex + 1)")
+                let extractedText = Self.pageText(at: pageIndex, in: document, store: pageStore, recognizer: recognizer)
+                Signpost.extraction.endInterval("Extract page", pageState)
+                extractedPages += 1
+                PipelineMetrics.shared.pageExtracted()
+                guard let pageText = extractedText,
+                      isStreaming,
+                      !pageText.trimmingCharacters(in: .whitespacesAndNewlines).isEmpty else {
+                    continue
+                }
+                var page = ExtractedPage(pageNumber: pageIndex + 1, text: pageText)
+                if pageIndex == pageRange.lowerBound && firstWord > 0 {
+                    let words = WordIndex(pageText)
+                    if firstWord < words.count, let range = Range(words.range(at: firstWord), in: pageText) {
+                        page = ExtractedPage(pageNumber: pageIndex + 1, text: String(pageText[range.lowerBound...]), firstWord: firstWord)
+                    }
+                }
+                isStreaming = queue.push(page, shouldStop: isCancelled)
+                
+                if isStreaming && !hasDeliveredFirstPage {
+                    hasDeliveredFirstPage = true
+                    // Playback can start now; the rest of the range keeps extracting in the background
+                    DispatchQueue.main.async {
+                        self?.isProcessing = false
+                    }
                 }
             }
+            queue.finish()
             
+            guard !isCancelled() else { return }
+            pageStore.save()
             DispatchQueue.main.async {
-                print("Text extraction completed, processing...")
-                self.processExtractedText(fullText)
-                
-                // Debug information
-                print("Text extraction completed:")
-                print("- Pages processed: \(startIndex + 1) to \(endIndex)")
-                print("- Total characters: \(fullText.count)")
-                print("- Total words: \(fullText.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }.count)")
-                print("- First 200 characters: \(String(fullText.prefix(200)))")
-                if fullText.count > 200 {
-                    print("- Last 200 characters: \(String(fullText.suffix(200)))")
+                guard let self = self, !isCancelled() else { return }
+                self.isStreamingPages = false
+                if windowSpan != nil {
+                    self.extractTextFromPages() // Pages of the window may have been released while streaming
+                } else {
+                    self.applySelectedRange()
                 }
             }
         }
         
+        weakWorkItem = workItem
         extractionWorkItem = workItem
-        DispatchQueue.global(qos: .userInitiated).asyncAfter(deadline: .now() + 0.1, execute: workItem)
+        DispatchQueue.global(qos: .userInitiated).async(execute: workItem)
+        return queue
     }
     
-    private func processExtractedText(_ text: String) {
-        let words = text.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }
-        let wordCount = words.count
-        let chunkSize = settingsManager?.chunkSize ?? 10000
-        
-        print("=== PROCESSING EXTRACTED TEXT ===")
-        print("Word count: \(wordCount)")
-        print("Chunk size: \(chunkSize)")
-        print("Current isChunked: \(isChunked)")
-        print("Current totalChunks: \(totalChunks)")
-        print("Pages: \(startPage)-\(endPage)")
-        
-        // Always process chunking for the current text selection
-        // This ensures that when user selects a page range, we chunk that specific range
-        if wordCount > chunkSize {
-            // Text is too large, need to chunk it
-            print("Text is large enough to chunk")
-            isChunked = true
-            chunkedTexts = createTextChunks(text: text, words: words, chunkSize: chunkSize)
-            totalChunks = chunkedTexts.count
-            currentChunk = 0
-            extractedText = chunkedTexts.first ?? ""
-            
-            print("Text chunked into \(totalChunks) chunks of max \(chunkSize) words each")
-            print("Ready for TTS: Pages \(startPage)-\(endPage), \(wordCount) words total")
-            print("Final state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        } else if wordCount > 100 { // Only reset if we have substantial text
-            // Text is small enough, no chunking needed
-            print("Text is too small to chunk but substantial enough to reset state")
-            isChunked = false
-            chunkedTexts = []
-            totalChunks = 0
-            currentChunk = 0
-            extractedText = text
+    /// Streams every page of the document for exporting. Unlike `streamPages`, this leaves the
+    /// selected range and any running extraction alone; pages already cached are not re-extracted.
+    func streamDocumentPages(capacity: Int = 4) -> ExtractedPageQueue {
+        guard let pdfDocument = pdfDocument, let pageStore = pageStore else {
+            let queue = ExtractedPageQueue(capacity: capacity)
+            queue.finish()
+            return queue
+        }
+        let windowSpan = pageWindow.map { $0.pages.count }
+        return Self.streamPages(of: windowSpan == nil ? pdfDocument : Self.reopened(pdfDocument), store: pageStore, recognizer: activeRecognizer, capacity: capacity, windowSpan: windowSpan)
+    }
+    
+    /// Opens the PDF at `url` and streams all of its pages, without touching any extractor state.
+    /// Pages without a text layer are recognized with OCR. Used by the command-line converter;
+    /// returns nil if the file is not a PDF with pages.
+    static func streamDocumentPages(at url: URL, capacity: Int = 4, mode: ExtractionMode = .plain) -> (pageCount: Int, pages: ExtractedPageQueue)? {
+        guard let pdfDocument = PDFDocument(url: url), pdfDocument.pageCount > 0 else {
+            return nil
+        }
+        
+        let pageStore = Self.pageStore(for: url, pageCount: pdfDocument.pageCount, mode: mode)
+        let recognizer = PageRecognizer(document: pdfDocument, store: pageStore)
+        return (pdfDocument.pageCount, streamPages(of: pdfDocument, store: pageStore, recognizer: recognizer, capacity: capacity))
+    }
+    
+    /// Extracts every page of the PDF at `url` with `workers` threads, bypassing the on-disk cache,
+    /// and recognizes pages without a text layer unless `recognizesText` is false. Used to measure
+    /// extraction; returns nil if the file is not a PDF with pages.
+    static func extractDocument(at url: URL, workers: Int, recognizesText: Bool = true, mode: ExtractionMode = .plain) -> [String?]? {
+        guard let pdfDocument = PDFDocument(url: url), pdfDocument.pageCount > 0 else {
+            return nil
+        }
+        
+        let pageCount = pdfDocument.pageCount
+        let pageStore = DocumentTextCache(key: nil, pageCount: pageCount, fileURL: nil, mode: mode)
+        extractPages(Array(0..<pageCount), from: pdfDocument, workers: workers, into: pageStore, isCancelled: { false })
+        
+        let recognizer = recognizesText ? PageRecognizer(document: pdfDocument, store: pageStore) : nil
+        return (0..<pageCount).map { pageIndex in
+            pageText(at: pageIndex, in: pdfDocument, store: pageStore, recognizer: recognizer)
+        }
+    }
+    
+    /// Opens the PDF at `url`, extracts its first `pageLimit` pages (all of them without a limit)
+    /// on the calling thread and assembles and chunks their text with `chunker`, the way `open(_:)`
+    /// expects it. Pages run one at a time and go through the on-disk cache, and pages without a
+    /// text layer are left for the recognizer of the open document. Returns nil if the file is not
+    /// a PDF with pages or `isCancelled` reports cancellation.
+    static func prepareDocument(at url: URL, chunker: TextChunker, pageLimit: Int? = nil, mode: ExtractionMode = .plain, isCancelled: () -> Bool) -> PreparedDocument? {
+        guard let pdfDocument = PDFDocument(url: url), pdfDocument.pageCount > 0 else {
+            return nil
+        }
+        
+        let pageCount = pdfDocument.pageCount
+        let pageStore = Self.pageStore(for: url, pageCount: pageCount, mode: mode)
+        let pages = 0..<min(pageCount, max(1, pageLimit ?? pageCount))
+        let missingPages = pages.filter { pageStore.page(at: $0) == nil }
+        if !missingPages.isEmpty {
+            extractPages(missingPages, from: pdfDocument, workers: 1, into: pageStore, isCancelled: isCancelled)
+            guard !isCancelled() else { return nil }
+            pageStore.save()
+        }
+        
+        var builder = TextStore.Builder(firstPage: pages.lowerBound)
+        for pageIndex in pages {
+            builder.appendPage(pageStore.page(at: pageIndex)?.text.map { assembledPage(pageIndex, text: $0) } ?? "")
+        }
+        let text = builder.finish()
+        let chunkRanges = text.withBytes { chunker.chunkRanges(in: $0) }
+        guard !isCancelled() else { return nil }
+        
+        Log.extraction.debug("Prepared \(url.lastPathComponent, privacy: .public): \(pages.count) pages, \(chunkRanges.count) chunks")
+        return PreparedDocument(url: url, pdfDocument: pdfDocument, pageStore: pageStore,
+                                recognizer: PageRecognizer(document: pdfDocument, store: pageStore),
+                                text: text, chunkRanges: chunkRanges, chunkTargetLength: chunker.targetLength)
+    }
+    
+    private static func streamPages(of pdfDocument: PDFDocument, store pageStore: DocumentTextCache, recognizer: PageRecognizer?, capacity: Int, windowSpan: Int? = nil) -> ExtractedPageQueue {
+        let queue = ExtractedPageQueue(capacity: capacity)
+        let pageCount = pdfDocument.pageCount
+        DispatchQueue.global(qos: .utility).async {
+            var document = pdfDocument
+            var extractedPages = 0
+            PipelineMetrics.shared.extractionStarted(pages: pageCount)
+            defer { PipelineMetrics.shared.extractionEnded(pages: pageCount, extracted: extractedPages) }
+            for pageIndex in 0..<pageCount {
+                Self.advanceWindow(at: pageIndex, from: 0, span: windowSpan, document: &document, store: pageStore)
+                let extractedText = Self.pageText(at: pageIndex, in: document, store: pageStore, recognizer: recognizer)
+                extractedPages += 1
+                PipelineMetrics.shared.pageExtracted()
+                guard let pageText = extractedText,
+                      !pageText.trimmingCharacters(in: .whitespacesAndNewlines).isEmpty else {
+                    continue
+                }
+                guard queue.push(ExtractedPage(pageNumber: pageIndex + 1, text: pageText)) else {
+                    return // Export cancelled
+                }
+            }
+            queue.finish()
+            pageStore.save()
+        }
+        return queue
+    }
+    
+    /// Previously extracted pages of the file at `url` are reused from the on-disk cache. Files that
+    /// can't be hashed still get an in-memory store for the lifetime of the document.
+    private static func pageStore(for url: URL, pageCount: Int, mode: ExtractionMode) -> DocumentTextCache {
+        return ExtractionCache.shared.key(for: url).map {
+            ExtractionCache.shared.document(for: $0, pageCount: pageCount, mode: mode)
+        } ?? DocumentTextCache(key: nil, pageCount: pageCount, fileURL: nil, mode: mode)
+    }
+    
+    private var extractionMode: ExtractionMode {
+        return (settingsManager?.enableLayoutExtraction ?? false) ? .layout : .plain
+    }
+    
+    /// Zero-based indices of the selected pages
+    private var selectedPageRange: Range<Int> {
+        let lower = max(0, startPage - 1)
+        return lower..<max(lower, min(totalPages, endPage))
+    }
+    
+    // MARK: - Windowed Loading
+    
+    /// True while only a window of pages around the reading position is loaded. Reading then
+    /// has to stream, because the assembled text covers only the window.
+    var isWindowed: Bool {
+        return pageWindow != nil
+    }
+    
+    private var isWindowedLoadingEnabled: Bool {
+        return settingsManager?.enableWindowedLoading ?? false
+    }
+    
+    /// Zero-based pages assembled into the text: the selection, narrowed to the window when windowed
+    private var assemblyRange: Range<Int> {
+        guard let window = pageWindow else { return selectedPageRange }
+        return selectedPageRange.clamped(to: window.pages)
+    }
+    
+    /// Zero-based reading position, kept inside the selection
+    private var readingPageIndex: Int {
+        let selection = selectedPageRange
+        return min(max(currentPage - 1, selection.lowerBound), max(selection.lowerBound, selection.upperBound - 1))
+    }
+    
+    /// The window is recentered once the reading position is more than half a radius off center
+    private var pageWindowNeedsUpdate: Bool {
+        guard isWindowedLoadingEnabled else { return pageWindow != nil }
+        guard let window = pageWindow else { return true }
+        return abs(readingPageIndex - window.center) > max(1, (settingsManager?.pageWindowRadius ?? 10) / 2)
+    }
+    
+    private func updatePageWindow() {
+        guard pageWindowNeedsUpdate else { return }
+        guard isWindowedLoadingEnabled else {
+            pageWindow = nil
+            return
+        }
+        
+        let hadWindow = pageWindow != nil
+        let center = readingPageIndex
+        let radius = max(1, settingsManager?.pageWindowRadius ?? 10)
+        let pages = max(0, center - radius)..<min(totalPages, center + radius + 1)
+        pageWindow = (center, pages)
+        Log.extraction.debug("Page window moved to pages \(pages.lowerBound + 1)-\(pages.upperBound)")
+        
+        if hadWindow, let pdfDocument = pdfDocument {
+            // The viewer picks the fresh document up and stays on the current page
+            self.pdfDocument = Self.reopened(pdfDocument)
+        }
+    }
+    
+    /// A fresh copy of `document` with no pages materialized, or `document` if it can't be reopened
+    private static func reopened(_ document: PDFDocument) -> PDFDocument {
+        return document.documentURL.flatMap { PDFDocument(url: $0) } ?? document
+    }
+    
+    /// Called before each page of a windowed stream. Every `span` pages the stream switches to a
+    /// fresh copy of the document, so PDFKit holds at most one window of pages, and the text of
+    /// pages that were left behind is released.
+    private static func advanceWindow(at pageIndex: Int, from firstPage: Int, span: Int?, document: inout PDFDocument, store: DocumentTextCache) {
+        guard let span = span, pageIndex > firstPage, (pageIndex - firstPage) % span == 0 else { return }
+        document = reopened(document)
+        store.releasePages(outside: pageIndex..<(pageIndex + span))
+    }
+    
+    /// Extracts `pageIndices` into `store` with up to `workers` threads, stopping early if
+    /// `isCancelled` reports cancellation.
+    private static func extractPages(_ pageIndices: [Int], from pdfDocument: PDFDocument, workers: Int, into store: DocumentTextCache, isCancelled: () -> Bool) {
+        let state = Signpost.extraction.beginInterval("Extract pages", id: Signpost.extraction.makeSignpostID(), "\(pageIndices.count) pages, \(workers) workers")
+        defer { Signpost.extraction.endInterval("Extract pages", state) }
+        PipelineMetrics.shared.extractionStarted(pages: pageIndices.count)
+        
+        guard workers > 1 && pageIndices.count > 1 else {
+            var emptyPages = 0
+            var extractedPages = 0
+            for pageIndex in pageIndices where !isCancelled() {
+                emptyPages += pageText(at: pageIndex, in: pdfDocument, store: store) == nil ? 1 : 0
+                extractedPages += 1
+                PipelineMetrics.shared.pageExtracted()
+            }
+            PipelineMetrics.shared.extractionEnded(pages: pageIndices.count, extracted: extractedPages)
+            if emptyPages > 0 {
+                Log.extraction.notice("No text layer on \(emptyPages) of \(pageIndices.count) pages")
+            }
+            return
+        }
+        
+        var texts = [String?](repeating: nil, count: pageIndices.count)
+        let extractedPages = extractPagesConcurrently(pageIndices, into: &texts, from: pdfDocument, layout: store.pageLayout, workers: workers, isCancelled: isCancelled)
+        PipelineMetrics.shared.extractionEnded(pages: pageIndices.count, extracted: extractedPages)
+        guard !isCancelled() else { return }
+        
+        for (slot, pageIndex) in pageIndices.enumerated() {
+            store.store(texts[slot], forPage: pageIndex)
+        }
+        
+        let emptyPages = texts.lazy.filter { $0 == nil }.count
+        if emptyPages > 0 {
+            Log.extraction.notice("No text layer on \(emptyPages) of \(pageIndices.count) pages")
+        }
+    }
+    
+    /// PDFKit documents are not safe to share between threads, so every worker opens its own
+    /// `PDFDocument` on the same file and pulls small page shards from a shared cursor. Each page's
+    /// text lands in a slot indexed by position in `pageIndices`, so no worker ever touches another
+    /// worker's output. Returns the number of pages extracted, fewer than requested if cancelled.
+    private static func extractPagesConcurrently(_ pageIndices: [Int], into texts: inout [String?], from pdfDocument: PDFDocument, layout: PageLayout?, workers: Int, isCancelled: () -> Bool) -> Int {
+        let workerCount = min(workers, pageIndices.count)
+        // Several shards per worker so a few expensive pages don't leave the other workers idle
+        let shardSize = max(1, pageIndices.count / (workerCount * 4))
+        let shardCount = (pageIndices.count + shardSize - 1) / shardSize
+        
+        var nextShard = 0
+        var extractedPages = 0
+        let cursorLock = NSLock()
+        // Serializes access to the shared document for workers that could not open their own copy
+        let sharedDocumentLock = NSLock()
+        
+        texts.withUnsafeMutableBufferPointer { buffer in
+            DispatchQueue.concurrentPerform(iterations: workerCount) { _ in
+                let workerDocument = pdfDocument.documentURL.flatMap { PDFDocument(url: $0) }
+                
+                while !isCancelled() {
+                    cursorLock.lock()
+                    let shard = nextShard
+                    nextShard += 1
+                    cursorLock.unlock()
+                    guard shard < shardCount else { break }
+                    
+                    let lower = shard * shardSize
+                    let upper = min(pageIndices.count, lower + shardSize)
+                    for slot in lower..<upper {
+                        autoreleasepool {
+                            if let workerDocument = workerDocument {
+                                buffer[slot] = extractedText(ofPage: pageIndices[slot], in: workerDocument, layout: layout)
+                            } else {
+                                sharedDocumentLock.lock()
+                                buffer[slot] = extractedText(ofPage: pageIndices[slot], in: pdfDocument, layout: layout)
+                                sharedDocumentLock.unlock()
+                            }
+                        }
+                        PipelineMetrics.shared.pageExtracted()
+                    }
+                    
+                    cursorLock.lock()
+                    extractedPages += upper - lower
+                    cursorLock.unlock()
+                }
+            }
+        }
+        return extractedPages
+    }
+    
+    /// Returns the page's text from the page store, extracting and storing it on a miss. Pages
+    /// without a text layer go through `recognizer` when there is one.
+    private static func pageText(at pageIndex: Int, in pdfDocument: PDFDocument, store: DocumentTextCache, recognizer: PageRecognizer? = nil) -> String? {
+        if let stored = store.page(at: pageIndex) {
+            guard stored.state == .empty, let recognizer = recognizer else { return stored.text }
+            return recognizer.text(forPage: pageIndex)
+        }
+        let text = autoreleasepool { extractedText(ofPage: pageIndex, in: pdfDocument, layout: store.pageLayout) }
+        store.store(text, forPage: pageIndex)
+        if text == nil, let recognizer = recognizer {
+            return recognizer.text(forPage: pageIndex)
+        }
+        return text
+    }
+    
+    /// The page's text read from the PDF itself, in reading order with `layout`
+    private static func extractedText(ofPage pageIndex: Int, in pdfDocument: PDFDocument, layout: PageLayout?) -> String? {
+        if let layout = layout {
+            return layout.text(ofPage: pageIndex, in: pdfDocument)
+        }
+        return pdfDocument.page(at: pageIndex)?.string
+    }
+    
+    // MARK: - Search
+    
+    /// Text of a page (1-based) as it was stored, or nil if it isn't extracted yet or has none
+    func pageText(_ page: Int) -> String? {
+        return pageStore?.page(at: page - 1)?.text
+    }
+    
+    /// Extracts the pages nobody asked for yet on a utility thread, so the search index covers the
+    /// whole document and not just the selection. Every `indexingBatchSize` pages the new pages are
+    /// appended to the cache file and the document is reopened, which keeps both the pending text
+    /// and PDFKit's page cache small; the search index is written once, when the pages are done or
+    /// the work is cancelled.
+    /// Skipped for windowed documents without a cache file, whose pages couldn't be let go of.
+    private func indexRemainingPages() {
+        indexingWorkItem?.cancel()
+        indexingWorkItem = nil
+        guard let pdfDocument = pdfDocument, let pageStore = pageStore,
+              pageStore.fileURL != nil || !isWindowedLoadingEnabled else { return }
+        
+        weak var weakWorkItem: DispatchWorkItem?
+        let workItem = DispatchWorkItem {
+            let isCancelled = { weakWorkItem?.isCancelled ?? true }
+            let missingPages = (0..<pageStore.pageCount).filter { pageStore.page(at: $0) == nil }
+            guard !missingPages.isEmpty else { return }
             
-            print("Text ready for TTS: Pages \(startPage)-\(endPage), \(wordCount) words (no chunking needed)")
-            print("Final state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        } else {
-            // Very small text - preserve existing chunking state
-            print("Very small text extraction (\(wordCount) words) - preserving existing chunking state")
-            if isChunked {
-                extractedText = getCurrentChunkText()
-                print("Preserved chunked state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-            } else {
-                extractedText = text
-                print("No existing chunking to preserve")
+            let state = Signpost.extraction.beginInterval("Index pages", id: Signpost.extraction.makeSignpostID(), "\(missingPages.count) pages")
+            defer { Signpost.extraction.endInterval("Index pages", state) }
+            var document = Self.reopened(pdfDocument)
+            for (count, pageIndex) in missingPages.enumerated() where !isCancelled() {
+                if count > 0 && count % Self.indexingBatchSize == 0 {
+                    pageStore.save(includingSearchIndex: false)
+                    document = Self.reopened(document)
+                }
+                _ = Self.pageText(at: pageIndex, in: document, store: pageStore)
             }
+            pageStore.save()
+            Log.extraction.debug("Extracted \(missingPages.count) more pages for search")
+        }
+        weakWorkItem = workItem
+        indexingWorkItem = workItem
+        DispatchQueue.global(qos: .utility).async(execute: workItem)
+    }
+    
+    // MARK: - OCR
+    
+    /// The recognizer for the open document, or nil when OCR is turned off
+    private var activeRecognizer: PageRecognizer? {
+        return (settingsManager?.enableOCR ?? true) ? pageRecognizer : nil
+    }
+    
+    /// Queues OCR for the selected pages without a text layer, starting at the reading position,
+    /// so the pages about to be read are recognized first.
+    private func scheduleRecognition() {
+        guard let recognizer = activeRecognizer else { return }
+        let pageRange = assemblyRange
+        let start = min(max(readingPageIndex, pageRange.lowerBound), pageRange.upperBound)
+        recognizer.schedule(Array(start..<pageRange.upperBound) + Array(pageRange.lowerBound..<start))
+    }
+    
+    /// Queues a page recognized in the background to be spliced into the assembled text. Every
+    /// splice writes a new text store, so pages recognized within `recognitionSpliceDelay` of each
+    /// other go in together.
+    private func insertRecognizedPage(_ pageIndex: Int) {
+        recognizedPages.insert(pageIndex)
+        guard recognizedPages.count == 1 else { return }
+        DispatchQueue.main.asyncAfter(deadline: .now() + Self.recognitionSpliceDelay) { [weak self] in
+            self?.spliceRecognizedPages()
         }
+    }
+    
+    /// Splices the queued recognized pages into the assembled text. Only chunks from the first of
+    /// them on are recomputed.
+    private func spliceRecognizedPages() {
+        let pages = recognizedPages
+        recognizedPages = []
+        let slots = pages.compactMap { pageIndex -> (slot: Int, block: String)? in
+            guard assembled.pageRange.contains(pageIndex),
+                  let pageText = pageStore?.page(at: pageIndex)?.text else { return nil }
+            let slot = pageIndex - assembled.pageRange.lowerBound
+            guard assembled.pageOffsets[slot] == assembled.pageOffsets[slot + 1] else { return nil } // Already assembled with its text
+            return (slot, Self.assembledPage(pageIndex, text: pageText))
+        }.sorted { $0.slot < $1.slot }
+        guard let first = slots.first else { return }
         
-        isProcessing = false
-        print("=== END PROCESSING EXTRACTED TEXT ===")
+        let offset = assembled.pageOffsets[first.slot]
+        var builder = TextStore.Builder(firstPage: assembled.pageRange.lowerBound)
+        var copied = 0
+        for (slot, block) in slots {
+            builder.appendPages(copied..<slot, of: assembled)
+            builder.appendPage(block)
+            copied = slot + 1
+        }
+        builder.appendPages(copied..<assembled.pageRange.count, of: assembled)
+        assembled = builder.finish()
+        Log.recognition.debug("\(slots.count) recognized pages added to the text, from page \(self.assembled.pageRange.lowerBound + first.slot + 1)")
+        rechunk(from: offset)
     }
     
-    private func createTextChunks(text: String, words: [String], chunkSize: Int) -> [String] {
-        var chunks: [String] = []
-        var currentChunk: [String] = []
-        var currentWordCount = 0
+    // MARK: - Seeking
+    
+    /// Resolves `position` against the assembled text, without extracting or rechunking anything.
+    /// Nil while the text isn't assembled, in windowed mode, or if the position is outside the
+    /// selected range.
+    func location(of position: ReadingPosition) -> ReadingLocation? {
+        guard isReadyForTTS(), !isWindowed, let offset = assembledOffset(of: position) else { return nil }
         
-        for word in words {
-            currentChunk.append(word)
-            currentWordCount += 1
+        var chunks = isChunked ? chunkedTexts : [assembled.all]
+        let chunk = isChunked ? chunkIndex(containing: offset) : 0
+        let word = assembled.firstWord(atOrAfter: offset) - assembled.firstWord(atOrAfter: chunks[chunk].bytes.lowerBound)
+        chunks[chunk] = chunks[chunk].suffix(from: offset)
+        return ReadingLocation(chunks: chunks, chunk: chunk, word: max(0, word), page: assembled.pageRange.lowerBound + assembled.pageSlot(containing: offset) + 1)
+    }
+    
+    /// The page position of word `word` of chunk `chunk`, as reported by speech progress
+    func position(ofWord word: Int, inChunk chunk: Int) -> ReadingPosition? {
+        guard assembled.wordCount > 0, chunk >= 0 else { return nil }
+        let chunkStart = isChunked && chunk < chunkRanges.count ? chunkRanges[chunk].lowerBound : 0
+        let target = min(assembled.firstWord(atOrAfter: chunkStart) + max(0, word), assembled.wordCount - 1)
+        return pagePosition(atUTF8Offset: assembled.wordRange(at: target).lowerBound)
+    }
+    
+    /// Remembers where reading stopped, for the next start of reading and the next time this
+    /// document is opened
+    func saveReadingPosition(_ position: ReadingPosition) {
+        resumePosition = position
+        if let key = pageStore?.key {
+            settingsManager?.setReadingPosition(position, forDocument: key.contentHash)
+        }
+    }
+    
+    /// The position reading stopped at, if any. Taking it clears it, so afterwards reading starts
+    /// from the current chunk again until the next stop.
+    func takeResumePosition() -> ReadingPosition? {
+        defer { resumePosition = nil }
+        return resumePosition
+    }
+    
+    /// Shows the chunk a seek landed in
+    func showChunk(_ chunk: Int) {
+        guard isChunked && chunk >= 0 && chunk < totalChunks && chunk != currentChunk else { return }
+        currentChunk = chunk
+        extractedText = chunkedTexts[chunk].string
+    }
+    
+    /// `position` as a page position, resolving paragraphs and words against the assembled text
+    private func pagePosition(of position: ReadingPosition) -> ReadingPosition? {
+        if case .page = position {
+            return position
+        }
+        return assembledOffset(of: position).map { pagePosition(atUTF8Offset: $0) }
+    }
+    
+    private func pagePosition(atUTF8Offset offset: Int) -> ReadingPosition {
+        let slot = assembled.pageSlot(containing: offset)
+        let pageIndex = assembled.pageRange.lowerBound + slot
+        let word = assembled.firstWord(atOrAfter: offset) - assembled.firstWord(atOrAfter: assembled.pageOffsets[slot])
+        return .page(pageIndex + 1, word: max(0, word))
+    }
+    
+    /// UTF-8 offset in the assembled text where `position` starts
+    private func assembledOffset(of position: ReadingPosition) -> Int? {
+        switch position {
+        case let .page(page, word):
+            let slot = page - 1 - assembled.pageRange.lowerBound
+            guard slot >= 0 && slot < assembled.pageOffsets.count - 1 else { return nil }
+            let pageStart = assembled.pageOffsets[slot]
+            let pageEnd = assembled.pageOffsets[slot + 1]
+            guard word > 0 && pageEnd > pageStart else { return pageStart }
             
-            if currentWordCount >= chunkSize {
-                chunks.append(currentChunk.joined(separator: " "))
-                currentChunk = []
-                currentWordCount = 0
+            let target = assembled.firstWord(atOrAfter: pageStart) + word
+            guard target < assembled.wordCount else { return pageStart }
+            let wordOffset = assembled.wordRange(at: target).lowerBound
+            return wordOffset < pageEnd ? wordOffset : pageStart
+        case let .paragraph(index):
+            let paragraphs = assembled.paragraphOffsets
+            guard index >= 0 && index < paragraphs.count else { return nil }
+            return paragraphs[index]
+        case let .word(index):
+            guard index >= 0 && index < assembled.wordCount else { return nil }
+            return assembled.wordRange(at: index).lowerBound
+        }
+    }
+    
+    private func chunkIndex(containing offset: Int) -> Int {
+        var lower = 0
+        var upper = max(0, chunkRanges.count - 1)
+        while lower < upper {
+            let middle = (lower + upper) / 2
+            if chunkRanges[middle].upperBound > offset {
+                upper = middle
+            } else {
+                lower = middle + 1
             }
         }
+        return lower
+    }
+    
+    /// Turns the stored pages of the selected range into `extractedText` and chunks.
+    ///
+    /// The assembled text is kept between range changes: moving the end page appends or truncates
+    /// pages at the end, and only the chunks from the last one touched by the change are recomputed.
+    /// Moving the start page shifts every chunk boundary, so the text is assembled again from the
+    /// store (still without extracting anything). Every selected page must already be stored.
+    private func applySelectedRange() {
+        guard let pageStore = pageStore else { return }
+        let pageRange = assemblyRange
+        let changedOffset: Int
         
-        // Add remaining words as the last chunk
-        if !currentChunk.isEmpty {
-            chunks.append(currentChunk.joined(separator: " "))
+        let state = Signpost.chunking.beginInterval("Assemble text", id: Signpost.chunking.makeSignpostID(), "pages \(pageRange.lowerBound + 1)-\(pageRange.upperBound)")
+        defer { Signpost.chunking.endInterval("Assemble text", state) }
+        
+        let assembledPages = assembled.pageRange
+        if assembledPages.isEmpty || pageRange.lowerBound != assembledPages.lowerBound {
+            resetAssembledText(at: pageRange.lowerBound)
+            appendPages(pageRange, from: pageStore)
+            changedOffset = 0
+            currentChunk = 0
+        } else if pageRange.upperBound > assembledPages.upperBound {
+            changedOffset = assembled.count
+            appendPages(assembledPages.upperBound..<pageRange.upperBound, from: pageStore)
+        } else if pageRange.upperBound < assembledPages.upperBound {
+            // Shares the mapping of the longer text
+            assembled = assembled.prefix(pages: pageRange.count)
+            changedOffset = assembled.count
+        } else {
+            changedOffset = assembled.count
         }
         
-        return chunks
+        rechunk(from: changedOffset)
+        isProcessing = false
+        scheduleRecognition()
+        
+        Log.chunking.debug("Text ready: pages \(self.startPage)-\(self.endPage), \(self.assembled.count) bytes in \(self.totalChunks) chunks")
+    }
+    
+    /// Appends stored pages to the assembled text. The store is immutable, so this writes a new
+    /// one: the pages already assembled are copied through the old mapping, never decoded.
+    private func appendPages(_ pageRange: Range<Int>, from pageStore: DocumentTextCache) {
+        var builder = TextStore.Builder(firstPage: assembled.pageRange.lowerBound)
+        builder.appendPages(0..<assembled.pageRange.count, of: assembled)
+        for pageIndex in pageRange {
+            builder.appendPage(pageStore.page(at: pageIndex)?.text.map { Self.assembledPage(pageIndex, text: $0) } ?? "")
+        }
+        assembled = builder.finish()
+    }
+    
+    /// A page as it appears in the assembled text: its text and a blank line. There is no page
+    /// banner, which would be spoken on every page; `TextStore.pageOffsets` keeps the boundaries.
+    static func assembledPage(_ pageIndex: Int, text: String) -> String {
+        return text + "\n\n"
+    }
+    
+    private func resetAssembledText(at firstPage: Int = 0) {
+        assembled = TextStore(firstPage: firstPage)
+        chunkRanges = []
+    }
+    
+    /// Recomputes the chunks that can be affected by a change at `offset` (a UTF-8 offset into the
+    /// assembled text). A chunk whose whole window lies before the change ends exactly where it did,
+    /// so it is kept as it is.
+    private func rechunk(from offset: Int) {
+        let state = Signpost.chunking.beginInterval("Chunk", id: Signpost.chunking.makeSignpostID(), "from byte \(offset)")
+        defer { Signpost.chunking.endInterval("Chunk", state) }
+        let chunker = currentChunker
+        if chunker.targetLength != chunkTargetLength {
+            // A different target moves every boundary
+            chunkRanges = []
+            chunkTargetLength = chunker.targetLength
+        }
+        
+        let firstStale = chunkRanges.firstIndex { $0.lowerBound + chunker.targetLength >= offset } ?? chunkRanges.count
+        let scanStart = firstStale == 0 ? 0 : chunkRanges[firstStale - 1].upperBound
+        chunkRanges.removeSubrange(firstStale...)
+        
+        chunkRanges += assembled.withBytes { chunker.chunkRanges(in: $0, from: scanStart) }
+        
+        Log.chunking.debug("Rechunked from chunk \(firstStale + 1): \(self.chunkRanges.count) chunks of about \(chunker.targetLength) characters")
+        
+        isChunked = chunkRanges.count > 1
+        // Chunks are ranges of the assembled text rather than copies
+        let text = assembled
+        chunkedTexts = isChunked ? chunkRanges.map { text[$0] } : []
+        totalChunks = isChunked ? chunkedTexts.count : 0
+        currentChunk = isChunked ? min(currentChunk, totalChunks - 1) : 0
+        extractedText = isChunked ? chunkedTexts[currentChunk].string : text.all.string
+    }
+    
+    private var currentChunker: TextChunker {
+        return TextChunker(targetLength: settingsManager?.chunkTargetLength ?? TextChunker.defaultTargetLength)
     }
     
     func nextChunk() {
         guard isChunked && currentChunk < totalChunks - 1 else { return }
+        resumePosition = nil
         currentChunk += 1
-        extractedText = chunkedTexts[currentChunk]
+        extractedText = chunkedTexts[currentChunk].string
     }
     
     func previousChunk() {
         guard isChunked && currentChunk > 0 else { return }
+        resumePosition = nil
         currentChunk -= 1
-        extractedText = chunkedTexts[currentChunk]
+        extractedText = chunkedTexts[currentChunk].string
     }
     
     func getCurrentChunkText() -> String {
         guard isChunked else { return extractedText }
-        return chunkedTexts[currentChunk]
+        return chunkedTexts[currentChunk].string
     }
     
-    var chunkedTextsArray: [String] {
+    var chunkedTextsArray: [TextRange] {
         return self.chunkedTexts
     }
     
     func setPageRange(start: Int, end: Int) {
-        print("=== SET PAGE RANGE ===")
-        print("Setting page range from \(start) to \(end)")
-        print("Previous state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        
         let newStart = max(1, min(start, totalPages))
         let newEnd = max(newStart, min(end, totalPages))
         
@@ -267,23 +1005,14 @@ class PDFTextExtractor: ObservableObject {
         endPage = newEnd
         currentPage = startPage
         
-        // Force complete reset and re-extraction
-        forceCompleteReset()
-        
-        print("=== END SET PAGE RANGE ===")
-        
-        // Force extraction for the new page range
+        // Only pages that were never extracted are extracted for the new range
         extractTextFromPages()
     }
     
     func setStartPage(_ page: Int) {
-        print("=== SET START PAGE ===")
-        print("Setting start page to \(page)")
-        print("Previous state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        print("Current page range: \(startPage)-\(endPage)")
-        
         let newStart = max(1, min(page, totalPages))
         startPage = newStart
+        resumePosition = nil // Reading starts at the chosen page
         
         if endPage < startPage {
             endPage = startPage
@@ -291,60 +1020,17 @@ class PDFTextExtractor: ObservableObject {
         
         currentPage = startPage
         
-        print("New page range: \(startPage)-\(endPage)")
-        
-        // Force complete reset and re-extraction
-        forceCompleteReset()
-        
-        print("=== END SET START PAGE ===")
-        
         extractTextFromPages()
     }
     
-    private func forceCompleteReset() {
-        print("Force complete reset - clearing all state")
-        
-        // Cancel any pending work
-        extractionWorkItem?.cancel()
-        extractionWorkItem = nil
-        
-        // Reset all state
-        isChunked = false
-        chunkedTexts = []
-        totalChunks = 0
-        currentChunk = 0
-        extractedText = ""
-        isProcessing = false
-        errorMessage = nil
-        
-        print("Reset complete - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-    }
-    
     func setEndPage(_ page: Int) {
-        print("=== SET END PAGE ===")
-        print("Setting end page to \(page)")
-        print("Previous state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        
         let newEnd = max(startPage, min(page, totalPages))
         endPage = newEnd
         
-        // Reset chunking state when page range changes
-        isChunked = false
-        chunkedTexts = []
-        totalChunks = 0
-        currentChunk = 0
-        
-        print("Reset chunking state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        print("=== END SET END PAGE ===")
-        
         extractTextFromPages()
     }
     
     func updatePageRange() {
-        print("=== UPDATE PAGE RANGE ===")
-        print("Updating page range")
-        print("Previous state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        
         // Ensure start page is valid
         startPage = max(1, min(startPage, totalPages))
         
@@ -358,15 +1044,6 @@ class PDFTextExtractor: ObservableObject {
             currentPage = endPage
         }
         
-        // Reset chunking state when page range changes
-        isChunked = false
-        chunkedTexts = []
-        totalChunks = 0
-        currentChunk = 0
-        
-        print("Reset chunking state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        print("=== END UPDATE PAGE RANGE ===")
-        
         extractTextFromPages()
     }
     
@@ -374,6 +1051,7 @@ class PDFTextExtractor: ObservableObject {
         // Cancel any pending extraction
         extractionWorkItem?.cancel()
         extractionWorkItem = nil
+        isStreamingPages = false
         
         extractedText = ""
         errorMessage = nil
@@ -387,6 +1065,15 @@ class PDFTextExtractor: ObservableObject {
         totalChunks = 0
         chunkedTexts = []
         pdfDocument = nil
+        pageStore = nil
+        pageRecognizer?.cancel()
+        pageRecognizer = nil
+        indexingWorkItem?.cancel()
+        indexingWorkItem = nil
+        searchIndex = nil
+        resumePosition = nil
+        pageWindow = nil
+        resetAssembledText()
     }
     
     func startReading() {
@@ -396,10 +1083,8 @@ class PDFTextExtractor: ObservableObject {
     }
     
     func forceRechunk() {
-        // Force re-chunking of the current text selection
-        isChunked = false
-        chunkedTexts = []
-        totalChunks = 0
+        // Re-chunk the current selection from scratch; stored pages are not extracted again
+        chunkRanges = []
         currentChunk = 0
         extractTextFromPages()
     }
@@ -409,65 +1094,19 @@ class PDFTextExtractor: ObservableObject {
     }
     
     func ensureChunkingForTTS() {
-        print("=== ENSURING CHUNKING FOR TTS ===")
-        print("Current state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        print("Extracted text length: \(extractedText.count) characters")
-        
-        if !isChunked && !extractedText.isEmpty {
-            let words = extractedText.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }
-            let wordCount = words.count
-            let chunkSize = settingsManager?.chunkSize ?? 10000
-            
-            print("Text not chunked, checking if needs chunking - \(wordCount) words, chunk size: \(chunkSize)")
-            
-            if wordCount > chunkSize {
-                print("Text needs chunking, processing...")
-                processExtractedText(extractedText)
-            } else {
-                print("Text doesn't need chunking")
-            }
-        } else if isChunked {
-            print("Text is already chunked with \(totalChunks) chunks")
-        } else {
-            print("No text to chunk")
+        let targetLength = currentChunker.targetLength
+        if !assembled.isEmpty && targetLength != chunkTargetLength {
+            Log.chunking.debug("Chunk target changed to \(targetLength) characters, rechunking")
+            rechunk(from: 0)
         }
-        
-        print("Final state - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        print("=== END ENSURING CHUNKING FOR TTS ===")
     }
     
-    func updateCurrentWord(_ wordIndex: Int) {
-        currentWordIndex = wordIndex
-        
-        // Get the current text (either chunked or full text)
-        let currentText = getCurrentChunkText()
-        let words = currentText.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }
-        
-        if wordIndex < words.count {
-            highlightedWord = words[wordIndex]
-        } else {
-            highlightedWord = ""
-        }
+    var wordCount: Int {
+        return words.count
     }
     
-    func getHighlightedText() -> AttributedString {
-        let currentText = getCurrentChunkText()
-        let words = currentText.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }
-        
-        var attributedText = AttributedString(currentText)
-        
-        guard currentWordIndex < words.count else { return attributedText }
-        
-        // Find the current word in the text and highlight it
-        let currentWord = words[currentWordIndex]
-        let wordRange = attributedText.range(of: currentWord)
-        
-        if let range = wordRange {
-            attributedText[range].backgroundColor = .blue
-            attributedText[range].foregroundColor = .white
-            attributedText[range].font = .system(.body, design: .monospaced).bold()
-        }
-        
-        return attributedText
+    /// Moves `spokenWord` to the word at `wordIndex` of the current text (chunked or full)
+    func updateCurrentWord(_ wordIndex: Int) {
+        spokenWord.update(wordIndex >= 0 && wordIndex < words.count ? words.range(at: wordIndex) : nil)
     }
 }
@@ -0,0 +1,265 @@
+//
+//  PageLayout.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import PDFKit
+
+/// How the text of a page is taken from the PDF
+enum ExtractionMode: String, CaseIterable {
+    case plain // PDFKit's page string, in the order the PDF draws it
+    case layout // lines in reading order, without running headers, footers and page numbers
+}
+
+/// Layout-aware text of a document's pages, for `ExtractionMode.layout`.
+///
+/// Lines come from PDFKit's line selections, so every line has the bounds of its glyphs. Columns
+/// are found as vertical gutters that narrow lines don't cross, and a page is read column by
+/// column between the lines that span them, such as titles and full-width figures.
+///
+/// Lines in the top or bottom band of a page are dropped when they are page numbers, or when the
+/// same line, with its numbers ignored, is in the same band of a page up to two pages away, which
+/// also catches headers that alternate between even and odd pages. The bands of each page are
+/// kept in a table shared by the extraction workers, so every page is only looked at once however
+/// the pages are split between them. Each worker passes its own document, which is only read from
+/// the calling thread.
+final class PageLayout: @unchecked Sendable {
+    private struct Line {
+        let text: String
+        let bounds: CGRect
+    }
+
+    private struct Edges {
+        let top: Set<String>
+        let bottom: Set<String>
+    }
+
+    /// Share of the page height at the top and bottom where running headers and footers are looked for
+    private static let edgeBand: CGFloat = 0.1
+    /// Pages on either side compared for repeated headers and footers
+    private static let neighborDistance = 2
+    /// Lines at least this share of the text width are never column lines
+    private static let columnLineWidth: CGFloat = 0.6
+
+    let pageCount: Int
+
+    private var edges: [Int: Edges] = [:]
+    private let lock = NSLock()
+
+    init(pageCount: Int) {
+        self.pageCount = pageCount
+    }
+
+    /// Text of the page at `pageIndex` in reading order, or nil if it has no text layer
+    func text(ofPage pageIndex: Int, in document: PDFDocument) -> String? {
+        return autoreleasepool {
+            guard let page = document.page(at: pageIndex) else { return nil }
+            let pageBounds = page.bounds(for: .cropBox)
+            let lines = Self.lines(of: page, in: pageBounds)
+            guard !lines.isEmpty else { return nil }
+
+            let repeated = repeatedEdges(ofPage: pageIndex, in: document)
+            let body = lines.filter { line in
+                switch Self.band(of: line, in: pageBounds) {
+                case .top?:
+                    return !Self.isBoilerplate(line.text, repeatedIn: repeated.top)
+                case .bottom?:
+                    return !Self.isBoilerplate(line.text, repeatedIn: repeated.bottom)
+                case nil:
+                    return true
+                }
+            }
+            let text = Self.readingOrder(body).map(\.text).joined(separator: "\n")
+            return text.isEmpty ? nil : text
+        }
+    }
+
+    // MARK: - Headers and Footers
+
+    /// Signatures in the bands of the page that also appear in the same band of a nearby page
+    private func repeatedEdges(ofPage pageIndex: Int, in document: PDFDocument) -> Edges {
+        let own = edges(ofPage: pageIndex, in: document)
+        var top: Set<String> = []
+        var bottom: Set<String> = []
+        for distance in 1...Self.neighborDistance {
+            for neighbor in [pageIndex - distance, pageIndex + distance] where neighbor >= 0 && neighbor < pageCount {
+                let other = edges(ofPage: neighbor, in: document)
+                top.formUnion(own.top.intersection(other.top))
+                bottom.formUnion(own.bottom.intersection(other.bottom))
+            }
+        }
+        return Edges(top: top, bottom: bottom)
+    }
+
+    private func edges(ofPage pageIndex: Int, in document: PDFDocument) -> Edges {
+        lock.lock()
+        if let known = edges[pageIndex] {
+            lock.unlock()
+            return known
+        }
+        lock.unlock()
+
+        // Found outside the lock; two workers reaching the same page find the same lines
+        let found: Edges = autoreleasepool {
+            guard let page = document.page(at: pageIndex) else { return Edges(top: [], bottom: []) }
+            let pageBounds = page.bounds(for: .cropBox)
+            let bandHeight = pageBounds.height * Self.edgeBand
+            func signatures(in band: CGRect) -> Set<String> {
+                let lines = page.selection(for: band)?.selectionsByLine() ?? []
+                return Set(lines.compactMap { $0.string.map(Self.signature(of:)) }.filter { !$0.isEmpty })
+            }
+            return Edges(
+                top: signatures(in: CGRect(x: pageBounds.minX, y: pageBounds.maxY - bandHeight, width: pageBounds.width, height: bandHeight)),
+                bottom: signatures(in: CGRect(x: pageBounds.minX, y: pageBounds.minY, width: pageBounds.width, height: bandHeight))
+            )
+        }
+
+        lock.lock()
+        edges[pageIndex] = found
+        lock.unlock()
+        return found
+    }
+
+    private enum Band {
+        case top
+        case bottom
+    }
+
+    private static func band(of line: Line, in pageBounds: CGRect) -> Band? {
+        let bandHeight = pageBounds.height * edgeBand
+        if line.bounds.midY >= pageBounds.maxY - bandHeight {
+            return .top
+        }
+        if line.bounds.midY <= pageBounds.minY + bandHeight {
+            return .bottom
+        }
+        return nil
+    }
+
+    private static func isBoilerplate(_ line: String, repeatedIn signatures: Set<String>) -> Bool {
+        let signature = Self.signature(of: line)
+        return signature.isEmpty || signatures.contains(signature) || isPageNumber(signature)
+    }
+
+    /// The line folded so that it matches the same header on another page: lowercased, every run
+    /// of digits as `#` and runs of whitespace as one space
+    static func signature(of line: String) -> String {
+        var signature = ""
+        var lastWasDigit = false
+        var lastWasSpace = true
+        for character in line.lowercased() {
+            if character.isNumber {
+                if !lastWasDigit {
+                    signature.append("#")
+                }
+                lastWasDigit = true
+                lastWasSpace = false
+            } else if character.isWhitespace {
+                if !lastWasSpace {
+                    signature.append(" ")
+                }
+                lastWasDigit = false
+                lastWasSpace = true
+            } else {
+                signature.append(character)
+                lastWasDigit = false
+                lastWasSpace = false
+            }
+        }
+        return signature.trimmingCharacters(in: .whitespaces)
+    }
+
+    private static let pageNumberWords: Set<String> = ["#", "page", "p", "pp", "of", "pag", "pagina", "di", "seite", "von"]
+
+    /// "12", "- 12 -", "Page 12 of 300", "xiv" and the like, as signatures
+    private static func isPageNumber(_ signature: String) -> Bool {
+        let tokens = signature.split { !$0.isLetter && $0 != "#" }.map(String.init)
+        guard !tokens.isEmpty else { return true } // Only punctuation left
+        return tokens.contains { $0 == "#" || isRomanNumeral($0) }
+            && tokens.allSatisfy { pageNumberWords.contains($0) || isRomanNumeral($0) }
+    }
+
+    private static func isRomanNumeral(_ token: String) -> Bool {
+        return token.count <= 6 && token.allSatisfy { "ivxlc".contains($0) }
+    }
+
+    // MARK: - Reading Order
+
+    private static func lines(of page: PDFPage, in pageBounds: CGRect) -> [Line] {
+        guard let selection = page.selection(for: pageBounds) else { return [] }
+        return selection.selectionsByLine().compactMap { line in
+            guard let text = line.string?.trimmingCharacters(in: .whitespacesAndNewlines), !text.isEmpty else { return nil }
+            return Line(text: text, bounds: line.bounds(for: page))
+        }
+    }
+
+    /// Lines top to bottom, one column at a time between the lines that span several columns
+    private static func readingOrder(_ lines: [Line]) -> [Line] {
+        // Top to bottom in PDF space, where y grows upwards, and left to right within a row of
+        // lines that overlap vertically
+        var rows: [[Line]] = []
+        for line in lines.sorted(by: { $0.bounds.midY > $1.bounds.midY }) {
+            if let row = rows.last?.first, row.bounds.midY - line.bounds.midY < min(row.bounds.height, line.bounds.height) / 2 {
+                rows[rows.count - 1].append(line)
+            } else {
+                rows.append([line])
+            }
+        }
+        let sorted = rows.flatMap { $0.sorted { $0.bounds.minX < $1.bounds.minX } }
+        let columns = self.columns(of: sorted)
+        guard columns.count > 1 else { return sorted }
+
+        var ordered: [Line] = []
+        var pending = Array(repeating: [Line](), count: columns.count)
+        for line in sorted {
+            if let column = columns.firstIndex(where: { $0.contains(line.bounds.minX) && $0.contains(line.bounds.maxX) }) {
+                pending[column].append(line)
+            } else {
+                // A line across columns ends the columns above it
+                ordered += pending.joined()
+                pending = Array(repeating: [], count: columns.count)
+                ordered.append(line)
+            }
+        }
+        return ordered + pending.joined()
+    }
+
+    /// X ranges of the columns of the page, left to right, split at gutters no column line crosses
+    private static func columns(of lines: [Line]) -> [ClosedRange<CGFloat>] {
+        guard let left = lines.map(\.bounds.minX).min(), let right = lines.map(\.bounds.maxX).max(), right > left else { return [] }
+        let columnLines = lines.filter { $0.bounds.width < (right - left) * columnLineWidth }
+        return split(columnLines, within: left...right)
+    }
+
+    private static func split(_ lines: [Line], within range: ClosedRange<CGFloat>) -> [ClosedRange<CGFloat>] {
+        // A gutter needs a few lines on each side of it, so a stray short line isn't a column
+        let minimumLines = 3
+        guard lines.count >= minimumLines * 2 else { return [range] }
+
+        // Horizontal extents of the lines merged where they overlap; the widest gap between them
+        // in the middle of the range is the gutter
+        var covered: [ClosedRange<CGFloat>] = []
+        for line in lines.sorted(by: { $0.bounds.minX < $1.bounds.minX }) {
+            if let last = covered.last, line.bounds.minX <= last.upperBound {
+                covered[covered.count - 1] = last.lowerBound...max(last.upperBound, line.bounds.maxX)
+            } else {
+                covered.append(line.bounds.minX...line.bounds.maxX)
+            }
+        }
+        let width = range.upperBound - range.lowerBound
+        let middle = (range.lowerBound + width * 0.2)...(range.upperBound - width * 0.2)
+        let gutters = zip(covered, covered.dropFirst())
+            .map { $0.upperBound...$1.lowerBound }
+            .filter { middle.contains(($0.lowerBound + $0.upperBound) / 2) }
+        guard let gutter = gutters.max(by: { $0.upperBound - $0.lowerBound < $1.upperBound - $1.lowerBound }) else { return [range] }
+
+        let leftLines = lines.filter { $0.bounds.maxX <= gutter.lowerBound }
+        let rightLines = lines.filter { $0.bounds.minX >= gutter.upperBound }
+        guard leftLines.count >= minimumLines && rightLines.count >= minimumLines else { return [range] }
+        return split(leftLines, within: range.lowerBound...gutter.lowerBound)
+            + split(rightLines, within: gutter.upperBound...range.upperBound)
+    }
+}
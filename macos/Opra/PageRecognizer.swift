@@ -0,0 +1,173 @@
+//
+//  PageRecognizer.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import PDFKit
+import Vision
+import os
+
+/// OCR for the pages of one document that have no text layer, such as scanned pages.
+///
+/// Pages are rendered and run through Vision's `VNRecognizeTextRequest` on a utility-QoS thread,
+/// in the order given to `schedule`, which the extractor keeps starting at the reading position.
+/// Results go into the document's `DocumentTextCache` as `.recognized` or `.unrecognized`, so a
+/// page is only ever recognized once. The recognizer reads from its own copy of the document,
+/// never the viewer's.
+final class PageRecognizer: @unchecked Sendable {
+    // 2× the PDF point size (144 dpi) is enough for body text without huge bitmaps
+    static let renderScale: CGFloat = 2
+    // The private document is reopened after this many pages so PDFKit drops the rendered ones
+    private static let pagesPerDocument = 32
+
+    private let store: DocumentTextCache
+    private let documentURL: URL?
+    private var document: PDFDocument
+    private var pagesSinceReopen = 0
+    private let documentLock = NSLock()
+
+    private let condition = NSCondition()
+    private var backlog: [Int] = []
+    private var inFlight: Set<Int> = []
+    private var isRunning = false
+    private var isCancelled = false
+
+    /// Called on the main thread for every page that was recognized with some text
+    var onRecognized: ((Int) -> Void)?
+
+    init(document: PDFDocument, store: DocumentTextCache) {
+        self.store = store
+        self.documentURL = document.documentURL
+        self.document = document.documentURL.flatMap { PDFDocument(url: $0) } ?? document
+    }
+
+    /// True if the page was found to have no text layer and has not been through OCR yet
+    func needsRecognition(_ pageIndex: Int) -> Bool {
+        return store.page(at: pageIndex)?.state == .empty
+    }
+
+    /// Replaces the background backlog with `pageIndices`, recognized in that order. Pages that
+    /// don't need OCR are skipped.
+    func schedule(_ pageIndices: [Int]) {
+        condition.lock()
+        guard !isCancelled else {
+            condition.unlock()
+            return
+        }
+        backlog = pageIndices.filter { needsRecognition($0) }
+        let queued = backlog.count
+        PipelineMetrics.shared.setRecognitionBacklog(queued)
+        let shouldStart = !isRunning && queued > 0
+        isRunning = isRunning || shouldStart
+        condition.unlock()
+
+        if shouldStart {
+            Log.recognition.info("\(queued) pages without a text layer queued")
+            DispatchQueue.global(qos: .utility).async { self.drainBacklog() }
+        }
+    }
+
+    /// Returns the recognized text of the page, recognizing it on the calling thread if the
+    /// background queue hasn't got to it yet. Used by streaming, which runs ahead of speech.
+    func text(forPage pageIndex: Int) -> String? {
+        condition.lock()
+        while inFlight.contains(pageIndex) {
+            condition.wait()
+        }
+        guard needsRecognition(pageIndex), !isCancelled else {
+            condition.unlock()
+            return store.page(at: pageIndex)?.text
+        }
+        inFlight.insert(pageIndex)
+        condition.unlock()
+
+        return recognize(pageIndex)
+    }
+
+    /// Stops background recognition. Pages already recognized stay in the cache.
+    func cancel() {
+        condition.lock()
+        isCancelled = true
+        backlog.removeAll()
+        condition.unlock()
+    }
+
+    private func drainBacklog() {
+        while true {
+            condition.lock()
+            while let next = backlog.first, inFlight.contains(next) || !needsRecognition(next) {
+                backlog.removeFirst()
+            }
+            guard !isCancelled, !backlog.isEmpty else {
+                isRunning = false
+                PipelineMetrics.shared.setRecognitionBacklog(0)
+                condition.unlock()
+                store.save()
+                return
+            }
+            let pageIndex = backlog.removeFirst()
+            inFlight.insert(pageIndex)
+            PipelineMetrics.shared.setRecognitionBacklog(backlog.count + 1)
+            condition.unlock()
+
+            if recognize(pageIndex) != nil {
+                DispatchQueue.main.async { self.onRecognized?(pageIndex) }
+            }
+        }
+    }
+
+    /// Recognizes a page this thread has claimed in `inFlight`, stores the result and releases it.
+    private func recognize(_ pageIndex: Int) -> String? {
+        let interval = Signpost.recognition.beginInterval("Recognize page", id: Signpost.recognition.makeSignpostID(), "page \(pageIndex + 1)")
+        let text = autoreleasepool { () -> String? in
+            guard let image = renderPage(pageIndex) else { return nil }
+            return Self.recognizeText(in: image)
+        }
+        Signpost.recognition.endInterval("Recognize page", interval, "\(text == nil ? "no text" : "recognized", privacy: .public)")
+        store.store(text, forPage: pageIndex, state: text == nil ? .unrecognized : .recognized)
+
+        condition.lock()
+        inFlight.remove(pageIndex)
+        condition.broadcast()
+        condition.unlock()
+        return text
+    }
+
+    private func renderPage(_ pageIndex: Int) -> CGImage? {
+        documentLock.lock()
+        defer { documentLock.unlock() }
+
+        pagesSinceReopen += 1
+        if pagesSinceReopen > Self.pagesPerDocument, let reopened = documentURL.flatMap({ PDFDocument(url: $0) }) {
+            document = reopened
+            pagesSinceReopen = 1
+        }
+
+        guard let page = document.page(at: pageIndex) else { return nil }
+        let bounds = page.bounds(for: .mediaBox)
+        let size = CGSize(width: bounds.width * Self.renderScale, height: bounds.height * Self.renderScale)
+        let image = page.thumbnail(of: size, for: .mediaBox)
+        return image.cgImage(forProposedRect: nil, context: nil, hints: nil)
+    }
+
+    /// Lines of text Vision finds in `image`, top to bottom, or nil if there are none
+    static func recognizeText(in image: CGImage) -> String? {
+        let request = VNRecognizeTextRequest()
+        request.recognitionLevel = .accurate
+        request.usesLanguageCorrection = true
+
+        do {
+            try VNImageRequestHandler(cgImage: image, options: [:]).perform([request])
+        } catch {
+            Log.recognition.error("OCR failed: \(error.localizedDescription, privacy: .public)")
+            return nil
+        }
+
+        let lines = (request.results ?? []).compactMap { $0.topCandidates(1).first?.string }
+        let text = lines.joined(separator: "\n")
+        return text.trimmingCharacters(in: .whitespacesAndNewlines).isEmpty ? nil : text
+    }
+}
@@ -0,0 +1,182 @@
+//
+//  PipelineDiagnostics.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import Combine
+
+/// Samples the pipeline once a second for the diagnostics panel, so a stutter can be traced to
+/// extraction, synthesis, the audio device or the UI.
+///
+/// While running it also watches the main run loop: an iteration that takes longer than
+/// `hitchThreshold` is a hitch, and it is attributed to every observed object that published a
+/// change during that iteration. Nothing is observed or sampled while stopped.
+@MainActor
+final class PipelineDiagnostics: ObservableObject {
+    struct Snapshot {
+        var extractionPagesPerSecond: Double = 0
+        var pagesRemaining = 0 // still to extract, plus pages waiting for OCR
+        var chunksAhead = 0
+        var realTimeFactor: Double? // synthesis time per second of audio; nil until measured
+        var droppedBuffers = 0
+        var lateBuffers = 0
+        var hitches = 0
+        var longestHitch: TimeInterval = 0
+        var hitchSources: [(name: String, count: Int)] = [] // most hitches first
+    }
+
+    struct Sample {
+        let chunksAhead: Int
+        let source: PipelineMetrics.SynthesisSource
+    }
+
+    static let sampleInterval: TimeInterval = 1.0
+    static let hitchThreshold: TimeInterval = 0.05 // three frames at 60 Hz
+
+    @Published private(set) var snapshot = Snapshot()
+    private(set) var isRunning = false
+
+    private let metrics: PipelineMetrics
+    private var sample: (() -> Sample)?
+    private var timer: Timer?
+    private var runLoopObserver: CFRunLoopObserver?
+    private var changeObservers = Set<AnyCancellable>()
+
+    // Totals when the panel was opened, so its counts start at zero
+    private var baseline = PipelineMetrics.Totals()
+    private var previous = PipelineMetrics.Totals()
+    private var previousDate = Date()
+
+    private var iterationStart: CFAbsoluteTime?
+    private var changedInIteration: Set<String> = []
+    private var hitches = 0
+    private var longestHitch: TimeInterval = 0
+    private var hitchCounts: [String: Int] = [:]
+
+    init(metrics: PipelineMetrics = .shared) {
+        self.metrics = metrics
+    }
+
+    /// Starts sampling. `publishers` are the objects whose changes hitches can be attributed to,
+    /// by name; `sample` reads the provider state that has no counter in `PipelineMetrics`.
+    func start(observing publishers: [String: ObservableObjectPublisher], sample: @escaping () -> Sample) {
+        stop()
+        isRunning = true
+        self.sample = sample
+
+        baseline = metrics.read()
+        previous = baseline
+        previousDate = Date()
+        hitches = 0
+        longestHitch = 0
+        hitchCounts = [:]
+        snapshot = Snapshot()
+
+        for (name, publisher) in publishers {
+            publisher.sink { [weak self] _ in
+                self?.changedInIteration.insert(name)
+            }.store(in: &changeObservers)
+        }
+        observeRunLoop()
+
+        let timer = Timer(timeInterval: Self.sampleInterval, repeats: true) { [weak self] _ in
+            MainActor.assumeIsolated {
+                self?.update()
+            }
+        }
+        RunLoop.main.add(timer, forMode: .common)
+        self.timer = timer
+    }
+
+    func stop() {
+        timer?.invalidate()
+        timer = nil
+        if let observer = runLoopObserver {
+            CFRunLoopRemoveObserver(CFRunLoopGetMain(), observer, .commonModes)
+            runLoopObserver = nil
+        }
+        changeObservers.removeAll()
+        changedInIteration.removeAll()
+        iterationStart = nil
+        sample = nil
+        isRunning = false
+    }
+
+    /// Times every pass of the main run loop from waking up to going back to sleep. The observer
+    /// runs last, after SwiftUI and Core Animation have committed the frame, so rendering the
+    /// changes counts toward the pass that published them.
+    private func observeRunLoop() {
+        let activities = CFRunLoopActivity.afterWaiting.rawValue | CFRunLoopActivity.beforeWaiting.rawValue
+        let observer = CFRunLoopObserverCreateWithHandler(nil, activities, true, CFIndex.max) { [weak self] _, activity in
+            MainActor.assumeIsolated {
+                self?.runLoop(did: activity)
+            }
+        }
+        CFRunLoopAddObserver(CFRunLoopGetMain(), observer, .commonModes)
+        runLoopObserver = observer
+    }
+
+    private func runLoop(did activity: CFRunLoopActivity) {
+        let now = CFAbsoluteTimeGetCurrent()
+        if activity == .afterWaiting {
+            iterationStart = now
+            return
+        }
+
+        defer {
+            iterationStart = nil
+            changedInIteration.removeAll()
+        }
+        guard let start = iterationStart, !changedInIteration.isEmpty else { return }
+        let duration = now - start
+        guard duration > Self.hitchThreshold else { return }
+
+        // Published with the next sample, so a hitch doesn't cause another render right away
+        hitches += 1
+        longestHitch = max(longestHitch, duration)
+        for name in changedInIteration {
+            hitchCounts[name, default: 0] += 1
+        }
+    }
+
+    private func update() {
+        let totals = metrics.read()
+        let now = Date()
+        let elapsed = now.timeIntervalSince(previousDate)
+        let current = sample?()
+
+        var snapshot = self.snapshot
+        if elapsed > 0 {
+            snapshot.extractionPagesPerSecond = Double(totals.pagesExtracted - previous.pagesExtracted) / elapsed
+        }
+        snapshot.pagesRemaining = totals.pagesPending + totals.recognitionBacklog
+        snapshot.chunksAhead = current?.chunksAhead ?? 0
+        snapshot.droppedBuffers = totals.droppedBuffers - baseline.droppedBuffers
+        snapshot.lateBuffers = totals.lateBuffers - baseline.lateBuffers
+        snapshot.hitches = hitches
+        snapshot.longestHitch = longestHitch
+        snapshot.hitchSources = hitchCounts.sorted { $0.value > $1.value }.map { (name: $0.key, count: $0.value) }
+
+        // Over the last interval when the provider synthesized anything in it, since the panel opened otherwise
+        if let source = current?.source {
+            let recentAudio = totals.synthesizedAudio[source, default: 0] - previous.synthesizedAudio[source, default: 0]
+            let recentTime = totals.synthesisTime[source, default: 0] - previous.synthesisTime[source, default: 0]
+            let audio = totals.synthesizedAudio[source, default: 0] - baseline.synthesizedAudio[source, default: 0]
+            let time = totals.synthesisTime[source, default: 0] - baseline.synthesisTime[source, default: 0]
+            if recentAudio > 0 {
+                snapshot.realTimeFactor = recentTime / recentAudio
+            } else if audio > 0 {
+                snapshot.realTimeFactor = time / audio
+            } else {
+                snapshot.realTimeFactor = nil
+            }
+        }
+
+        self.snapshot = snapshot
+        previous = totals
+        previousDate = now
+    }
+}
@@ -0,0 +1,100 @@
+//
+//  PipelineMetrics.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import AVFoundation
+
+/// Running totals that the pipeline stages update as they work and the diagnostics panel samples.
+///
+/// Every update takes one uncontended lock, which is negligible next to the page, segment or
+/// buffer it counts, so the counters are always on and the panel only decides when to read them.
+final class PipelineMetrics: @unchecked Sendable {
+    static let shared = PipelineMetrics()
+
+    /// Who produced synthesized audio, so the real-time factor is reported per provider
+    enum SynthesisSource {
+        case system // offline rendering with AVSpeechSynthesizer.write, i.e. audio export
+        case ollama
+    }
+
+    struct Totals {
+        var pagesExtracted = 0
+        var pagesPending = 0 // pages an extraction or stream still has to visit
+        var recognitionBacklog = 0 // pages queued for OCR in the background
+        var synthesizedAudio: [SynthesisSource: TimeInterval] = [:]
+        var synthesisTime: [SynthesisSource: TimeInterval] = [:]
+        var droppedBuffers = 0 // buffers the player could not schedule
+        var lateBuffers = 0 // buffers that arrived after the player had run dry
+    }
+
+    private let lock = NSLock()
+    private var totals = Totals()
+
+    func read() -> Totals {
+        lock.lock()
+        defer { lock.unlock() }
+        return totals
+    }
+
+    // MARK: - Extraction
+
+    func extractionStarted(pages: Int) {
+        update { $0.pagesPending += pages }
+    }
+
+    func pageExtracted() {
+        update {
+            $0.pagesExtracted += 1
+            $0.pagesPending = max(0, $0.pagesPending - 1)
+        }
+    }
+
+    /// Ends an extraction of `pages` pages that got through `extracted` of them before it
+    /// finished or was cancelled
+    func extractionEnded(pages: Int, extracted: Int) {
+        update { $0.pagesPending = max(0, $0.pagesPending - (pages - extracted)) }
+    }
+
+    func setRecognitionBacklog(_ pages: Int) {
+        update { $0.recognitionBacklog = pages }
+    }
+
+    // MARK: - Synthesis
+
+    /// `audio` seconds of speech took `elapsed` seconds to synthesize, not counting time spent
+    /// waiting for the player to make room
+    func recordSynthesis(of audio: TimeInterval, in elapsed: TimeInterval, by source: SynthesisSource) {
+        guard audio > 0 else { return }
+        update {
+            $0.synthesizedAudio[source, default: 0] += audio
+            $0.synthesisTime[source, default: 0] += elapsed
+        }
+    }
+
+    // MARK: - Playback
+
+    func bufferDropped() {
+        update { $0.droppedBuffers += 1 }
+    }
+
+    func bufferLate() {
+        update { $0.lateBuffers += 1 }
+    }
+
+    private func update(_ change: (inout Totals) -> Void) {
+        lock.lock()
+        change(&totals)
+        lock.unlock()
+    }
+}
+
+extension AVAudioPCMBuffer {
+    /// Length of the buffer in seconds
+    var duration: TimeInterval {
+        return Double(frameLength) / format.sampleRate
+    }
+}
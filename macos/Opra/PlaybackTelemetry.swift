@@ -0,0 +1,67 @@
+//
+//  PlaybackTelemetry.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+
+/// Fast-changing playback state of one speech manager: reading progress, the spoken word and
+/// elapsed time.
+///
+/// It changes with every word and timer tick, so it is published here instead of on the manager,
+/// whose changes `TTSProviderManager` forwards to the whole window. Only the views showing
+/// playback progress observe this object, and they see at most one change per
+/// `publishInterval`: reports in between are coalesced, the last one wins.
+@MainActor
+final class PlaybackTelemetry: ObservableObject {
+    static let publishInterval: UInt64 = 100_000_000 // 10 Hz, in nanoseconds
+
+    @Published private(set) var readingProgress: Double = 0.0
+    @Published private(set) var currentWordIndex: Int = 0
+    @Published private(set) var totalWords: Int = 0
+    @Published private(set) var elapsedTime: TimeInterval = 0.0
+
+    private var latest = (readingProgress: 0.0, currentWordIndex: 0, totalWords: 0, elapsedTime: 0.0)
+    private var flushTask: Task<Void, Never>?
+
+    func report(readingProgress: Double? = nil, currentWordIndex: Int? = nil, totalWords: Int? = nil, elapsedTime: TimeInterval? = nil) {
+        latest.readingProgress = readingProgress ?? latest.readingProgress
+        latest.currentWordIndex = currentWordIndex ?? latest.currentWordIndex
+        latest.totalWords = totalWords ?? latest.totalWords
+        latest.elapsedTime = elapsedTime ?? latest.elapsedTime
+        guard flushTask == nil else { return }
+
+        flushTask = Task { [weak self] in
+            try? await Task.sleep(nanoseconds: Self.publishInterval)
+            guard let self, !Task.isCancelled else { return }
+            self.flushTask = nil
+            self.publish()
+        }
+    }
+
+    /// Publishes the latest report right away, e.g. when playback stops, so the progress views
+    /// never show a stale position
+    func flush() {
+        flushTask?.cancel()
+        flushTask = nil
+        publish()
+    }
+
+    private func publish() {
+        // Unchanged values are not assigned, so they don't send a change
+        if readingProgress != latest.readingProgress {
+            readingProgress = latest.readingProgress
+        }
+        if currentWordIndex != latest.currentWordIndex {
+            currentWordIndex = latest.currentWordIndex
+        }
+        if totalWords != latest.totalWords {
+            totalWords = latest.totalWords
+        }
+        if elapsedTime != latest.elapsedTime {
+            elapsedTime = latest.elapsedTime
+        }
+    }
+}
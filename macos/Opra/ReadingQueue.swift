@@ -0,0 +1,232 @@
+//
+//  ReadingQueue.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+
+/// The documents to read one after another, and the background work that gets the next ones ready.
+///
+/// While the current document is read, the next `preparedAhead` documents are opened, extracted
+/// and chunked one at a time on a utility queue with a single worker, so preparation never
+/// competes with the foreground document or the audio. A document that is ready opens without any
+/// extraction or chunking, and `onPrepared` lets the speech provider render its opening too.
+///
+/// The queue owns the security-scoped access to the picked files. It is started when a file is
+/// added and held for the current and upcoming documents. It stops once a document is read past,
+/// removed or replaced, and starts again if a document read past is selected again.
+@MainActor
+final class ReadingQueue: ObservableObject {
+    enum PreparationState: Equatable {
+        case waiting
+        case preparing
+        case ready
+        case failed
+    }
+
+    struct Item: Identifiable {
+        let id = UUID()
+        let url: URL
+        var state: PreparationState = .waiting
+        var isAccessing = true // security-scoped access is started
+
+        var title: String {
+            return url.deletingPathExtension().lastPathComponent
+        }
+    }
+
+    static let preparedAhead = 2
+
+    @Published private(set) var items: [Item] = []
+    @Published private(set) var currentIndex: Int?
+
+    /// Called with every document that finishes preparing
+    var onPrepared: ((PreparedDocument) -> Void)?
+
+    private let preparationQueue = DispatchQueue(label: "com.opra.pdfreader.reading-queue", qos: .utility)
+    private var prepared: [UUID: PreparedDocument] = [:]
+    private var preparation: (id: UUID, workItem: DispatchWorkItem)?
+    private var settingsManager: SettingsManager?
+
+    func setSettingsManager(_ settings: SettingsManager) {
+        settingsManager = settings
+    }
+
+    var currentItem: Item? {
+        return currentIndex.map { items[$0] }
+    }
+
+    var nextItem: Item? {
+        let next = (currentIndex ?? -1) + 1
+        return next < items.count ? items[next] : nil
+    }
+
+    /// Replaces the queue with the files of `urls` that can be accessed, the first of them being
+    /// read now. Returns them; when there are none, the queue is left as it was.
+    @discardableResult
+    func replace(with urls: [URL]) -> [URL] {
+        let newItems = accessibleItems(urls)
+        guard !newItems.isEmpty else { return [] }
+        cancelPreparation()
+        prepared = [:]
+        stopAccessing(items)
+        items = newItems
+        currentIndex = 0
+        updateAccess()
+        prepareUpcoming()
+        return newItems.map(\.url)
+    }
+
+    /// Adds the files of `urls` that can be accessed after the last document in the queue.
+    /// Returns them.
+    @discardableResult
+    func append(_ urls: [URL]) -> [URL] {
+        let newItems = accessibleItems(urls)
+        items += newItems
+        if currentIndex == nil && !items.isEmpty {
+            currentIndex = 0
+        }
+        updateAccess()
+        prepareUpcoming()
+        return newItems.map(\.url)
+    }
+
+    func remove(_ id: UUID) {
+        guard let index = items.firstIndex(where: { $0.id == id }), index != currentIndex else { return }
+        if preparation?.id == id {
+            cancelPreparation()
+        }
+        prepared[id] = nil
+        stopAccessing([items.remove(at: index)])
+        if let current = currentIndex, index < current {
+            currentIndex = current - 1
+        }
+        prepareUpcoming()
+    }
+
+    /// Makes the document after the current one current. Returns its URL, and the document itself
+    /// when it finished preparing in time; otherwise it has to be opened from the URL.
+    func advance() -> (url: URL, document: PreparedDocument?)? {
+        guard let next = nextItem else { return nil }
+        return select(next.id)
+    }
+
+    /// Makes the document with `id` current, like `advance()`
+    func select(_ id: UUID) -> (url: URL, document: PreparedDocument?)? {
+        guard let index = items.firstIndex(where: { $0.id == id }), index != currentIndex else { return nil }
+        if preparation?.id == id {
+            // Opened from its URL instead, at full speed
+            cancelPreparation()
+        }
+        let document = prepared.removeValue(forKey: id)
+        currentIndex = index
+        items[index].state = .waiting // Prepared again should it become upcoming once more
+        updateAccess()
+        prepareUpcoming()
+        return (items[index].url, document)
+    }
+
+    func clear() {
+        cancelPreparation()
+        prepared = [:]
+        stopAccessing(items)
+        items = []
+        currentIndex = nil
+    }
+
+    // MARK: - File Access
+
+    /// Items for the URLs whose security-scoped access could be started
+    private func accessibleItems(_ urls: [URL]) -> [Item] {
+        return urls.filter { $0.startAccessingSecurityScopedResource() }.map { Item(url: $0) }
+    }
+
+    private func stopAccessing(_ items: [Item]) {
+        for item in items where item.isAccessing {
+            item.url.stopAccessingSecurityScopedResource()
+        }
+    }
+
+    /// Holds access for the current and upcoming documents only
+    private func updateAccess() {
+        let first = currentIndex ?? 0
+        for index in items.indices {
+            let isNeeded = index >= first
+            if isNeeded && !items[index].isAccessing {
+                items[index].isAccessing = items[index].url.startAccessingSecurityScopedResource()
+            } else if !isNeeded && items[index].isAccessing {
+                items[index].url.stopAccessingSecurityScopedResource()
+                items[index].isAccessing = false
+            }
+        }
+    }
+
+    // MARK: - Background Preparation
+
+    /// Drops prepared documents that are no longer among the next `preparedAhead`, and starts on
+    /// the first upcoming one that isn't prepared yet
+    private func prepareUpcoming() {
+        let upcoming = Array(items.dropFirst((currentIndex ?? -1) + 1).prefix(Self.preparedAhead))
+        let upcomingIDs = Set(upcoming.map(\.id))
+        for id in prepared.keys where !upcomingIDs.contains(id) {
+            prepared[id] = nil
+            setState(.waiting, of: id)
+        }
+        if let preparation = preparation, !upcomingIDs.contains(preparation.id) {
+            cancelPreparation()
+        }
+
+        guard preparation == nil, let item = upcoming.first(where: { $0.state == .waiting }) else { return }
+        setState(.preparing, of: item.id)
+
+        let url = item.url
+        let chunker = TextChunker(targetLength: settingsManager?.chunkTargetLength ?? TextChunker.defaultTargetLength)
+        // A windowed document starts with only the window around its first page
+        let pageLimit = (settingsManager?.enableWindowedLoading ?? false) ? (settingsManager?.pageWindowRadius ?? 10) + 1 : nil
+        let mode: ExtractionMode = (settingsManager?.enableLayoutExtraction ?? false) ? .layout : .plain
+
+        weak var weakWorkItem: DispatchWorkItem?
+        let workItem = DispatchWorkItem { [weak self] in
+            let isCancelled = { weakWorkItem?.isCancelled ?? true }
+            let document = PDFTextExtractor.prepareDocument(at: url, chunker: chunker, pageLimit: pageLimit, mode: mode, isCancelled: isCancelled)
+            guard !isCancelled() else { return }
+
+            DispatchQueue.main.async {
+                MainActor.assumeIsolated {
+                    guard let self = self, !isCancelled() else { return }
+                    self.finishPreparing(item.id, document: document)
+                }
+            }
+        }
+        weakWorkItem = workItem
+        preparation = (item.id, workItem)
+        preparationQueue.async(execute: workItem)
+    }
+
+    private func finishPreparing(_ id: UUID, document: PreparedDocument?) {
+        preparation = nil
+        if let document = document {
+            prepared[id] = document
+            setState(.ready, of: id)
+            onPrepared?(document)
+        } else {
+            Log.extraction.notice("Could not prepare a queued document; it is opened when its turn comes")
+            setState(.failed, of: id)
+        }
+        prepareUpcoming()
+    }
+
+    private func cancelPreparation() {
+        guard let preparation = preparation else { return }
+        preparation.workItem.cancel()
+        self.preparation = nil
+        setState(.waiting, of: preparation.id)
+    }
+
+    private func setState(_ state: PreparationState, of id: UUID) {
+        guard let index = items.firstIndex(where: { $0.id == id }) else { return }
+        items[index].state = state
+    }
+}
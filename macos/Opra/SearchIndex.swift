@@ -0,0 +1,291 @@
+//
+//  SearchIndex.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import os
+
+/// Inverted index of the words on a document's pages, for phrase search.
+///
+/// Words are split like `WordIndex` splits them, and a hit is a page plus the number of words
+/// before it on that page, the same position `ReadingPosition.page` uses, so a hit can be read
+/// from directly. Terms are the words folded to lowercase without diacritics and with the
+/// punctuation around them removed. Words that are only punctuation or symbols, such as "—" or
+/// "•", have no term and take no position, so a phrase matches across them whether or not the
+/// query has them; each page keeps the positions of those words to map hits back.
+///
+/// Pages are indexed on a utility queue as they are stored, and the index is saved next to the
+/// document's extraction cache file. Searching is safe from any thread while pages are still
+/// being added.
+final class SearchIndex: @unchecked Sendable {
+    struct Hit: Hashable {
+        let page: Int // 1-based
+        let word: Int // words of the page's text before the hit
+        let wordCount: Int // words the hit spans
+    }
+
+    /// Bumped whenever terms or word positions are computed differently
+    static let formatVersion = 2
+
+    let pageCount: Int
+    let fileURL: URL?
+
+    private enum PageState: UInt8, Codable {
+        case notIndexed
+        case empty // stored without text, e.g. waiting for OCR
+        case indexed
+    }
+
+    private struct Contents: Codable {
+        var version = SearchIndex.formatVersion
+        var cacheVersion = ExtractionCache.formatVersion
+        var pages: [PageState]
+        var postings: [String: [UInt64]] = [:] // term -> page << 32 | position among the page's terms
+        var skippedWords: [[UInt32]] // per page, ascending word positions without a term
+    }
+
+    private let queue = DispatchQueue(label: "com.opra.pdfreader.search-index", qos: .utility)
+    private let lock = NSLock()
+    private var contents: Contents
+    private var unsortedTerms: Set<String> = []
+    private var sortedTermList: [String]? // for prefix matches; nil after terms were added
+    private var isDirty = false
+
+    init(pageCount: Int, fileURL: URL?) {
+        self.pageCount = pageCount
+        self.fileURL = fileURL
+        contents = Contents(pages: Array(repeating: .notIndexed, count: pageCount), skippedWords: Array(repeating: [], count: pageCount))
+        queue.async {
+            self.load()
+        }
+    }
+
+    /// Pages whose text is in the index, out of `pageCount`
+    var indexedPageCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return contents.pages.lazy.filter { $0 == .indexed }.count
+    }
+
+    /// Indexes a stored page in the background. A page is indexed once; one stored without text
+    /// is indexed again when its text arrives, e.g. from OCR.
+    func add(_ text: String?, forPage index: Int) {
+        queue.async {
+            self.index(text, forPage: index)
+        }
+    }
+
+    /// Indexes the pages of `store` that aren't indexed yet, in the background
+    func addMissingPages(from store: DocumentTextCache) {
+        queue.async {
+            for pageIndex in 0..<self.pageCount where self.state(ofPage: pageIndex) != .indexed {
+                if let page = store.page(at: pageIndex) {
+                    self.index(page.text, forPage: pageIndex)
+                }
+            }
+        }
+    }
+
+    /// Writes the index file in the background, if anything was added since it was last written
+    func save() {
+        queue.async {
+            self.write()
+        }
+    }
+
+    // MARK: - Searching
+
+    /// Every occurrence of `phrase` in page order, up to `limit`. The last word of the phrase also
+    /// matches words it is the start of, so results show up while the phrase is being typed.
+    func search(_ phrase: String, limit: Int = 500) -> [Hit] {
+        let terms = Self.words(of: phrase).compactMap { Self.term(for: $0) }
+        guard !terms.isEmpty else { return [] }
+
+        lock.lock()
+        defer { lock.unlock() }
+        sortPostings()
+
+        // Each term's postings, with the last term's prefix matches merged into one sorted list
+        var termPostings = terms.dropLast().map { contents.postings[$0] ?? [] }
+        termPostings.append(postings(startingWith: terms[terms.count - 1]))
+        guard let rarest = termPostings.indices.min(by: { termPostings[$0].count < termPostings[$1].count }),
+              !termPostings[rarest].isEmpty else { return [] }
+
+        var hits: [Hit] = []
+        for posting in termPostings[rarest] {
+            // The phrase starts `rarest` words earlier on the same page
+            guard posting & 0xFFFF_FFFF >= UInt64(rarest) else { continue }
+            let first = posting - UInt64(rarest)
+            let isMatch = termPostings.indices.allSatisfy { offset in
+                offset == rarest || Self.contains(termPostings[offset], first + UInt64(offset))
+            }
+            if isMatch {
+                let pageIndex = Int(first >> 32)
+                let position = Int(first & 0xFFFF_FFFF)
+                let word = wordPosition(ofTerm: position, onPage: pageIndex)
+                let lastWord = wordPosition(ofTerm: position + terms.count - 1, onPage: pageIndex)
+                hits.append(Hit(page: pageIndex + 1, word: word, wordCount: lastWord - word + 1))
+                if hits.count == limit {
+                    break
+                }
+            }
+        }
+        return hits
+    }
+
+    /// Word position on the page of the term at `position`, counting the words without a term
+    private func wordPosition(ofTerm position: Int, onPage pageIndex: Int) -> Int {
+        var word = position
+        for skipped in contents.skippedWords[pageIndex] {
+            guard Int(skipped) <= word else { break }
+            word += 1
+        }
+        return word
+    }
+
+    private func postings(startingWith prefix: String) -> [UInt64] {
+        if sortedTermList == nil {
+            sortedTermList = contents.postings.keys.sorted()
+        }
+        guard let sortedTerms = sortedTermList else { return [] }
+
+        // Terms with the prefix sort right after it
+        var lower = 0
+        var upper = sortedTerms.count
+        while lower < upper {
+            let middle = (lower + upper) / 2
+            if sortedTerms[middle] < prefix {
+                lower = middle + 1
+            } else {
+                upper = middle
+            }
+        }
+        let matching = sortedTerms[lower...].prefix { $0.hasPrefix(prefix) }
+        guard matching.count > 1 else { return matching.first.flatMap { contents.postings[$0] } ?? [] }
+        return matching.flatMap { contents.postings[$0] ?? [] }.sorted()
+    }
+
+    private func sortPostings() {
+        for term in unsortedTerms {
+            contents.postings[term]?.sort()
+        }
+        unsortedTerms.removeAll()
+    }
+
+    private static func contains(_ postings: [UInt64], _ posting: UInt64) -> Bool {
+        var lower = 0
+        var upper = postings.count
+        while lower < upper {
+            let middle = (lower + upper) / 2
+            if postings[middle] < posting {
+                lower = middle + 1
+            } else {
+                upper = middle
+            }
+        }
+        return lower < postings.count && postings[lower] == posting
+    }
+
+    // MARK: - Indexing
+
+    private func state(ofPage index: Int) -> PageState {
+        lock.lock()
+        defer { lock.unlock() }
+        return contents.pages[index]
+    }
+
+    /// Runs on `queue`. Terms are found before taking the lock, so searches only wait for the merge.
+    private func index(_ text: String?, forPage pageIndex: Int) {
+        guard pageIndex >= 0 && pageIndex < pageCount, state(ofPage: pageIndex) != .indexed else { return }
+        guard let text = text else {
+            lock.lock()
+            contents.pages[pageIndex] = .empty
+            lock.unlock()
+            return
+        }
+
+        var pageTerms: [String: [UInt64]] = [:]
+        var skipped: [UInt32] = []
+        var position = 0
+        for (wordPosition, word) in Self.words(of: text).enumerated() {
+            guard let term = Self.term(for: word) else {
+                skipped.append(UInt32(wordPosition))
+                continue
+            }
+            pageTerms[term, default: []].append(UInt64(pageIndex) << 32 | UInt64(position))
+            position += 1
+        }
+
+        lock.lock()
+        defer { lock.unlock() }
+        guard contents.pages[pageIndex] != .indexed else { return }
+        for (term, postings) in pageTerms {
+            if contents.postings[term] == nil {
+                sortedTermList = nil
+            }
+            contents.postings[term, default: []] += postings
+            unsortedTerms.insert(term)
+        }
+        contents.skippedWords[pageIndex] = skipped
+        contents.pages[pageIndex] = .indexed
+        isDirty = true
+    }
+
+    /// Whitespace-separated words, the way `WordIndex` and the text store count them
+    private static func words(of text: String) -> [Substring] {
+        let wordIndex = WordIndex(text)
+        return (0..<wordIndex.count).compactMap { wordIndex.word(at: $0, in: text) }
+    }
+
+    private static let trimmedCharacters = CharacterSet.punctuationCharacters.union(.symbols)
+
+    private static func term(for word: Substring) -> String? {
+        let term = word.trimmingCharacters(in: trimmedCharacters)
+            .folding(options: [.caseInsensitive, .diacriticInsensitive], locale: nil)
+        return term.isEmpty ? nil : term
+    }
+
+    // MARK: - Storage
+
+    private func load() {
+        guard let fileURL = fileURL,
+              let data = try? Data(contentsOf: fileURL),
+              let saved = try? PropertyListDecoder().decode(Contents.self, from: data),
+              saved.version == Self.formatVersion,
+              saved.cacheVersion == ExtractionCache.formatVersion,
+              saved.pages.count == pageCount,
+              saved.skippedWords.count == pageCount else {
+            return
+        }
+
+        lock.lock()
+        contents = saved
+        unsortedTerms = Set(saved.postings.keys)
+        sortedTermList = nil
+        lock.unlock()
+        Log.cache.debug("Loaded the search index: \(saved.pages.lazy.filter { $0 == .indexed }.count) of \(self.pageCount) pages")
+    }
+
+    private func write() {
+        lock.lock()
+        guard isDirty, let fileURL = fileURL else {
+            lock.unlock()
+            return
+        }
+        sortPostings()
+        let snapshot = contents
+        isDirty = false
+        lock.unlock()
+
+        do {
+            let encoder = PropertyListEncoder()
+            encoder.outputFormat = .binary
+            try encoder.encode(snapshot).write(to: fileURL, options: .atomic)
+        } catch {
+            Log.cache.error("Could not write the search index: \(error.localizedDescription, privacy: .public)")
+        }
+    }
+}
@@ -8,14 +8,29 @@
 import Foundation
 import AVFoundation
 
+/// What the chunk size setting is measured in
+enum ChunkBudget: String, CaseIterable {
+    case duration = "Duration"
+    case characters = "Characters"
+}
+
 class SettingsManager: ObservableObject {
     @Published var speechRate: Float = 0.5
     @Published var selectedVoiceIdentifier: String = ""
     @Published var autoStartReading: Bool = false
     @Published var showPDFViewer: Bool = true
-    @Published var chunkSize: Int = 10000
+    @Published var chunkBudget: ChunkBudget = .duration
+    @Published var chunkCharacterLimit: Int = TextChunker.defaultTargetLength
+    @Published var chunkDurationMinutes: Int = 5
     @Published var enableFollowText: Bool = false
     @Published var enableSSML: Bool = false
+    @Published var extractionConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount
+    @Published var enableGaplessChunks: Bool = true
+    @Published var enableWindowedLoading: Bool = false
+    @Published var pageWindowRadius: Int = 10
+    @Published var enableOCR: Bool = true
+    @Published var enableLayoutExtraction: Bool = false
+    @Published var showDiagnostics: Bool = false
     
     private let userDefaults = UserDefaults.standard
     
@@ -28,9 +43,18 @@ class SettingsManager: ObservableObject {
         selectedVoiceIdentifier = userDefaults.string(forKey: "selectedVoiceIdentifier") ?? ""
         autoStartReading = userDefaults.bool(forKey: "autoStartReading")
         showPDFViewer = userDefaults.bool(forKey: "showPDFViewer")
-        chunkSize = userDefaults.object(forKey: "chunkSize") as? Int ?? 10000
+        chunkBudget = userDefaults.string(forKey: "chunkBudget").flatMap(ChunkBudget.init(rawValue:)) ?? .duration
+        chunkCharacterLimit = userDefaults.object(forKey: "chunkCharacterLimit") as? Int ?? TextChunker.defaultTargetLength
+        chunkDurationMinutes = userDefaults.object(forKey: "chunkDurationMinutes") as? Int ?? 5
         enableFollowText = userDefaults.bool(forKey: "enableFollowText")
         enableSSML = userDefaults.bool(forKey: "enableSSML")
+        extractionConcurrency = userDefaults.object(forKey: "extractionConcurrency") as? Int ?? ProcessInfo.processInfo.activeProcessorCount
+        enableGaplessChunks = userDefaults.object(forKey: "enableGaplessChunks") as? Bool ?? true
+        enableWindowedLoading = userDefaults.bool(forKey: "enableWindowedLoading")
+        pageWindowRadius = userDefaults.object(forKey: "pageWindowRadius") as? Int ?? 10
+        enableOCR = userDefaults.object(forKey: "enableOCR") as? Bool ?? true
+        enableLayoutExtraction = userDefaults.bool(forKey: "enableLayoutExtraction")
+        showDiagnostics = userDefaults.bool(forKey: "showDiagnostics")
     }
     
     func saveSettings() {
@@ -38,9 +62,18 @@ class SettingsManager: ObservableObject {
         userDefaults.set(selectedVoiceIdentifier, forKey: "selectedVoiceIdentifier")
         userDefaults.set(autoStartReading, forKey: "autoStartReading")
         userDefaults.set(showPDFViewer, forKey: "showPDFViewer")
-        userDefaults.set(chunkSize, forKey: "chunkSize")
+        userDefaults.set(chunkBudget.rawValue, forKey: "chunkBudget")
+        userDefaults.set(chunkCharacterLimit, forKey: "chunkCharacterLimit")
+        userDefaults.set(chunkDurationMinutes, forKey: "chunkDurationMinutes")
         userDefaults.set(enableFollowText, forKey: "enableFollowText")
         userDefaults.set(enableSSML, forKey: "enableSSML")
+        userDefaults.set(extractionConcurrency, forKey: "extractionConcurrency")
+        userDefaults.set(enableGaplessChunks, forKey: "enableGaplessChunks")
+        userDefaults.set(enableWindowedLoading, forKey: "enableWindowedLoading")
+        userDefaults.set(pageWindowRadius, forKey: "pageWindowRadius")
+        userDefaults.set(enableOCR, forKey: "enableOCR")
+        userDefaults.set(enableLayoutExtraction, forKey: "enableLayoutExtraction")
+        userDefaults.set(showDiagnostics, forKey: "showDiagnostics")
     }
     
     func setSpeechRate(_ rate: Float) {
@@ -63,8 +96,63 @@ class SettingsManager: ObservableObject {
         saveSettings()
     }
     
-    func setChunkSize(_ size: Int) {
-        chunkSize = max(1000, min(size, 50000)) // Limit between 1k and 50k words
+    func setChunkBudget(_ budget: ChunkBudget) {
+        chunkBudget = budget
+        saveSettings()
+    }
+    
+    func setChunkCharacterLimit(_ limit: Int) {
+        chunkCharacterLimit = max(TextChunker.minimumTargetLength, min(limit, 100000))
+        saveSettings()
+    }
+    
+    func setChunkDurationMinutes(_ minutes: Int) {
+        chunkDurationMinutes = max(1, min(minutes, 60))
+        saveSettings()
+    }
+    
+    /// Target chunk length in characters for the current budget and speech rate
+    var chunkTargetLength: Int {
+        switch chunkBudget {
+        case .characters:
+            return chunkCharacterLimit
+        case .duration:
+            return TextChunker.targetLength(forDuration: TimeInterval(chunkDurationMinutes * 60), speechRate: speechRate)
+        }
+    }
+    
+    func setExtractionConcurrency(_ workers: Int) {
+        extractionConcurrency = max(1, min(workers, 16)) // 1 keeps the sequential extraction path
+        saveSettings()
+    }
+    
+    func setEnableWindowedLoading(_ enabled: Bool) {
+        enableWindowedLoading = enabled
+        saveSettings()
+    }
+    
+    func setPageWindowRadius(_ pages: Int) {
+        pageWindowRadius = max(1, min(pages, 100))
+        saveSettings()
+    }
+    
+    func setEnableOCR(_ enabled: Bool) {
+        enableOCR = enabled
+        saveSettings()
+    }
+    
+    func setEnableLayoutExtraction(_ enabled: Bool) {
+        enableLayoutExtraction = enabled
+        saveSettings()
+    }
+    
+    func setShowDiagnostics(_ enabled: Bool) {
+        showDiagnostics = enabled
+        saveSettings()
+    }
+    
+    func setEnableGaplessChunks(_ enabled: Bool) {
+        enableGaplessChunks = enabled
         saveSettings()
     }
     
@@ -78,9 +166,30 @@ class SettingsManager: ObservableObject {
         saveSettings()
     }
     
+    // MARK: - Reading Positions
+    
+    /// Where reading of a document stopped, keyed by its content hash so moved or renamed copies
+    /// of the same file resume too
+    func readingPosition(forDocument contentHash: String) -> ReadingPosition? {
+        return readingPositions()[contentHash]
+    }
+    
+    func setReadingPosition(_ position: ReadingPosition, forDocument contentHash: String) {
+        var positions = readingPositions()
+        positions[contentHash] = position
+        if let data = try? JSONEncoder().encode(positions) {
+            userDefaults.set(data, forKey: "readingPositions")
+        }
+    }
+    
+    private func readingPositions() -> [String: ReadingPosition] {
+        guard let data = userDefaults.data(forKey: "readingPositions") else { return [:] }
+        return (try? JSONDecoder().decode([String: ReadingPosition].self, from: data)) ?? [:]
+    }
+    
     func getSelectedVoice() -> AVSpeechSynthesisVoice? {
         if selectedVoiceIdentifier.isEmpty {
-            return AVSpeechSynthesisVoice.speechVoices().first(where: { $0.language.hasPrefix("en") })
+            return VoiceCatalog.shared.englishVoices.first
         }
         return AVSpeechSynthesisVoice(identifier: selectedVoiceIdentifier)
     }
@@ -0,0 +1,105 @@
+//
+//  SpeechRequestScheduler.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+
+/// Gate for every synthesis request sent to the local inference server.
+///
+/// Requests share one dedicated session, so the connection to the server is kept alive between
+/// segments instead of being set up per request. At most `maxInFlight` requests run at once, which
+/// is one for playback and one for render-ahead with a single model loaded. `cancelAll()` fails
+/// every queued request and cancels every running one started before it, so a seek or stop never
+/// waits behind audio nobody will hear.
+@MainActor
+final class SpeechRequestScheduler {
+    static let shared = SpeechRequestScheduler()
+
+    static let maxInFlight = 2
+    static let idleTimeout: TimeInterval = 30.0 // longest wait for the next bytes of a response
+    static let resourceTimeout: TimeInterval = 60.0 * 60.0 // a whole chapter can stream for a long time
+
+    struct Ticket {
+        fileprivate let id: Int
+        fileprivate let generation: Int
+    }
+
+    nonisolated let session: URLSession
+
+    private var generation = 0
+    private var nextTicketID = 0
+    private var inFlight = 0
+    private var waiters: [CheckedContinuation<Void, Error>] = []
+    private var runningTasks: [Int: URLSessionTask] = [:]
+
+    init() {
+        let configuration = URLSessionConfiguration.default
+        configuration.httpMaximumConnectionsPerHost = Self.maxInFlight
+        configuration.timeoutIntervalForRequest = Self.idleTimeout
+        configuration.timeoutIntervalForResource = Self.resourceTimeout
+        configuration.requestCachePolicy = .reloadIgnoringLocalCacheData
+        configuration.urlCache = nil
+        configuration.waitsForConnectivity = false
+        session = URLSession(configuration: configuration)
+    }
+
+    /// Waits for a free request slot. Every ticket must be handed back to `finish(_:)`.
+    func begin() async throws -> Ticket {
+        let generation = self.generation
+        while inFlight >= Self.maxInFlight {
+            try await withCheckedThrowingContinuation { waiters.append($0) }
+        }
+        guard generation == self.generation else { throw CancellationError() }
+
+        inFlight += 1
+        nextTicketID += 1
+        return Ticket(id: nextTicketID, generation: generation)
+    }
+
+    /// Registers the session task running a ticket's request, so `cancelAll()` can cancel it
+    func attach(_ task: URLSessionTask, to ticket: Ticket) {
+        guard ticket.generation == generation else {
+            task.cancel() // Cancelled before the request got under way
+            return
+        }
+        runningTasks[ticket.id] = task
+    }
+
+    func finish(_ ticket: Ticket) {
+        inFlight -= 1
+        runningTasks[ticket.id] = nil
+        if !waiters.isEmpty {
+            waiters.removeFirst().resume()
+        }
+    }
+
+    func cancelAll() {
+        generation += 1
+        for task in runningTasks.values {
+            task.cancel()
+        }
+        runningTasks.removeAll()
+
+        let waiters = self.waiters
+        self.waiters.removeAll()
+        for waiter in waiters {
+            waiter.resume(throwing: CancellationError())
+        }
+    }
+}
+
+/// Reports the session task behind an async `bytes(for:)` request as soon as it is created
+final class SessionTaskObserver: NSObject, URLSessionTaskDelegate {
+    private let onCreate: (URLSessionTask) -> Void
+
+    init(onCreate: @escaping (URLSessionTask) -> Void) {
+        self.onCreate = onCreate
+    }
+
+    func urlSession(_ session: URLSession, didCreateTask task: URLSessionTask) {
+        onCreate(task)
+    }
+}
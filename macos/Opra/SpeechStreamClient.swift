@@ -0,0 +1,201 @@
+//
+//  SpeechStreamClient.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import AVFoundation
+
+enum SpeechStreamError: LocalizedError {
+    case invalidResponse
+    case badStatus(Int)
+    case invalidFrame
+
+    var errorDescription: String? {
+        switch self {
+        case .invalidResponse:
+            return "Invalid response from the speech server"
+        case .badStatus(let status):
+            return "Speech server returned status \(status)"
+        case .invalidFrame:
+            return "Speech server sent an audio frame that could not be decoded"
+        }
+    }
+}
+
+/// Client for a local neural TTS server (e.g. Orpheus-FastAPI in front of Ollama) that streams
+/// audio while it is being synthesized.
+///
+/// The text is POSTed as an OpenAI-style speech request. The server may answer with NDJSON frames,
+/// `{"audio": "<base64 PCM>", "sample_rate": 24000, "done": false}`, or with a chunked body of raw
+/// 16-bit little-endian mono PCM (optionally behind a WAV header). Either way each piece of audio
+/// is handed to `onBuffer` as soon as it arrives, and the body is not read further until
+/// `onBuffer` returns, so a player that waits for queue space also holds back the network.
+///
+/// Requests go through `scheduler`, which owns the keep-alive session and the in-flight limit.
+struct SpeechStreamClient {
+    static let defaultEndpoint = "http://localhost:5005/v1/audio/speech"
+    static let defaultSampleRate: Double = 24000
+
+    /// Raw PCM bodies are cut into buffers of this length
+    static let rawBufferDuration: TimeInterval = 0.25
+
+    private static let wavHeaderLength = 44
+
+    let endpoint: URL
+    let model: String
+    let scheduler: SpeechRequestScheduler
+    var voice: String?
+
+    /// The server accepts an array as `input` and tags each NDJSON frame with the `index` of its segment
+    var supportsBatching = false
+
+    private struct Frame: Decodable {
+        let audio: String?
+        let sampleRate: Double?
+        let index: Int?
+        let done: Bool?
+
+        enum CodingKeys: String, CodingKey {
+            case audio
+            case sampleRate = "sample_rate"
+            case index
+            case done
+        }
+    }
+
+    func synthesize(_ text: String, onBuffer: (AVAudioPCMBuffer) async throws -> Void) async throws {
+        try await send(input: text) { _, buffer in
+            try await onBuffer(buffer)
+        }
+    }
+
+    /// Synthesizes several segments in one request; `onBuffer` gets the index of the segment each
+    /// buffer belongs to. Only for servers that `supportsBatching`.
+    func synthesizeBatch(_ texts: [String], onBuffer: (Int, AVAudioPCMBuffer) async throws -> Void) async throws {
+        precondition(supportsBatching, "Batched requests need a server that supports them")
+        try await send(input: texts, onBuffer: onBuffer)
+    }
+
+    private func send(input: Any, onBuffer: (Int, AVAudioPCMBuffer) async throws -> Void) async throws {
+        var request = URLRequest(url: endpoint)
+        request.httpMethod = "POST"
+        request.setValue("application/json", forHTTPHeaderField: "Content-Type")
+
+        var requestBody: [String: Any] = [
+            "model": model,
+            "input": input,
+            "response_format": "pcm",
+            "stream": true
+        ]
+        if let voice = voice {
+            requestBody["voice"] = voice
+        }
+        request.httpBody = try JSONSerialization.data(withJSONObject: requestBody)
+
+        let ticket = try await scheduler.begin()
+        do {
+            try await receive(request, ticket: ticket, onBuffer: onBuffer)
+            await scheduler.finish(ticket)
+        } catch {
+            await scheduler.finish(ticket)
+            throw error
+        }
+    }
+
+    private func receive(_ request: URLRequest, ticket: SpeechRequestScheduler.Ticket, onBuffer: (Int, AVAudioPCMBuffer) async throws -> Void) async throws {
+        let scheduler = self.scheduler
+        let observer = SessionTaskObserver { task in
+            Task { @MainActor in
+                scheduler.attach(task, to: ticket)
+            }
+        }
+
+        let (bytes, response) = try await scheduler.session.bytes(for: request, delegate: observer)
+        guard let httpResponse = response as? HTTPURLResponse else {
+            throw SpeechStreamError.invalidResponse
+        }
+        guard httpResponse.statusCode == 200 else {
+            throw SpeechStreamError.badStatus(httpResponse.statusCode)
+        }
+
+        let contentType = httpResponse.value(forHTTPHeaderField: "Content-Type")?.lowercased() ?? ""
+        if contentType.contains("json") {
+            try await receiveFrames(bytes, onBuffer: onBuffer)
+        } else {
+            let sampleRate = httpResponse.value(forHTTPHeaderField: "X-Sample-Rate").flatMap(Double.init) ?? Self.defaultSampleRate
+            try await receivePCM(bytes, sampleRate: sampleRate, hasWAVHeader: contentType.contains("wav")) { buffer in
+                try await onBuffer(0, buffer)
+            }
+        }
+    }
+
+    private func receiveFrames(_ bytes: URLSession.AsyncBytes, onBuffer: (Int, AVAudioPCMBuffer) async throws -> Void) async throws {
+        let decoder = JSONDecoder()
+        for try await line in bytes.lines {
+            guard !line.isEmpty else { continue }
+            guard let frame = try? decoder.decode(Frame.self, from: Data(line.utf8)) else {
+                throw SpeechStreamError.invalidFrame
+            }
+
+            if let audio = frame.audio {
+                guard let pcm = Data(base64Encoded: audio) else {
+                    throw SpeechStreamError.invalidFrame
+                }
+                if let buffer = Self.makeBuffer(fromPCM16: pcm, sampleRate: frame.sampleRate ?? Self.defaultSampleRate) {
+                    try await onBuffer(frame.index ?? 0, buffer)
+                }
+            }
+            if frame.done == true {
+                break
+            }
+        }
+    }
+
+    private func receivePCM(_ bytes: URLSession.AsyncBytes, sampleRate: Double, hasWAVHeader: Bool, onBuffer: (AVAudioPCMBuffer) async throws -> Void) async throws {
+        let bufferLength = Int(sampleRate * Self.rawBufferDuration) * 2
+        var headerBytesLeft = hasWAVHeader ? Self.wavHeaderLength : 0
+        var pending = Data()
+        pending.reserveCapacity(bufferLength)
+
+        for try await byte in bytes {
+            if headerBytesLeft > 0 {
+                headerBytesLeft -= 1
+                continue
+            }
+            pending.append(byte)
+            if pending.count == bufferLength {
+                if let buffer = Self.makeBuffer(fromPCM16: pending, sampleRate: sampleRate) {
+                    try await onBuffer(buffer)
+                }
+                pending.removeAll(keepingCapacity: true)
+            }
+        }
+
+        if let buffer = Self.makeBuffer(fromPCM16: pending, sampleRate: sampleRate) {
+            try await onBuffer(buffer)
+        }
+    }
+
+    /// Converts 16-bit little-endian mono samples to a float buffer the audio engine can play
+    static func makeBuffer(fromPCM16 pcm: Data, sampleRate: Double) -> AVAudioPCMBuffer? {
+        let frameCount = pcm.count / 2
+        guard frameCount > 0,
+              let format = AVAudioFormat(standardFormatWithSampleRate: sampleRate, channels: 1),
+              let buffer = AVAudioPCMBuffer(pcmFormat: format, frameCapacity: AVAudioFrameCount(frameCount)),
+              let samples = buffer.floatChannelData?[0] else {
+            return nil
+        }
+
+        buffer.frameLength = AVAudioFrameCount(frameCount)
+        pcm.withUnsafeBytes { raw in
+            for frame in 0..<frameCount {
+                let sample = Int16(littleEndian: raw.loadUnaligned(fromByteOffset: frame * 2, as: Int16.self))
+                samples[frame] = Float(sample) / 32768.0
+            }
+        }
+        return buffer
+    }
+}
@@ -0,0 +1,157 @@
+//
+//  StreamingAudioPlayer.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import AVFoundation
+import os
+
+/// Plays PCM buffers as they arrive from a streaming speech backend.
+///
+/// Buffers are scheduled back to back on an `AVAudioPlayerNode`, so playback starts with the first
+/// one and there are no gaps between them. `schedule(_:)` suspends while more than
+/// `maxQueuedDuration` seconds are waiting to be played, which keeps memory bounded however long
+/// the text is. Speed changes go through a time-pitch unit, so the voice keeps its pitch.
+@MainActor
+final class StreamingAudioPlayer {
+    static let maxQueuedDuration: TimeInterval = 10.0
+
+    /// Called once everything scheduled before `finishScheduling()` has been played
+    var onFinished: (() -> Void)?
+
+    private let engine = AVAudioEngine()
+    private let playerNode = AVAudioPlayerNode()
+    private let timePitch = AVAudioUnitTimePitch()
+    private var format: AVAudioFormat?
+
+    // Bumped on stop so callbacks from buffers of an earlier stream are ignored
+    private var generation = 0
+    private var queuedFrames: AVAudioFramePosition = 0
+    private var scheduledFrames: AVAudioFramePosition = 0
+    private var isFinishing = false
+    private var spaceWaiters: [CheckedContinuation<Void, Never>] = []
+
+    init() {
+        engine.attach(playerNode)
+        engine.attach(timePitch)
+    }
+
+    var rate: Float {
+        get { timePitch.rate }
+        set { timePitch.rate = newValue }
+    }
+
+    var isStarted: Bool {
+        return format != nil
+    }
+
+    /// Seconds of audio scheduled so far
+    var scheduledDuration: TimeInterval {
+        guard let format = format else { return 0 }
+        return Double(scheduledFrames) / format.sampleRate
+    }
+
+    /// Seconds of audio played so far, in source time (independent of the playback rate)
+    var playedDuration: TimeInterval {
+        guard let nodeTime = playerNode.lastRenderTime,
+              let playerTime = playerNode.playerTime(forNodeTime: nodeTime) else {
+            return 0
+        }
+        return min(scheduledDuration, max(0, Double(playerTime.sampleTime) / playerTime.sampleRate))
+    }
+
+    private var queuedDuration: TimeInterval {
+        guard let format = format else { return 0 }
+        return Double(queuedFrames) / format.sampleRate
+    }
+
+    /// Starts the engine for buffers in `format`; call before scheduling the first buffer
+    func start(format: AVAudioFormat) throws {
+        engine.connect(playerNode, to: timePitch, format: format)
+        engine.connect(timePitch, to: engine.mainMixerNode, format: format)
+        engine.prepare()
+        try engine.start()
+        playerNode.play()
+        self.format = format
+    }
+
+    /// Queues `buffer` after the ones already scheduled, waiting first if the queue is full
+    func schedule(_ buffer: AVAudioPCMBuffer) async {
+        let generation = self.generation
+        while queuedDuration > Self.maxQueuedDuration {
+            await withCheckedContinuation { spaceWaiters.append($0) }
+            guard generation == self.generation else { return }
+        }
+
+        guard let format = format, buffer.format == format else {
+            Log.speech.notice("Skipping audio buffer with a different format than the stream")
+            PipelineMetrics.shared.bufferDropped()
+            return
+        }
+
+        let frames = AVAudioFramePosition(buffer.frameLength)
+        if queuedFrames == 0 && scheduledFrames > 0 {
+            // Everything before this buffer has already played, so there was a gap in the audio
+            PipelineMetrics.shared.bufferLate()
+        }
+        queuedFrames += frames
+        scheduledFrames += frames
+        playerNode.scheduleBuffer(buffer, completionCallbackType: .dataPlayedBack) { [weak self] _ in
+            Task { @MainActor in
+                self?.bufferDidPlay(frames, generation: generation)
+            }
+        }
+    }
+
+    /// No more buffers are coming; `onFinished` fires once the queue has drained
+    func finishScheduling() {
+        isFinishing = true
+        if queuedFrames == 0 {
+            finish()
+        }
+    }
+
+    func pause() {
+        playerNode.pause()
+    }
+
+    func resume() {
+        playerNode.play()
+    }
+
+    func stop() {
+        generation += 1
+        resumeWaiters()
+        playerNode.stop()
+        engine.stop()
+        format = nil
+        queuedFrames = 0
+        scheduledFrames = 0
+        isFinishing = false
+    }
+
+    private func bufferDidPlay(_ frames: AVAudioFramePosition, generation: Int) {
+        guard generation == self.generation else { return }
+        queuedFrames -= frames
+        resumeWaiters()
+        if isFinishing && queuedFrames == 0 {
+            finish()
+        }
+    }
+
+    private func finish() {
+        isFinishing = false
+        onFinished?()
+    }
+
+    private func resumeWaiters() {
+        let waiters = spaceWaiters
+        spaceWaiters.removeAll()
+        for waiter in waiters {
+            waiter.resume()
+        }
+    }
+}
@@ -8,6 +8,7 @@
 import Foundation
 import AVFoundation
 import Combine
+import os
 
 enum TTSProvider: String, CaseIterable {
     case system = "System TTS"
@@ -27,76 +28,93 @@ enum TTSProvider: String, CaseIterable {
 class TTSProviderManager: ObservableObject {
     @Published var currentProvider: TTSProvider = .system
     @Published var systemTTSManager: TextToSpeechManager
-    @Published var ollamaTTSManager: OllamaTTSManager
+    @Published var audioExporter: AudioExporter
+    
+    /// Nil until `ensureOllamaManager()` is first called, so a launch with the system voice never
+    /// starts Ollama's audio engine or probes the server. Views read it as it is; only actions
+    /// create it.
+    @Published private(set) var ollamaTTSManager: OllamaTTSManager?
+    
+    /// Feeds the diagnostics panel. Not forwarded like the managers above, so its samples only
+    /// redraw the panel.
+    let diagnostics = PipelineDiagnostics()
     
     init() {
         self.systemTTSManager = TextToSpeechManager()
-        self.ollamaTTSManager = OllamaTTSManager()
+        self.audioExporter = AudioExporter()
         
-        // Forward state changes from underlying managers
+        // Forward state changes from underlying managers. Progress, word position and elapsed
+        // time are not among them: they go through each manager's `telemetry`, so playback
+        // doesn't re-render the whole window.
         systemTTSManager.objectWillChange.sink { [weak self] _ in
             self?.objectWillChange.send()
         }.store(in: &cancellables)
         
-        ollamaTTSManager.objectWillChange.sink { [weak self] _ in
+        audioExporter.objectWillChange.sink { [weak self] _ in
             self?.objectWillChange.send()
         }.store(in: &cancellables)
+        
+        // Keep the saved reading position current while speaking, so it survives a crash too
+        systemTTSManager.telemetry.$currentWordIndex
+            .throttle(for: .seconds(5), scheduler: RunLoop.main, latest: true)
+            .sink { [weak self] _ in
+                self?.saveReadingPosition()
+            }.store(in: &cancellables)
     }
     
     private var cancellables = Set<AnyCancellable>()
     
-    // Computed properties to expose current provider's state
-    var isSpeaking: Bool {
-        switch currentProvider {
-        case .system:
-            return systemTTSManager.isSpeaking
-        case .ollama:
-            return ollamaTTSManager.isSpeaking
+    /// Creates the Ollama manager if it doesn't exist yet. Called when Ollama is selected or set
+    /// up, never while a view is being evaluated.
+    @discardableResult
+    func ensureOllamaManager() -> OllamaTTSManager {
+        if let manager = ollamaTTSManager {
+            return manager
         }
-    }
-    
-    var isPaused: Bool {
-        switch currentProvider {
-        case .system:
-            return systemTTSManager.isPaused
-        case .ollama:
-            return ollamaTTSManager.isPaused
+        let manager = OllamaTTSManager()
+        manager.objectWillChange.sink { [weak self] _ in
+            self?.objectWillChange.send()
+        }.store(in: &cancellables)
+        ollamaTTSManager = manager
+        if diagnostics.isRunning {
+            setDiagnosticsEnabled(true)
         }
+        return manager
     }
     
-    var readingProgress: Double {
-        switch currentProvider {
-        case .system:
-            return systemTTSManager.readingProgress
-        case .ollama:
-            return ollamaTTSManager.readingProgress
-        }
+    private weak var pdfExtractor: PDFTextExtractor?
+    
+    func setPDFExtractor(_ extractor: PDFTextExtractor) {
+        pdfExtractor = extractor
+        systemTTSManager.setPDFExtractor(extractor)
     }
     
-    var currentWordIndex: Int {
+    // Computed properties to expose current provider's state
+    var isSpeaking: Bool {
         switch currentProvider {
         case .system:
-            return systemTTSManager.currentWordIndex
+            return systemTTSManager.isSpeaking
         case .ollama:
-            return ollamaTTSManager.currentWordIndex
+            return ollamaTTSManager?.isSpeaking ?? false
         }
     }
     
-    var totalWords: Int {
+    var isPaused: Bool {
         switch currentProvider {
         case .system:
-            return systemTTSManager.totalWords
+            return systemTTSManager.isPaused
         case .ollama:
-            return ollamaTTSManager.totalWords
+            return ollamaTTSManager?.isPaused ?? false
         }
     }
     
-    var elapsedTime: TimeInterval {
+    /// Progress of the current provider, for the views that show it
+    var playbackTelemetry: PlaybackTelemetry {
         switch currentProvider {
         case .system:
-            return systemTTSManager.elapsedTime
+            return systemTTSManager.telemetry
         case .ollama:
-            return ollamaTTSManager.elapsedTime
+            return ollamaTTSManager?.telemetry ?? systemTTSManager.telemetry
         }
     }
     
@@ -105,7 +123,7 @@ class TTSProviderManager: ObservableObject {
         case .system:
             return systemTTSManager.speechRate
         case .ollama:
-            return ollamaTTSManager.speechRate
+            return ollamaTTSManager?.speechRate ?? systemTTSManager.speechRate
         }
     }
     
@@ -114,14 +132,17 @@ class TTSProviderManager: ObservableObject {
     }
     
     func setProvider(_ provider: TTSProvider) {
+        if provider == .ollama {
+            ensureOllamaManager()
+        }
         currentProvider = provider
         
         // Stop current speech when switching providers
         if systemTTSManager.isSpeaking {
             systemTTSManager.stopSpeaking()
         }
-        if ollamaTTSManager.isSpeaking {
-            ollamaTTSManager.stopSpeaking()
+        if ollamaTTSManager?.isSpeaking == true {
+            ollamaTTSManager?.stopSpeaking()
         }
     }
     
@@ -131,34 +152,164 @@ class TTSProviderManager: ObservableObject {
             systemTTSManager.speak(text)
         case .ollama:
             // Check if Ollama is available and has a valid model
-            if ollamaTTSManager.isAvailable && !ollamaTTSManager.selectedModel.isEmpty {
-                ollamaTTSManager.speak(text)
+            let ollama = ensureOllamaManager()
+            if ollama.isAvailable && !ollama.selectedModel.isEmpty {
+                ollama.speak(text)
             } else {
                 // Fall back to system TTS if Ollama is not available
-                print("Ollama TTS not available, falling back to System TTS")
+                Log.speech.notice("Ollama TTS not available, falling back to System TTS")
                 systemTTSManager.speak(text)
             }
         }
     }
     
-    func speakChunkedText(_ texts: [String], startChunk: Int = 0) {
+    func speakChunkedText(_ texts: [TextRange], startChunk: Int = 0) {
         switch currentProvider {
         case .system:
             systemTTSManager.speakChunkedText(texts, startChunk: startChunk)
         case .ollama:
-            // For Ollama, we'll fall back to system TTS for chunked text
-            // since Ollama TTS is not fully implemented
-            print("Using System TTS for chunked text (Ollama not fully implemented)")
-            systemTTSManager.speakChunkedText(texts, startChunk: startChunk)
+            // Upcoming chunks are rendered ahead into the audio cache while the current one plays
+            let ollama = ensureOllamaManager()
+            if ollama.isAvailable && !ollama.selectedModel.isEmpty {
+                ollama.speakChunkedText(texts, startChunk: startChunk)
+            } else {
+                Log.speech.notice("Ollama TTS not available, falling back to System TTS")
+                systemTTSManager.speakChunkedText(texts, startChunk: startChunk)
+            }
         }
     }
     
+    func speakPageStream(_ queue: ExtractedPageQueue) {
+        switch currentProvider {
+        case .system:
+            systemTTSManager.speakPageStream(queue)
+        case .ollama:
+            // Pages are rendered as they arrive, with the ones already extracted rendered ahead
+            let ollama = ensureOllamaManager()
+            if ollama.isAvailable && !ollama.selectedModel.isEmpty {
+                ollama.speakPageStream(queue)
+            } else {
+                Log.speech.notice("Ollama TTS not available, falling back to System TTS")
+                systemTTSManager.speakPageStream(queue)
+            }
+        }
+    }
+    
+    // MARK: - Seeking
+    
+    /// Starts speaking from `position` in the extractor's text.
+    ///
+    /// The position is resolved with the extractor's word index and the first chunk is cut to
+    /// start there, so nothing is extracted or rechunked and speech starts as soon as that chunk
+    /// is normalized. While the text is windowed or still being extracted, pages are streamed
+    /// from the position's page instead. Returns false if no document is loaded.
+    @discardableResult
+    func seek(to position: ReadingPosition) -> Bool {
+        guard let extractor = pdfExtractor, extractor.isReadyToRead else { return false }
+        guard let location = extractor.location(of: position) else {
+            Log.speech.debug("Seek to \(String(describing: position), privacy: .public): text not assembled, streaming from its page")
+            speakPageStream(extractor.streamPages(from: position))
+            return true
+        }
+        
+        Log.speech.debug("Seek to \(String(describing: position), privacy: .public): chunk \(location.chunk + 1), word \(location.word + 1)")
+        extractor.showChunk(location.chunk)
+        extractor.currentPage = location.page
+        switch currentProvider {
+        case .system:
+            systemTTSManager.speakChunkedText(location.chunks, startChunk: location.chunk, firstWordOffset: location.word)
+        case .ollama:
+            let ollama = ensureOllamaManager()
+            if ollama.isAvailable && !ollama.selectedModel.isEmpty {
+                ollama.speakChunkedText(location.chunks, startChunk: location.chunk)
+            } else {
+                Log.speech.notice("Ollama TTS not available, falling back to System TTS")
+                systemTTSManager.speakChunkedText(location.chunks, startChunk: location.chunk, firstWordOffset: location.word)
+            }
+        }
+        return true
+    }
+    
+    /// Where the system voice is in the document. Ollama playback doesn't report word positions.
+    var currentReadingPosition: ReadingPosition? {
+        guard let extractor = pdfExtractor, let segment = systemTTSManager.currentSegment else { return nil }
+        switch segment {
+        case .chunk(let chunk):
+            return extractor.position(ofWord: systemTTSManager.currentWordIndex, inChunk: chunk)
+        case .page(let page):
+            return .page(page, word: systemTTSManager.currentWordIndex)
+        }
+    }
+    
+    /// Stores the current position for this document, so reading resumes there
+    func saveReadingPosition() {
+        guard let position = currentReadingPosition else { return }
+        pdfExtractor?.saveReadingPosition(position)
+    }
+    
+    // MARK: - Reading Queue
+    
+    /// Gets the opening of a document queued after the current one ready to play. Ollama renders
+    /// it into the audio cache while it is idle; the system voice synthesizes live, so there is
+    /// nothing to render ahead for it.
+    func prepareOpening(of document: PreparedDocument) {
+        guard currentProvider == .ollama else { return }
+        ensureOllamaManager().prerender(document.openingText)
+    }
+    
+    // MARK: - Diagnostics
+    
+    func setDiagnosticsEnabled(_ enabled: Bool) {
+        guard enabled else {
+            diagnostics.stop()
+            return
+        }
+        
+        var publishers = [
+            "System speech": systemTTSManager.objectWillChange,
+            "Playback progress": playbackTelemetry.objectWillChange,
+            "Audio export": audioExporter.objectWillChange
+        ]
+        if let ollama = ollamaTTSManager {
+            publishers["Ollama speech"] = ollama.objectWillChange
+        }
+        if let extractor = pdfExtractor {
+            publishers["Extraction"] = extractor.objectWillChange
+        }
+        diagnostics.start(observing: publishers) { [weak self] in
+            guard let self = self else { return PipelineDiagnostics.Sample(chunksAhead: 0, source: .system) }
+            switch self.currentProvider {
+            case .system:
+                return PipelineDiagnostics.Sample(chunksAhead: self.systemTTSManager.queuedAheadCount, source: .system)
+            case .ollama:
+                return PipelineDiagnostics.Sample(chunksAhead: self.ollamaTTSManager?.renderedAheadCount ?? 0, source: .ollama)
+            }
+        }
+    }
+    
+    // MARK: - Offline Export
+    
+    var isExporting: Bool {
+        return audioExporter.isExporting
+    }
+    
+    /// Renders every page to an audio file faster than real time, without playing it
+    func exportAudio(_ pages: ExtractedPageQueue, pageCount: Int, to url: URL) {
+        // Offline rendering always uses the system voice, which can write buffers without playing them
+        audioExporter.export(pages, pageCount: pageCount, voice: systemTTSManager.currentVoice, rate: systemTTSManager.speechRate, to: url)
+    }
+    
+    func cancelExport() {
+        audioExporter.cancel()
+    }
+    
     func pauseSpeaking() {
+        saveReadingPosition()
         switch currentProvider {
         case .system:
             systemTTSManager.pauseSpeaking()
         case .ollama:
-            ollamaTTSManager.pauseSpeaking()
+            ollamaTTSManager?.pauseSpeaking()
         }
     }
     
@@ -167,16 +318,17 @@ class TTSProviderManager: ObservableObject {
         case .system:
             systemTTSManager.resumeSpeaking()
         case .ollama:
-            ollamaTTSManager.resumeSpeaking()
+            ollamaTTSManager?.resumeSpeaking()
         }
     }
     
     func stopSpeaking() {
+        saveReadingPosition()
         switch currentProvider {
         case .system:
             systemTTSManager.stopSpeaking()
         case .ollama:
-            ollamaTTSManager.stopSpeaking()
+            ollamaTTSManager?.stopSpeaking()
         }
     }
     
@@ -185,7 +337,7 @@ class TTSProviderManager: ObservableObject {
         case .system:
             systemTTSManager.setSpeechRate(rate)
         case .ollama:
-            ollamaTTSManager.setSpeechRate(rate)
+            ollamaTTSManager?.setSpeechRate(rate)
         }
     }
     
@@ -250,10 +402,11 @@ class TTSProviderManager: ObservableObject {
         case .system:
             systemTTSManager.previewSpeed(rate)
         case .ollama:
-            ollamaTTSManager.setSpeechRate(rate)
+            let ollama = ensureOllamaManager()
+            ollama.setSpeechRate(rate)
             // For Ollama, we could generate a short preview
             let previewText = "This is a preview of the reading speed. How does this pace sound to you?"
-            ollamaTTSManager.speak(previewText)
+            ollama.speak(previewText)
         }
     }
     
@@ -0,0 +1,143 @@
+//
+//  TextChunker.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+
+/// Splits text into chunks of roughly `targetLength` UTF-8 bytes that end on paragraph or sentence
+/// boundaries whenever the text allows it.
+///
+/// Chunks are returned as ranges (or substrings) over the source text, never as copies. Chunking is
+/// greedy: each chunk only depends on the bytes in its own window, `start..<start + targetLength`,
+/// so a caller that edits the end of the text can keep every chunk whose window ends before the
+/// edit and re-chunk from there.
+struct TextChunker {
+    static let defaultTargetLength = 4000
+    static let minimumTargetLength = 500
+
+    /// Roughly what the system voice reads per second at its default rate of 0.5
+    static let charactersPerSecondAtDefaultRate = 15.0
+
+    let targetLength: Int
+
+    init(targetLength: Int = TextChunker.defaultTargetLength) {
+        self.targetLength = max(Self.minimumTargetLength, targetLength)
+    }
+
+    /// Chunk length that takes about `seconds` to speak at `speechRate`
+    static func targetLength(forDuration seconds: TimeInterval, speechRate: Float) -> Int {
+        let charactersPerSecond = charactersPerSecondAtDefaultRate * Double(max(0.1, speechRate)) / 0.5
+        return Int(seconds * charactersPerSecond)
+    }
+
+    /// Splits `text` into chunks that share its storage
+    func chunks(of text: String) -> [Substring] {
+        var text = text
+        text.makeContiguousUTF8()
+        let ranges = text.utf8.withContiguousStorageIfAvailable { chunkRanges(in: $0) } ?? []
+        let utf8 = text.utf8
+        return ranges.map { range in
+            text[utf8.index(utf8.startIndex, offsetBy: range.lowerBound)..<utf8.index(utf8.startIndex, offsetBy: range.upperBound)]
+        }
+    }
+
+    /// Byte ranges of the chunks in `bytes[start...]`. Each range starts and ends on non-whitespace.
+    func chunkRanges(in bytes: UnsafeBufferPointer<UInt8>, from start: Int = 0) -> [Range<Int>] {
+        var ranges: [Range<Int>] = []
+        var chunkStart = Self.skipWhitespace(in: bytes, from: start)
+
+        while chunkStart < bytes.count {
+            let limit = chunkStart + targetLength
+            let cut = limit >= bytes.count ? bytes.count : cutPoint(in: bytes, from: chunkStart, limit: limit)
+            ranges.append(chunkStart..<Self.trimmedEnd(in: bytes, from: chunkStart, to: cut))
+            chunkStart = Self.skipWhitespace(in: bytes, from: cut)
+        }
+        return ranges
+    }
+
+    /// Where a chunk starting at `start` should end without reading past `limit`. A paragraph break
+    /// in the second half of the window wins, then the last sentence end, then the last space.
+    private func cutPoint(in bytes: UnsafeBufferPointer<UInt8>, from start: Int, limit: Int) -> Int {
+        var paragraphEnd = -1
+        var sentenceEnd = -1
+        var wordEnd = -1
+
+        for index in start..<limit {
+            let byte = bytes[index]
+            if Self.isWhitespace(byte) {
+                wordEnd = index
+                if byte == UInt8(ascii: "\n") && Self.isBlankLine(in: bytes, after: index, limit: limit) {
+                    paragraphEnd = index
+                }
+            } else if byte == UInt8(ascii: ".") || byte == UInt8(ascii: "!") || byte == UInt8(ascii: "?") {
+                var next = index + 1
+                while next < limit && Self.isSentenceCloser(bytes[next]) {
+                    next += 1
+                }
+                if next < limit && Self.isWhitespace(bytes[next]) {
+                    sentenceEnd = next
+                }
+            }
+        }
+
+        if paragraphEnd >= start + targetLength / 2 {
+            return paragraphEnd
+        }
+        if sentenceEnd > start {
+            return sentenceEnd
+        }
+        if wordEnd > start {
+            return wordEnd
+        }
+
+        // One unbroken run of text: cut at the limit, but never inside a UTF-8 sequence
+        var cut = limit
+        while cut > start + 1 && (bytes[cut] & 0xC0) == 0x80 {
+            cut -= 1
+        }
+        return cut
+    }
+
+    /// True if the line after the newline at `index` is empty or only holds spaces
+    private static func isBlankLine(in bytes: UnsafeBufferPointer<UInt8>, after index: Int, limit: Int) -> Bool {
+        var next = index + 1
+        while next < limit {
+            switch bytes[next] {
+            case UInt8(ascii: "\n"):
+                return true
+            case UInt8(ascii: " "), UInt8(ascii: "\t"), UInt8(ascii: "\r"):
+                next += 1
+            default:
+                return false
+            }
+        }
+        return false
+    }
+
+    private static func skipWhitespace(in bytes: UnsafeBufferPointer<UInt8>, from start: Int) -> Int {
+        var index = start
+        while index < bytes.count && isWhitespace(bytes[index]) {
+            index += 1
+        }
+        return index
+    }
+
+    private static func trimmedEnd(in bytes: UnsafeBufferPointer<UInt8>, from start: Int, to end: Int) -> Int {
+        var end = end
+        while end > start && isWhitespace(bytes[end - 1]) {
+            end -= 1
+        }
+        return end
+    }
+
+    private static func isSentenceCloser(_ byte: UInt8) -> Bool {
+        return byte == UInt8(ascii: "\"") || byte == UInt8(ascii: "'") || byte == UInt8(ascii: ")") || byte == UInt8(ascii: "]")
+    }
+
+    private static func isWhitespace(_ byte: UInt8) -> Bool {
+        return byte == 0x20 || (byte >= 0x09 && byte <= 0x0D)
+    }
+}
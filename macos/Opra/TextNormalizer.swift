@@ -0,0 +1,273 @@
+//
+//  TextNormalizer.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+
+/// Rewrites extracted text into something a speech synthesizer reads well, in one linear pass.
+///
+/// The LaTeX commands and Unicode math symbols in `mathRules` are compiled once into a trie over
+/// Unicode scalars. At every position the longest matching rule wins, and commands that end in a
+/// letter only match at a word boundary, so `\in` leaves `\int` and `\infty` alone. Whitespace runs
+/// are collapsed and the result is trimmed in the same pass.
+final class TextNormalizer {
+    struct Options: OptionSet {
+        let rawValue: Int
+
+        /// Drops control, zero-width and directional formatting characters, and replaces exotic
+        /// spaces and anything outside letters, digits, punctuation and symbols with a space
+        static let speechSafe = Options(rawValue: 1 << 0)
+    }
+
+    struct Rule {
+        let pattern: String
+        let replacement: String
+    }
+
+    static let shared = TextNormalizer(rules: mathRules)
+
+    static let mathRules: [Rule] = [
+        // LaTeX math delimiters
+        Rule(pattern: "\\(", replacement: " ("),
+        Rule(pattern: "\\)", replacement: ") "),
+        Rule(pattern: "\\[", replacement: " ["),
+        Rule(pattern: "\\]", replacement: "] "),
+        Rule(pattern: "$$", replacement: " "),
+        Rule(pattern: "$", replacement: " "),
+
+        // Common LaTeX commands
+        Rule(pattern: "\\frac{", replacement: " fraction "),
+        Rule(pattern: "\\sqrt{", replacement: " square root of "),
+        Rule(pattern: "\\sum", replacement: " sum "),
+        Rule(pattern: "\\int", replacement: " integral "),
+        Rule(pattern: "\\lim", replacement: " limit "),
+        Rule(pattern: "\\infty", replacement: " infinity "),
+        Rule(pattern: "\\alpha", replacement: " alpha "),
+        Rule(pattern: "\\beta", replacement: " beta "),
+        Rule(pattern: "\\gamma", replacement: " gamma "),
+        Rule(pattern: "\\delta", replacement: " delta "),
+        Rule(pattern: "\\epsilon", replacement: " epsilon "),
+        Rule(pattern: "\\theta", replacement: " theta "),
+        Rule(pattern: "\\lambda", replacement: " lambda "),
+        Rule(pattern: "\\mu", replacement: " mu "),
+        Rule(pattern: "\\pi", replacement: " pi "),
+        Rule(pattern: "\\sigma", replacement: " sigma "),
+        Rule(pattern: "\\tau", replacement: " tau "),
+        Rule(pattern: "\\phi", replacement: " phi "),
+        Rule(pattern: "\\omega", replacement: " omega "),
+
+        // Mathematical operators
+        Rule(pattern: "\\times", replacement: " times "),
+        Rule(pattern: "\\div", replacement: " divided by "),
+        Rule(pattern: "\\pm", replacement: " plus or minus "),
+        Rule(pattern: "\\mp", replacement: " minus or plus "),
+        Rule(pattern: "\\leq", replacement: " less than or equal to "),
+        Rule(pattern: "\\geq", replacement: " greater than or equal to "),
+        Rule(pattern: "\\neq", replacement: " not equal to "),
+        Rule(pattern: "\\approx", replacement: " approximately equal to "),
+        Rule(pattern: "\\equiv", replacement: " equivalent to "),
+        Rule(pattern: "\\propto", replacement: " proportional to "),
+        Rule(pattern: "\\in", replacement: " in "),
+        Rule(pattern: "\\notin", replacement: " not in "),
+        Rule(pattern: "\\subset", replacement: " subset of "),
+        Rule(pattern: "\\supset", replacement: " superset of "),
+        Rule(pattern: "\\cup", replacement: " union "),
+        Rule(pattern: "\\cap", replacement: " intersection "),
+        Rule(pattern: "\\emptyset", replacement: " empty set "),
+        Rule(pattern: "\\forall", replacement: " for all "),
+        Rule(pattern: "\\exists", replacement: " there exists "),
+        Rule(pattern: "\\rightarrow", replacement: " implies "),
+        Rule(pattern: "\\leftarrow", replacement: " implied by "),
+        Rule(pattern: "\\leftrightarrow", replacement: " if and only if "),
+
+        // Superscripts and subscripts
+        Rule(pattern: "^{", replacement: " to the power of "),
+        Rule(pattern: "_{", replacement: " sub "),
+        Rule(pattern: "}", replacement: " "),
+
+        // Unicode math symbols
+        Rule(pattern: "∑", replacement: " sum "),
+        Rule(pattern: "∏", replacement: " product "),
+        Rule(pattern: "∫", replacement: " integral "),
+        Rule(pattern: "√", replacement: " square root "),
+        Rule(pattern: "∞", replacement: " infinity "),
+        Rule(pattern: "α", replacement: " alpha "),
+        Rule(pattern: "β", replacement: " beta "),
+        Rule(pattern: "γ", replacement: " gamma "),
+        Rule(pattern: "δ", replacement: " delta "),
+        Rule(pattern: "ε", replacement: " epsilon "),
+        Rule(pattern: "θ", replacement: " theta "),
+        Rule(pattern: "λ", replacement: " lambda "),
+        Rule(pattern: "μ", replacement: " mu "),
+        Rule(pattern: "π", replacement: " pi "),
+        Rule(pattern: "σ", replacement: " sigma "),
+        Rule(pattern: "τ", replacement: " tau "),
+        Rule(pattern: "φ", replacement: " phi "),
+        Rule(pattern: "ω", replacement: " omega "),
+        Rule(pattern: "×", replacement: " times "),
+        Rule(pattern: "÷", replacement: " divided by "),
+        Rule(pattern: "±", replacement: " plus or minus "),
+        Rule(pattern: "≤", replacement: " less than or equal to "),
+        Rule(pattern: "≥", replacement: " greater than or equal to "),
+        Rule(pattern: "≠", replacement: " not equal to "),
+        Rule(pattern: "≈", replacement: " approximately equal to "),
+        Rule(pattern: "≡", replacement: " equivalent to "),
+        Rule(pattern: "∝", replacement: " proportional to "),
+        Rule(pattern: "∈", replacement: " in "),
+        Rule(pattern: "∉", replacement: " not in "),
+        Rule(pattern: "⊂", replacement: " subset of "),
+        Rule(pattern: "⊃", replacement: " superset of "),
+        Rule(pattern: "∪", replacement: " union "),
+        Rule(pattern: "∩", replacement: " intersection "),
+        Rule(pattern: "∅", replacement: " empty set "),
+        Rule(pattern: "∀", replacement: " for all "),
+        Rule(pattern: "∃", replacement: " there exists "),
+        Rule(pattern: "→", replacement: " implies "),
+        Rule(pattern: "←", replacement: " implied by "),
+        Rule(pattern: "↔", replacement: " if and only if "),
+    ]
+
+    private struct Node {
+        var children: [Unicode.Scalar: Int] = [:]
+        var rule: Int? // rule whose pattern ends at this node
+    }
+
+    private enum SpeechClass {
+        case keep
+        case space
+        case remove
+    }
+
+    private let nodes: [Node]
+    private let replacements: [[Unicode.Scalar]]
+    private let needsWordBoundary: [Bool]
+
+    private static let speakableCharacters = CharacterSet.alphanumerics
+        .union(.whitespacesAndNewlines)
+        .union(.punctuationCharacters)
+        .union(.symbols)
+
+    init(rules: [Rule]) {
+        var nodes = [Node()]
+        for (ruleIndex, rule) in rules.enumerated() {
+            var node = 0
+            for scalar in rule.pattern.unicodeScalars {
+                if let child = nodes[node].children[scalar] {
+                    node = child
+                } else {
+                    nodes.append(Node())
+                    nodes[node].children[scalar] = nodes.count - 1
+                    node = nodes.count - 1
+                }
+            }
+            // The first rule for a pattern wins, like the first replacement in a chain would
+            if nodes[node].rule == nil {
+                nodes[node].rule = ruleIndex
+            }
+        }
+        self.nodes = nodes
+        self.replacements = rules.map { Array($0.replacement.unicodeScalars) }
+        // `\in` must not match the start of `\int`; symbols and `\frac{`-style rules match anywhere
+        self.needsWordBoundary = rules.map { rule in
+            rule.pattern.unicodeScalars.last.map(Self.isLatexLetter) ?? false
+        }
+    }
+
+    func normalize(_ text: String, options: Options = []) -> String {
+        let scalars = text.unicodeScalars
+        let isSpeechSafe = options.contains(.speechSafe)
+
+        var output = String.UnicodeScalarView()
+        output.reserveCapacity(text.utf8.count)
+
+        // Whitespace is held back until the next visible character, which trims both ends and turns
+        // runs of two or more whitespace characters into a single space
+        var hasContent = false
+        var pendingWhitespace: Unicode.Scalar = " "
+        var pendingWhitespaceCount = 0
+
+        func emit(_ scalar: Unicode.Scalar) {
+            if scalar.properties.isWhitespace {
+                guard hasContent else { return }
+                if pendingWhitespaceCount == 0 {
+                    pendingWhitespace = scalar
+                }
+                pendingWhitespaceCount += 1
+                return
+            }
+            if pendingWhitespaceCount > 0 {
+                output.append(pendingWhitespaceCount == 1 ? pendingWhitespace : " ")
+                pendingWhitespaceCount = 0
+            }
+            output.append(scalar)
+            hasContent = true
+        }
+
+        var index = scalars.startIndex
+        while index < scalars.endIndex {
+            if let match = longestMatch(at: index, in: scalars) {
+                for scalar in replacements[match.rule] {
+                    emit(scalar)
+                }
+                index = match.end
+                continue
+            }
+
+            let scalar = scalars[index]
+            index = scalars.index(after: index)
+
+            if isSpeechSafe {
+                switch Self.speechClass(of: scalar) {
+                case .keep:
+                    emit(scalar)
+                case .space:
+                    emit(" ")
+                case .remove:
+                    break
+                }
+            } else {
+                emit(scalar)
+            }
+        }
+
+        return String(output)
+    }
+
+    private func longestMatch(at start: String.UnicodeScalarView.Index, in scalars: String.UnicodeScalarView) -> (rule: Int, end: String.UnicodeScalarView.Index)? {
+        var node = 0
+        var index = start
+        var match: (rule: Int, end: String.UnicodeScalarView.Index)?
+
+        while index < scalars.endIndex, let child = nodes[node].children[scalars[index]] {
+            node = child
+            index = scalars.index(after: index)
+            if let rule = nodes[node].rule,
+               !needsWordBoundary[rule] || index == scalars.endIndex || !Self.isLatexLetter(scalars[index]) {
+                match = (rule, index)
+            }
+        }
+        return match
+    }
+
+    private static func isLatexLetter(_ scalar: Unicode.Scalar) -> Bool {
+        return (scalar >= "a" && scalar <= "z") || (scalar >= "A" && scalar <= "Z")
+    }
+
+    private static func speechClass(of scalar: Unicode.Scalar) -> SpeechClass {
+        switch scalar.value {
+        case 0x09, 0x0A, 0x0D, 0x20...0x7E:
+            return .keep
+        case 0x00...0x1F, 0x7F:
+            return .remove // Control characters
+        case 0x200B...0x200D, 0x2060, 0xFEFF, 0x202A...0x202E, 0x2066...0x2069:
+            return .remove // Zero-width and directional formatting characters
+        case 0xA0, 0x2000...0x200F, 0x2028...0x202F, 0x205F...0x206F, 0x3000:
+            return .space // Unicode spaces and separators
+        default:
+            return speakableCharacters.contains(scalar) ? .keep : .space
+        }
+    }
+}
@@ -0,0 +1,388 @@
+//
+//  TextStore.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import os
+
+/// The assembled text of a document: immutable UTF-8, memory-mapped, with offset tables for its
+/// pages, paragraphs, sentences and words.
+///
+/// The text is written once to a file in the extraction cache directory, mapped, and the file is
+/// unlinked right away, so only the parts being chunked, spoken or shown are resident and the
+/// kernel can drop them again under memory pressure. Chunks, seek positions and the speech
+/// managers hold `TextRange` handles into a store instead of copies of the text. Every offset is
+/// a UTF-8 byte offset from the start of the store. Safe to share between threads.
+final class TextStore: @unchecked Sendable {
+    /// Zero-based pages the text was assembled from
+    let pageRange: Range<Int>
+    /// Offset of each page, plus the end of the text
+    let pageOffsets: [Int]
+
+    private let data: Data
+    let count: Int
+
+    // Built the first time they are needed
+    private var wordTable: (starts: ContiguousArray<UInt32>, ends: ContiguousArray<UInt32>)?
+    private var paragraphTable: [Int]?
+    private var sentenceTable: [Int]?
+    private let lock = NSLock()
+
+    private init(data: Data, count: Int, pageRange: Range<Int>, pageOffsets: [Int]) {
+        self.data = data
+        self.count = count
+        self.pageRange = pageRange
+        self.pageOffsets = pageOffsets
+    }
+
+    /// A store with no pages, assembled from `firstPage` on
+    convenience init(firstPage: Int = 0) {
+        self.init(data: Data(), count: 0, pageRange: firstPage..<firstPage, pageOffsets: [0])
+    }
+
+    /// A store holding `text` in memory, as a single page. For text that is not assembled from a
+    /// document, like a single utterance.
+    convenience init(_ text: String) {
+        let data = Data(text.utf8)
+        self.init(data: data, count: data.count, pageRange: 0..<1, pageOffsets: [0, data.count])
+    }
+
+    var isEmpty: Bool {
+        return count == 0
+    }
+
+    /// The whole text
+    var all: TextRange {
+        return TextRange(store: self, bytes: 0..<count)
+    }
+
+    subscript(bytes: Range<Int>) -> TextRange {
+        return TextRange(store: self, bytes: bytes.clamped(to: 0..<count))
+    }
+
+    /// Decodes a range of the text. Only the touched part of the mapping is paged in.
+    func string(in bytes: Range<Int>) -> String {
+        let bytes = bytes.clamped(to: 0..<count)
+        return String(decoding: data[(data.startIndex + bytes.lowerBound)..<(data.startIndex + bytes.upperBound)], as: UTF8.self)
+    }
+
+    func withBytes<Result>(_ body: (UnsafeBufferPointer<UInt8>) throws -> Result) rethrows -> Result {
+        return try data.withUnsafeBytes { raw in
+            try body(UnsafeBufferPointer(rebasing: raw.bindMemory(to: UInt8.self)[0..<count]))
+        }
+    }
+
+    /// The first `pages` pages, sharing this store's mapping
+    func prefix(pages: Int) -> TextStore {
+        let pages = max(0, min(pages, pageRange.count))
+        return TextStore(data: data, count: pageOffsets[pages],
+                         pageRange: pageRange.lowerBound..<(pageRange.lowerBound + pages),
+                         pageOffsets: Array(pageOffsets[0...pages]))
+    }
+
+    // MARK: - Pages
+
+    /// Slot in `pageOffsets` of the page whose text contains `offset`
+    func pageSlot(containing offset: Int) -> Int {
+        var lower = 0
+        var upper = max(0, pageOffsets.count - 2)
+        while lower < upper {
+            let middle = (lower + upper) / 2
+            if pageOffsets[middle + 1] > offset {
+                upper = middle
+            } else {
+                lower = middle + 1
+            }
+        }
+        return lower
+    }
+
+    // MARK: - Words
+
+    /// Words are separated by the same characters as in `WordIndex`, so counts agree with it
+    var wordCount: Int {
+        return words.starts.count
+    }
+
+    func wordRange(at index: Int) -> Range<Int> {
+        let words = self.words
+        return Int(words.starts[index])..<Int(words.ends[index])
+    }
+
+    /// Index of the first word that ends after `offset`: the word containing it, or the next one
+    /// when `offset` falls between words. `wordCount` if there is none.
+    func firstWord(atOrAfter offset: Int) -> Int {
+        let ends = words.ends
+        var lower = 0
+        var upper = ends.count
+        while lower < upper {
+            let middle = (lower + upper) / 2
+            if Int(ends[middle]) <= offset {
+                lower = middle + 1
+            } else {
+                upper = middle
+            }
+        }
+        return lower
+    }
+
+    private var words: (starts: ContiguousArray<UInt32>, ends: ContiguousArray<UInt32>) {
+        lock.lock()
+        defer { lock.unlock() }
+        if let wordTable = wordTable {
+            return wordTable
+        }
+        var starts = ContiguousArray<UInt32>()
+        var ends = ContiguousArray<UInt32>()
+        withBytes { bytes in
+            var wordStart = -1
+            var index = 0
+            while index < bytes.count {
+                let length = Self.whitespaceLength(in: bytes, at: index)
+                if length > 0 {
+                    if wordStart >= 0 {
+                        starts.append(UInt32(wordStart))
+                        ends.append(UInt32(index))
+                        wordStart = -1
+                    }
+                    index += length
+                } else {
+                    if wordStart < 0 {
+                        wordStart = index
+                    }
+                    index += 1
+                }
+            }
+            if wordStart >= 0 {
+                starts.append(UInt32(wordStart))
+                ends.append(UInt32(bytes.count))
+            }
+        }
+        wordTable = (starts, ends)
+        return (starts, ends)
+    }
+
+    // MARK: - Paragraphs and Sentences
+
+    /// Offset of each paragraph. Paragraphs start after a blank line, so every page starts one.
+    var paragraphOffsets: [Int] {
+        lock.lock()
+        defer { lock.unlock() }
+        if let paragraphTable = paragraphTable {
+            return paragraphTable
+        }
+        var offsets: [Int] = []
+        withBytes { bytes in
+            var newlines = 2 // The start of the text counts as a paragraph break
+            for (offset, byte) in bytes.enumerated() {
+                if byte == UInt8(ascii: "\n") {
+                    newlines += 1
+                } else if byte != UInt8(ascii: " ") && byte != UInt8(ascii: "\t") && byte != UInt8(ascii: "\r") {
+                    if newlines >= 2 {
+                        offsets.append(offset)
+                    }
+                    newlines = 0
+                }
+            }
+        }
+        paragraphTable = offsets
+        return offsets
+    }
+
+    /// Offset of each sentence. A sentence starts at a paragraph, or at the first non-space
+    /// character after a run of `.`, `!` or `?` (and closing quotes or brackets) that is followed
+    /// by whitespace.
+    var sentenceOffsets: [Int] {
+        let paragraphs = paragraphOffsets
+        lock.lock()
+        defer { lock.unlock() }
+        if let sentenceTable = sentenceTable {
+            return sentenceTable
+        }
+        var offsets: [Int] = []
+        withBytes { bytes in
+            var nextParagraph = 0
+            var afterCloser = false
+            var sawSpace = false
+            for (offset, byte) in bytes.enumerated() {
+                let isSpace = byte == UInt8(ascii: " ") || byte == UInt8(ascii: "\n") || byte == UInt8(ascii: "\t") || byte == UInt8(ascii: "\r")
+                if nextParagraph < paragraphs.count && paragraphs[nextParagraph] == offset {
+                    offsets.append(offset)
+                    nextParagraph += 1
+                    afterCloser = false
+                    sawSpace = false
+                } else if isSpace {
+                    sawSpace = afterCloser
+                    continue
+                } else if sawSpace {
+                    offsets.append(offset)
+                    afterCloser = false
+                    sawSpace = false
+                }
+                if byte == UInt8(ascii: ".") || byte == UInt8(ascii: "!") || byte == UInt8(ascii: "?") {
+                    afterCloser = true
+                } else if afterCloser && (byte == UInt8(ascii: "\"") || byte == UInt8(ascii: "'") || byte == UInt8(ascii: ")") || byte == UInt8(ascii: "]")) {
+                    continue // Still part of the sentence that just closed
+                } else {
+                    afterCloser = false
+                }
+            }
+        }
+        sentenceTable = offsets
+        return offsets
+    }
+
+    /// Length of the whitespace character at `index`, or 0 if it is not one. The set matches
+    /// `CharacterSet.whitespacesAndNewlines`, decoded from UTF-8.
+    private static func whitespaceLength(in bytes: UnsafeBufferPointer<UInt8>, at index: Int) -> Int {
+        let byte = bytes[index]
+        switch byte {
+        case 0x09...0x0D, 0x20:
+            return 1
+        case 0xC2 where index + 1 < bytes.count:
+            return bytes[index + 1] == 0x85 || bytes[index + 1] == 0xA0 ? 2 : 0 // U+0085, U+00A0
+        case 0xE1 where index + 2 < bytes.count:
+            return bytes[index + 1] == 0x9A && bytes[index + 2] == 0x80 ? 3 : 0 // U+1680
+        case 0xE2 where index + 2 < bytes.count:
+            let second = bytes[index + 1], third = bytes[index + 2]
+            if second == 0x80 && (third <= 0x8A || third == 0xA8 || third == 0xA9 || third == 0xAF) {
+                return 3 // U+2000...U+200A, U+2028, U+2029, U+202F
+            }
+            return second == 0x81 && third == 0x9F ? 3 : 0 // U+205F
+        case 0xE3 where index + 2 < bytes.count:
+            return bytes[index + 1] == 0x80 && bytes[index + 2] == 0x80 ? 3 : 0 // U+3000
+        default:
+            return 0
+        }
+    }
+
+    // MARK: - Building
+
+    /// Writes the text of a new store page by page. The text goes to disk in blocks as it is
+    /// appended, so building never holds more than one block in memory beyond the pages it is
+    /// handed. If the file can't be created, the store is built in memory instead.
+    struct Builder {
+        static let blockSize = 1 << 20
+
+        private let fileURL: URL
+        private var handle: FileHandle?
+        private var block = Data()
+        private var count = 0
+        private let firstPage: Int
+        private var pageOffsets = [0]
+        private var isLost = false // The written text could not be read back
+
+        init(firstPage: Int, directory: URL = ExtractionCache.shared.directory) {
+            self.firstPage = firstPage
+            fileURL = directory.appendingPathComponent("\(UUID().uuidString).opratext")
+            if FileManager.default.createFile(atPath: fileURL.path, contents: nil) {
+                handle = try? FileHandle(forWritingTo: fileURL)
+            }
+        }
+
+        /// Appends the next page. An empty string still counts as a page.
+        mutating func appendPage(_ text: String) {
+            guard !isLost else { return }
+            append(Data(text.utf8))
+            guard !isLost else { return }
+            pageOffsets.append(count)
+        }
+
+        /// Appends pages `slots` of `store`, copying their bytes through its mapping
+        mutating func appendPages(_ slots: Range<Int>, of store: TextStore) {
+            guard !slots.isEmpty, !isLost else { return }
+            let start = store.pageOffsets[slots.lowerBound]
+            let end = store.pageOffsets[slots.upperBound]
+            store.withBytes { bytes in
+                var offset = start
+                while offset < end {
+                    let length = min(Self.blockSize, end - offset)
+                    append(Data(buffer: UnsafeBufferPointer(rebasing: bytes[offset..<(offset + length)])))
+                    guard !isLost else { return }
+                    offset += length
+                }
+            }
+            guard !isLost else { return }
+            let shift = count - end
+            pageOffsets += store.pageOffsets[(slots.lowerBound + 1)...slots.upperBound].map { $0 + shift }
+        }
+
+        /// Maps the written text and removes the file; the mapping stays valid without it
+        func finish() -> TextStore {
+            guard !isLost else {
+                return TextStore(data: Data(), count: 0, pageRange: firstPage..<firstPage, pageOffsets: [0])
+            }
+            let pages = firstPage..<(firstPage + pageOffsets.count - 1)
+            guard let handle = handle else {
+                return TextStore(data: block, count: count, pageRange: pages, pageOffsets: pageOffsets)
+            }
+            defer { try? FileManager.default.removeItem(at: fileURL) }
+            do {
+                try handle.write(contentsOf: block)
+                try handle.close()
+                let mapped = count == 0 ? Data() : try Data(contentsOf: fileURL, options: .alwaysMapped)
+                return TextStore(data: mapped, count: count, pageRange: pages, pageOffsets: pageOffsets)
+            } catch {
+                // Fall back to memory like `append` does, with what was written plus the last block
+                Log.cache.error("Could not map the assembled text: \(error.localizedDescription, privacy: .public)")
+                try? handle.close()
+                let writtenCount = count - block.count
+                guard let written = try? Data(contentsOf: fileURL), written.count >= writtenCount else {
+                    return TextStore(data: Data(), count: 0, pageRange: firstPage..<firstPage, pageOffsets: [0])
+                }
+                return TextStore(data: written.prefix(writtenCount) + block, count: count, pageRange: pages, pageOffsets: pageOffsets)
+            }
+        }
+
+        private mutating func append(_ bytes: Data) {
+            block.append(bytes)
+            count += bytes.count
+            guard let handle = handle, block.count >= Self.blockSize else { return }
+            do {
+                try handle.write(contentsOf: block)
+                block.removeAll(keepingCapacity: true)
+            } catch {
+                // Carry on in memory with what was written so far
+                Log.cache.error("Could not write the assembled text: \(error.localizedDescription, privacy: .public)")
+                try? handle.close()
+                self.handle = nil
+                let writtenCount = count - block.count
+                if let written = try? Data(contentsOf: fileURL), written.count >= writtenCount {
+                    block = written.prefix(writtenCount) + block
+                } else {
+                    // Without the written pages the offsets would point past the text: give up
+                    // on the store, which `finish` then returns empty
+                    isLost = true
+                    block = Data()
+                    count = 0
+                    pageOffsets = [0]
+                }
+                try? FileManager.default.removeItem(at: fileURL)
+            }
+        }
+    }
+}
+
+/// A range of a `TextStore`: what chunks and seek positions hand around instead of strings. It
+/// keeps the store alive, not a copy of the text.
+struct TextRange {
+    let store: TextStore
+    let bytes: Range<Int>
+
+    var isEmpty: Bool {
+        return bytes.isEmpty
+    }
+
+    /// The text of the range, decoded on demand
+    var string: String {
+        return store.string(in: bytes)
+    }
+
+    /// The rest of the range from `offset` on
+    func suffix(from offset: Int) -> TextRange {
+        return TextRange(store: store, bytes: min(max(offset, bytes.lowerBound), bytes.upperBound)..<bytes.upperBound)
+    }
+}
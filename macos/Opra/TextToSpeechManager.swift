@@ -8,26 +8,47 @@
 import Foundation
 import AVFoundation
 import Speech
+import os
 
 @MainActor class TextToSpeechManager: NSObject, ObservableObject {
     @Published var isSpeaking: Bool = false
     @Published var isPaused: Bool = false
     @Published var speechRate: Float = 0.5
     @Published var currentVoice: AVSpeechSynthesisVoice?
-    @Published var readingProgress: Double = 0.0
-    @Published var currentWordIndex: Int = 0
-    @Published var totalWords: Int = 0
     @Published var isPersonalVoiceAuthorized: Bool = false
     @Published var personalVoiceStatus: String = "Not requested"
     @Published var enableSSML: Bool = false
-    @Published var elapsedTime: TimeInterval = 0.0
+    
+    // Change with every word and timer tick, so they are published through `telemetry` instead
+    let telemetry = PlaybackTelemetry()
+    private(set) var readingProgress: Double = 0.0 {
+        didSet { telemetry.report(readingProgress: readingProgress) }
+    }
+    private(set) var currentWordIndex: Int = 0 {
+        didSet { telemetry.report(currentWordIndex: currentWordIndex) }
+    }
+    private(set) var totalWords: Int = 0 {
+        didSet { telemetry.report(totalWords: totalWords) }
+    }
+    private(set) var elapsedTime: TimeInterval = 0.0 {
+        didSet { telemetry.report(elapsedTime: elapsedTime) }
+    }
+    
+    /// What is being spoken: a chunk of the selected text (0 for unchunked text), or a streamed page
+    enum SpokenSegment: Equatable {
+        case chunk(Int)
+        case page(Int)
+    }
+    private(set) var currentSegment: SpokenSegment?
     
     private let synthesizer = AVSpeechSynthesizer()
     private var currentUtterance: AVSpeechUtterance?
     private var settingsManager: SettingsManager?
     private var fullText: String = ""
-    private var words: [String] = []
-    private var progressTimer: DispatchSourceTimer?
+    private var words = WordIndex.empty
+    private var wordOffset = 0 // words of the segment skipped by a seek, added to reported indices
+    private var pendingWordIndex: Int?
+    private var progressFlushTask: Task<Void, Never>?
     private var utteranceStartDate: Date?
     private var pausedTime: TimeInterval = 0.0
     private var totalPausedTime: TimeInterval = 0.0
@@ -36,15 +57,43 @@ import Speech
     
     // Chunking support
     private var isChunked: Bool = false
-    private var chunkedTexts: [String] = []
+    private var chunkedTexts: [TextRange] = []
     private var currentChunk: Int = 0
     private var totalChunks: Int = 0
     private var chunkCompletionHandler: (() -> Void)?
     private var pdfExtractor: PDFTextExtractor?
     
+    // Look-ahead support: streamed pages and chunks are queued on the synthesizer ahead of playback
+    private var pageQueue: ExtractedPageQueue?
+    private var streamingTask: Task<Void, Never>?
+    private var streamingUtterances: [ObjectIdentifier: QueuedSegment] = [:]
+    private var streamSlotWaiter: CheckedContinuation<Void, Never>?
+    private var isStreamExhausted: Bool = false
+    private let maxQueuedStreamUtterances = 2
+    private static let progressFrameInterval: UInt64 = 16_666_667 // one 60 Hz frame, in nanoseconds
+    
+    // Open signpost intervals per utterance: waiting to start, then speaking
+    private var pendingUtteranceIntervals: [ObjectIdentifier: OSSignpostIntervalState] = [:]
+    private var utteranceIntervals: [ObjectIdentifier: OSSignpostIntervalState] = [:]
+    
+    // Rate changes while speaking: the synthesizer keeps an utterance's rate, so the rest of the
+    // text is spoken again at the new rate from the next sentence
+    private var rateChangeWord: Int? // word being spoken when the rate changed
+    private var replacedUtterances: [ObjectIdentifier: AVSpeechUtterance] = [:] // cancelled by a rate change
+    private var carriedElapsedTime: (utterance: ObjectIdentifier, elapsed: TimeInterval)?
+    private let maxWordsBeforeRateChange = 30 // applied mid-sentence after this many words
+    
+    private struct QueuedSegment {
+        let index: Int // page number when streaming pages, chunk index when speaking chunks
+        let words: WordIndex // word offsets of the preprocessed text
+        let wordOffset: Int // words of the page or chunk before the text, when it starts mid-way
+        let utterance: AVSpeechUtterance
+    }
+    
     override init() {
         super.init()
         synthesizer.delegate = self
+        VoiceCatalog.shared.prefetch()
         setupDefaultVoice()
         checkPersonalVoiceAuthorization()
     }
@@ -63,13 +112,13 @@ import Speech
     }
     
     private func setupDefaultVoice() {
-        // Try to get a high-quality English voice
+        // Try to get a high-quality English voice; looking one up by language doesn't enumerate them all
         if let voice = AVSpeechSynthesisVoice(language: "en-US") {
             currentVoice = voice
-        } else if let voice = AVSpeechSynthesisVoice.speechVoices().first(where: { $0.language.hasPrefix("en") }) {
+        } else if let voice = VoiceCatalog.shared.englishVoices.first {
             currentVoice = voice
         } else {
-            currentVoice = AVSpeechSynthesisVoice.speechVoices().first
+            currentVoice = VoiceCatalog.shared.voices.first
         }
     }
     
@@ -80,7 +129,6 @@ import Speech
     func speak(_ text: String, chunkCompletionHandler: (() -> Void)?) {
         // Store chunk completion handler BEFORE stopping speech
         self.chunkCompletionHandler = chunkCompletionHandler
-        print("Set chunk completion handler: \(chunkCompletionHandler != nil)")
         
         // Stop any current speech and tracking first on the main actor
         stopSpeaking()
@@ -95,7 +143,7 @@ import Speech
         // Validate input text quickly on main
         let trimmed = text.trimmingCharacters(in: .whitespacesAndNewlines)
         guard !trimmed.isEmpty else {
-            print("Warning: Attempting to speak empty text")
+            Log.speech.notice("Nothing to speak: the text is empty")
             return
         }
 
@@ -103,37 +151,25 @@ import Speech
         Task(priority: .userInitiated) { [weak self] in
             guard let self else { return }
             let processedText = self.preprocessTextForTTS(trimmed)
+            let processedWords = WordIndex(processedText)
 
             // Validate processed text
             guard !processedText.trimmingCharacters(in: .whitespacesAndNewlines).isEmpty else {
-                print("Warning: Processed text is empty after preprocessing")
+                Log.speech.notice("Nothing to speak: the text is empty after preprocessing")
                 return
             }
 
             // Switch back to the main actor to interact with AVSpeechSynthesizer and published properties
             await MainActor.run {
                 self.fullText = processedText
-                self.words = processedText.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }
+                self.words = processedWords
+                self.wordOffset = 0
                 self.totalWords = self.words.count
                 self.currentWordIndex = 0
                 self.readingProgress = 0.0
                 self.pausedTime = 0.0
                 self.totalPausedTime = 0.0
-                
-                // Debug information
-                print("TTS Debug - Original text length: \(text.count), Processed text length: \(processedText.count)")
-                print("TTS Debug - Word count: \(self.totalWords)")
-                print("TTS Debug - First 100 chars: \(String(processedText.prefix(100)))")
-                if processedText.count > 100 {
-                    print("TTS Debug - Last 100 chars: \(String(processedText.suffix(100)))")
-                }
-                
-                // Check for potential issues in processed text
-                let hasEmptyLines = processedText.contains("\n\n\n")
-                let hasMultipleSpaces = processedText.contains("   ")
-                let hasSpecialChars = processedText.rangeOfCharacter(from: CharacterSet(charactersIn: "\u{00A0}\u{2000}-\u{200F}\u{2028}-\u{202F}\u{205F}-\u{206F}\u{3000}\u{FEFF}")) != nil
-                
-                print("TTS Debug - Has empty lines: \(hasEmptyLines), Multiple spaces: \(hasMultipleSpaces), Special chars: \(hasSpecialChars)")
+                Log.speech.debug("Speaking \(processedText.utf16.count) characters, \(self.totalWords) words")
                 
                 // Only reset chunking state for single text (not when called from chunked speech)
                 if chunkCompletionHandler == nil {
@@ -142,59 +178,22 @@ import Speech
                     self.currentChunk = 0
                     self.totalChunks = 0
                 }
+                self.currentSegment = .chunk(self.currentChunk)
 
-                var utterance: AVSpeechUtterance
-                
-                if self.enableSSML {
-                    // Create SSML utterance
-                    let ssmlText = self.createSSMLFromText(processedText)
-                    print("TTS Debug - Using SSML: \(String(ssmlText.prefix(200)))...")
-                    
-                    if self.validateSSML(ssmlText), let ssmlUtterance = AVSpeechUtterance(ssmlRepresentation: ssmlText) {
-                        utterance = ssmlUtterance
-                        // Note: When using SSML, rate, pitchMultiplier, and volume are controlled by SSML
-                        // The voice property may be overridden by SSML voice tags
-                    } else {
-                        print("TTS Debug - SSML validation failed or unsupported, falling back to regular utterance")
-                        utterance = AVSpeechUtterance(string: processedText)
-                        utterance.voice = self.currentVoice
-                        utterance.rate = max(AVSpeechUtteranceMinimumSpeechRate, min(AVSpeechUtteranceMaximumSpeechRate, self.speechRate))
-                        utterance.pitchMultiplier = 1.0
-                        utterance.volume = 1.0
-                    }
-                } else {
-                    // Create regular utterance
-                    utterance = AVSpeechUtterance(string: processedText)
-                    utterance.voice = self.currentVoice
-                    utterance.rate = max(AVSpeechUtteranceMinimumSpeechRate, min(AVSpeechUtteranceMaximumSpeechRate, self.speechRate))
-                    utterance.pitchMultiplier = 1.0
-                    utterance.volume = 1.0
-                }
+                var utterance = self.makeSpeechUtterance(processedText)
 
                 // Validate utterance before speaking
-                guard !utterance.speechString.isEmpty else {
-                    print("Error: Utterance speech string is empty")
+                guard !utterance.speechString.trimmingCharacters(in: .whitespacesAndNewlines).isEmpty else {
+                    Log.speech.error("Utterance speech string is empty")
                     return
                 }
                 
-                // Additional validation for meaningful content
-                let trimmedSpeech = utterance.speechString.trimmingCharacters(in: .whitespacesAndNewlines)
-                guard !trimmedSpeech.isEmpty else {
-                    print("Error: Utterance speech string is empty after trimming")
-                    return
-                }
-                
-                // Check for potential issues that might cause TTS to stop
-                let hasControlChars = utterance.speechString.rangeOfCharacter(from: CharacterSet.controlCharacters) != nil
-                let hasInvalidChars = utterance.speechString.rangeOfCharacter(from: CharacterSet.illegalCharacters) != nil
-                let hasZeroWidthChars = utterance.speechString.rangeOfCharacter(from: CharacterSet(charactersIn: "\u{200B}\u{200C}\u{200D}\u{2060}\u{FEFF}")) != nil
-                
-                if hasControlChars {
-                    print("Warning: Utterance contains control characters that might cause issues")
-                    // Clean the utterance string if it has control characters
+                // Control characters can make the synthesizer stop early. Invalid and zero-width
+                // characters are already removed by the speech-safe normalization.
+                if utterance.speechString.rangeOfCharacter(from: CharacterSet.controlCharacters) != nil {
                     let cleanedString = utterance.speechString.replacingOccurrences(of: "[\u{00}-\u{08}\u{0B}\u{0C}\u{0E}-\u{1F}\u{7F}]", with: "", options: .regularExpression)
                     if cleanedString != utterance.speechString {
-                        print("TTS Debug - Cleaning utterance string from \(utterance.speechString.count) to \(cleanedString.count) characters")
+                        Log.speech.debug("Removed control characters from the utterance")
                         // Create a new utterance with cleaned string
                         let newUtterance = AVSpeechUtterance(string: cleanedString)
                         newUtterance.voice = utterance.voice
@@ -204,22 +203,11 @@ import Speech
                         utterance = newUtterance
                     }
                 }
-                if hasInvalidChars {
-                    print("Warning: Utterance contains invalid characters that might cause issues")
-                }
-                if hasZeroWidthChars {
-                    print("Warning: Utterance contains zero-width characters that might cause issues")
-                }
-                
-                // Check utterance string specifically
-                print("TTS Debug - Utterance string length: \(utterance.speechString.count)")
-                print("TTS Debug - Utterance first 50 chars: \(String(utterance.speechString.prefix(50)))")
-                print("TTS Debug - Final utterance validation passed, proceeding to speak")
 
                 self.currentUtterance = utterance
 
                 self.utteranceStartDate = Date()
-                self.synthesizer.speak(utterance)
+                self.speakSignposted(utterance)
 
                 // Start progress tracking on a user-initiated queue
                 self.startProgressTracking()
@@ -230,15 +218,159 @@ import Speech
         }
     }
     
-    func speakChunkedText(_ texts: [String], startChunk: Int = 0) {
-        print("=== STARTING CHUNKED SPEECH ===")
-        print("Starting chunked speech with \(texts.count) chunks, starting at chunk \(startChunk)")
+    /// Utterance for already preprocessed text, using SSML markup when it is enabled
+    private func makeSpeechUtterance(_ processedText: String) -> AVSpeechUtterance {
+        guard enableSSML else {
+            return makeUtterance(processedText)
+        }
+        
+        let ssmlText = createSSMLFromText(processedText)
+        
+        if validateSSML(ssmlText), let ssmlUtterance = AVSpeechUtterance(ssmlRepresentation: ssmlText) {
+            // Note: When using SSML, rate, pitchMultiplier, and volume are controlled by SSML
+            // The voice property may be overridden by SSML voice tags
+            return ssmlUtterance
+        }
+        Log.speech.notice("SSML rejected by the synthesizer, speaking plain text")
+        return makeUtterance(processedText)
+    }
+    
+    private func makeUtterance(_ text: String) -> AVSpeechUtterance {
+        let utterance = AVSpeechUtterance(string: text)
+        utterance.voice = currentVoice
+        utterance.rate = max(AVSpeechUtteranceMinimumSpeechRate, min(AVSpeechUtteranceMaximumSpeechRate, speechRate))
+        utterance.pitchMultiplier = 1.0
+        utterance.volume = 1.0
+        return utterance
+    }
+    
+    // MARK: - Look-ahead Speech
+    
+    /// Pages or chunks already handed to the synthesizer behind the one being spoken
+    var queuedAheadCount: Int {
+        return max(0, streamingUtterances.count - 1)
+    }
+    
+    /// Speaks pages from `queue` as the extractor produces them.
+    ///
+    /// Each page becomes its own utterance. At most `maxQueuedStreamUtterances` are handed to the
+    /// synthesizer ahead of playback, so the bounded page queue keeps extraction just ahead of speech.
+    func speakPageStream(_ queue: ExtractedPageQueue) {
+        Log.speech.debug("Speaking pages as they are extracted")
+        stopSpeaking()
+        
+        isChunked = false
+        chunkedTexts = []
+        currentChunk = 0
+        totalChunks = 0
+        chunkCompletionHandler = nil
+        
+        pageQueue = queue
+        startLookAheadSpeech {
+            await queue.next().map { (index: $0.pageNumber, text: $0.text, wordOffset: $0.firstWord) }
+        }
+    }
+    
+    /// Preprocesses and enqueues upcoming segments while earlier ones are still playing.
+    ///
+    /// `nextSegment` returns the next page or chunk to speak, or nil when there are none left. The
+    /// synthesizer plays queued utterances back to back, so there is no gap between segments and
+    /// preprocessing never sits on the critical path between them.
+    private func startLookAheadSpeech(_ nextSegment: @escaping () async -> (index: Int, text: String, wordOffset: Int)?) {
+        isStreamExhausted = false
+        streamingTask = Task { [weak self] in
+            while let segment = await nextSegment() {
+                guard let self, !Task.isCancelled else { return }
+                
+                // Normalize off the main actor while earlier segments are playing
+                let (processedText, processedWords) = await Task.detached(priority: .userInitiated) {
+                    let processedText = self.preprocessTextForTTS(segment.text)
+                    return (processedText, WordIndex(processedText))
+                }.value
+                
+                await self.waitForStreamSlot()
+                guard !Task.isCancelled else { return }
+                self.enqueueStreamUtterance(processedText, words: processedWords, index: segment.index, wordOffset: segment.wordOffset)
+            }
+            
+            guard let self, !Task.isCancelled else { return }
+            self.isStreamExhausted = true
+            if self.streamingUtterances.isEmpty {
+                self.finishPageStream()
+            }
+        }
+    }
+    
+    private func waitForStreamSlot() async {
+        while streamingUtterances.count >= maxQueuedStreamUtterances && !Task.isCancelled {
+            await withCheckedContinuation { continuation in
+                streamSlotWaiter = continuation
+            }
+        }
+    }
+    
+    private func enqueueStreamUtterance(_ text: String, words: WordIndex, index: Int, wordOffset: Int) {
+        let utterance = makeSpeechUtterance(text)
+        streamingUtterances[ObjectIdentifier(utterance)] = QueuedSegment(index: index, words: words, wordOffset: wordOffset, utterance: utterance)
+        Log.speech.debug("Queued \(self.isChunked ? "chunk" : "page", privacy: .public) \(self.isChunked ? index + 1 : index) (\(self.streamingUtterances.count) queued)")
+        speakSignposted(utterance)
+    }
+    
+    private func handleStreamUtteranceFinished() {
+        if let waiter = streamSlotWaiter {
+            streamSlotWaiter = nil
+            waiter.resume()
+        }
+        if streamingUtterances.isEmpty && isStreamExhausted {
+            finishPageStream()
+        }
+    }
+    
+    private func finishPageStream() {
+        Log.speech.debug("Finished speaking every \(self.isChunked ? "chunk" : "page", privacy: .public)")
+        if isChunked {
+            isChunked = false
+            chunkedTexts = []
+            currentChunk = 0
+            totalChunks = 0
+        }
+        pageQueue = nil
+        streamingTask = nil
+        isStreamExhausted = false
+        currentSegment = nil
+        isSpeaking = false
+        isPaused = false
+        currentUtterance = nil
+        cancelProgressUpdates()
+        stopElapsedTimeTracking()
+        utteranceStartDate = nil
+        elapsedTime = 0.0
+    }
+    
+    private func cancelPageStream() {
+        streamingTask?.cancel()
+        streamingTask = nil
+        pageQueue?.cancel()
+        pageQueue = nil
+        streamingUtterances.removeAll()
+        isStreamExhausted = false
+        if let waiter = streamSlotWaiter {
+            streamSlotWaiter = nil
+            waiter.resume()
+        }
+    }
+    
+    /// Speaks `texts` from chunk `startChunk` on. When the first chunk has been cut to start at a
+    /// seek position, `firstWordOffset` is the number of words cut, so progress still counts
+    /// words of the whole chunk.
+    func speakChunkedText(_ texts: [TextRange], startChunk: Int = 0, firstWordOffset: Int = 0) {
+        Log.speech.debug("Speaking \(texts.count) chunks from chunk \(startChunk + 1)")
         
         // Stop any current speech and tracking first on the main actor
         stopSpeaking()
         
         guard !texts.isEmpty else {
-            print("Warning: No chunks provided for chunked speech")
+            Log.speech.notice("Nothing to speak: no chunks")
             return
         }
         
@@ -248,119 +380,103 @@ import Speech
         self.currentChunk = startChunk
         self.totalChunks = texts.count
         
-        print("Chunking state set - isChunked: \(isChunked), totalChunks: \(totalChunks)")
-        print("Chunked texts count: \(chunkedTexts.count)")
+        // Seeks always take the look-ahead path, which starts speaking without the settle delay
+        guard (settingsManager?.enableGaplessChunks ?? true) || firstWordOffset > 0 else {
+            // Start with the first chunk
+            speakCurrentChunk()
+            return
+        }
         
-        // Start with the first chunk
-        speakCurrentChunk()
+        // Chunk N+1 is preprocessed and queued while chunk N plays
+        var nextChunk = startChunk
+        startLookAheadSpeech {
+            guard nextChunk < texts.count else { return nil }
+            defer { nextChunk += 1 }
+            return (index: nextChunk, text: texts[nextChunk].string, wordOffset: nextChunk == startChunk ? firstWordOffset : 0)
+        }
     }
     
     private func speakCurrentChunk() {
-        guard isChunked && currentChunk < chunkedTexts.count else {
-            print("No more chunks to speak")
-            return
-        }
+        guard isChunked && currentChunk < chunkedTexts.count else { return }
         
         let chunkText = chunkedTexts[currentChunk]
-        let wordCount = chunkText.components(separatedBy: .whitespacesAndNewlines).filter { !$0.isEmpty }.count
-        print("Speaking chunk \(currentChunk + 1) of \(totalChunks) (\(wordCount) words)")
+        Log.speech.debug("Speaking chunk \(self.currentChunk + 1) of \(self.totalChunks)")
         
         // Use the regular speak method but with chunk completion handler
-        print("Calling speak with chunk completion handler")
-        speak(chunkText) { [weak self] in
-            print("Chunk completion handler called")
+        speak(chunkText.string) { [weak self] in
             // Ensure we're still in chunked mode before handling completion
-            guard let self = self, self.isChunked else {
-                print("Chunk completion called but no longer in chunked mode")
-                return
-            }
+            guard let self = self, self.isChunked else { return }
             self.handleChunkCompletion()
         }
     }
     
     private func handleChunkCompletion() {
         guard isChunked else { 
-            print("Chunk completion called but not in chunked mode")
+            currentSegment = nil
             return 
         }
         
-        print("Chunk \(currentChunk + 1) completed")
         currentChunk += 1
         
         if currentChunk < totalChunks {
             // Move to next chunk with a small delay to prevent race conditions
-            print("Moving to chunk \(currentChunk + 1) of \(totalChunks)")
             DispatchQueue.main.asyncAfter(deadline: .now() + 0.1) { [weak self] in
                 self?.speakCurrentChunk()
             }
         } else {
             // All chunks completed
-            print("All chunks completed - TTS finished")
+            Log.speech.debug("Finished speaking every chunk")
             isChunked = false
             chunkedTexts = []
             currentChunk = 0
             totalChunks = 0
+            currentSegment = nil
         }
     }
     
+    /// Resets word tracking for a new utterance. Progress itself is driven by
+    /// `willSpeakRangeOfSpeechString`, so there is no polling timer.
     private func startProgressTracking() {
-        // Cancel any existing timers
-        progressTimer?.cancel()
-        progressTimer = nil
-        elapsedTimeTimer?.cancel()
-        elapsedTimeTimer = nil
-
-        // Create a timer on a user-initiated QoS queue to avoid priority inversion
-        let queue = DispatchQueue(label: "tts.progress.timer", qos: .userInitiated)
-        let timer = DispatchSource.makeTimerSource(queue: queue)
-        timer.schedule(deadline: .now() + 0.1, repeating: 0.1) // More frequent updates for better sync
-        timer.setEventHandler { [weak self] in
-            guard let self = self else { return }
-
-            // If not speaking, stop the timer
-            if !self.isSpeaking {
-                self.progressTimer?.cancel()
-                self.progressTimer = nil
-                return
-            }
-
-            // If paused, don't update progress
-            if self.isPaused {
-                return
-            }
-
-            guard self.currentUtterance != nil else { return }
-            let rate = max(AVSpeechUtteranceMinimumSpeechRate, min(AVSpeechUtteranceMaximumSpeechRate, self.speechRate))
-
-            // More accurate duration estimation based on words and rate
-            let wordsPerMinute = max(100.0, Double(rate) * 200.0) // More realistic WPM range
-            let wordsPerSecond = wordsPerMinute / 60.0
-            let estimatedDuration = max(1.0, Double(self.totalWords) / wordsPerSecond)
-            let start = self.utteranceStartDate ?? Date()
-            let elapsed = Date().timeIntervalSince(start)
-            
-            // Account for paused time
-            let actualElapsed = elapsed - self.totalPausedTime
-            let progress = min(1.0, max(0.0, actualElapsed / estimatedDuration))
-
-            // Publish updates on the main actor
-            Task { @MainActor in
-                self.readingProgress = progress
-                self.currentWordIndex = Int(progress * Double(self.totalWords))
-                
-                // Update PDF extractor with current word (only if follow text is enabled)
-                if self.settingsManager?.enableFollowText == true {
-                    self.pdfExtractor?.updateCurrentWord(self.currentWordIndex)
-                }
-            }
-        }
-        progressTimer = timer
-        timer.resume()
+        cancelProgressUpdates()
         
         // Start elapsed time timer
         startElapsedTimeTracking()
     }
     
+    /// Records the word being spoken and publishes it at most once per display frame
+    private func scheduleProgressUpdate(wordIndex: Int) {
+        pendingWordIndex = wordIndex
+        guard progressFlushTask == nil else { return }
+        
+        progressFlushTask = Task { [weak self] in
+            try? await Task.sleep(nanoseconds: Self.progressFrameInterval)
+            guard let self, !Task.isCancelled else { return }
+            self.progressFlushTask = nil
+            self.publishPendingProgress()
+        }
+    }
+    
+    private func publishPendingProgress() {
+        guard let wordIndex = pendingWordIndex else { return }
+        pendingWordIndex = nil
+        
+        if currentWordIndex != wordIndex {
+            currentWordIndex = wordIndex
+        }
+        readingProgress = totalWords > 0 ? min(1.0, Double(wordIndex + 1) / Double(totalWords)) : 0.0
+        
+        // Update PDF extractor with current word (only if follow text is enabled)
+        if settingsManager?.enableFollowText == true {
+            pdfExtractor?.updateCurrentWord(wordIndex)
+        }
+    }
+    
+    private func cancelProgressUpdates() {
+        progressFlushTask?.cancel()
+        progressFlushTask = nil
+        pendingWordIndex = nil
+    }
+    
     private func startElapsedTimeTracking() {
         // Cancel any existing elapsed time timer
         elapsedTimeTimer?.cancel()
@@ -398,7 +514,6 @@ import Speech
         // Disable timeout timer for now - it was causing false positives
         // The TTS system should handle completion naturally through delegate methods
         // If needed, we can re-enable with much more conservative settings
-        print("TTS Debug - Timeout timer disabled to prevent false positives")
     }
     
     func pauseSpeaking() {
@@ -418,28 +533,61 @@ import Speech
     }
     
     func stopSpeaking() {
-        print("TTS Debug - Stopping speech, current utterance: \(currentUtterance != nil)")
-        
         // Cancel all timers first
-        progressTimer?.cancel()
-        progressTimer = nil
+        cancelProgressUpdates()
         stopElapsedTimeTracking()
         timeoutTimer?.cancel()
         timeoutTimer = nil
         
+        // Drop any streamed pages that have not been spoken yet
+        cancelPageStream()
+        rateChangeWord = nil
+        carriedElapsedTime = nil
+        
         // Stop the synthesizer
         synthesizer.stopSpeaking(at: .immediate)
+        endUtteranceIntervals()
+        replacedUtterances.removeAll()
         
         // Clear utterance reference and reset state
         currentUtterance = nil
+        currentSegment = nil
         utteranceStartDate = nil
         readingProgress = 0.0
         currentWordIndex = 0
         elapsedTime = 0.0
+        telemetry.flush()
         isSpeaking = false
         isPaused = false
-        
-        print("TTS Debug - Speech stopped, state reset")
+    }
+    
+    /// Hands `utterance` to the synthesizer, opening its "Speech start" signpost interval
+    private func speakSignposted(_ utterance: AVSpeechUtterance) {
+        pendingUtteranceIntervals[ObjectIdentifier(utterance)] = Signpost.speech.beginInterval(
+            "Speech start", id: Signpost.speech.makeSignpostID(from: utterance), "\(utterance.speechString.utf16.count) characters")
+        synthesizer.speak(utterance)
+    }
+    
+    private func endUtteranceInterval(_ utterance: AVSpeechUtterance) {
+        let key = ObjectIdentifier(utterance)
+        if let state = pendingUtteranceIntervals.removeValue(forKey: key) {
+            Signpost.speech.endInterval("Speech start", state, "cancelled")
+        }
+        if let state = utteranceIntervals.removeValue(forKey: key) {
+            Signpost.speech.endInterval("Utterance", state)
+        }
+    }
+    
+    /// Closes the intervals of utterances dropped by `stopSpeaking` without a delegate callback
+    private func endUtteranceIntervals() {
+        for state in pendingUtteranceIntervals.values {
+            Signpost.speech.endInterval("Speech start", state, "cancelled")
+        }
+        for state in utteranceIntervals.values {
+            Signpost.speech.endInterval("Utterance", state, "stopped")
+        }
+        pendingUtteranceIntervals.removeAll()
+        utteranceIntervals.removeAll()
     }
     
     private func stopElapsedTimeTracking() {
@@ -447,11 +595,92 @@ import Speech
         elapsedTimeTimer = nil
     }
     
+    /// Sets the rate of new utterances. While speaking, the new rate is applied from the next
+    /// sentence, see `applyRateChangeIfNeeded(at:in:)`.
     func setSpeechRate(_ rate: Float) {
         speechRate = max(AVSpeechUtteranceMinimumSpeechRate, min(AVSpeechUtteranceMaximumSpeechRate, rate))
         settingsManager?.setSpeechRate(speechRate)
         
-        // Note: Changing rate mid-utterance is not applied by AVSpeechSynthesizer; changes will take effect on next speak.
+        // A slider drag sends many rates; the last one is used when the sentence ends
+        if isSpeaking && currentUtterance != nil && rateChangeWord == nil {
+            rateChangeWord = currentWordIndex
+        }
+    }
+    
+    /// Respeaks the rest of the current utterance at the new rate when the word at `characterRange`
+    /// starts a sentence, or once `maxWordsBeforeRateChange` words went by without one.
+    ///
+    /// AVSpeechSynthesizer reads an utterance's rate once, when it is queued, so the utterance is
+    /// cut at that word and spoken again from there. Utterances queued behind it by the look-ahead
+    /// are queued again too, so nothing plays at the old rate. Progress carries on from the same
+    /// word through `wordOffset`. Returns true if the utterance was replaced.
+    private func applyRateChangeIfNeeded(at characterRange: NSRange, in utterance: AVSpeechUtterance) -> Bool {
+        guard let requestedAt = rateChangeWord else { return false }
+        let speechString = utterance.speechString as NSString
+        guard characterRange.location > 0, characterRange.location < speechString.length else { return false }
+        
+        let wordIndex = words.wordIndex(containingUTF16Offset: characterRange.location)
+        let startsSentence = Self.startsSentence(at: characterRange.location, in: speechString)
+        guard startsSentence || wordOffset + wordIndex - requestedAt >= maxWordsBeforeRateChange else { return false }
+        rateChangeWord = nil
+        
+        let rate = max(AVSpeechUtteranceMinimumSpeechRate, min(AVSpeechUtteranceMaximumSpeechRate, speechRate))
+        guard enableSSML || utterance.rate != rate else { return false }
+        Log.speech.debug("Speech rate changed to \(rate), speaking again from word \(self.wordOffset + wordIndex + 1)")
+        
+        let remainder = speechString.substring(from: characterRange.location)
+        let remainderWords = WordIndex(remainder)
+        let remainderOffset = wordOffset + wordIndex
+        let segment = streamingUtterances.removeValue(forKey: ObjectIdentifier(utterance))
+        
+        // Look-ahead utterances in speaking order; page numbers and chunk indices only grow
+        let queued = streamingUtterances.values.sorted { $0.index < $1.index }
+        streamingUtterances.removeAll()
+        
+        // The cancelled utterances can still get delegate callbacks, which must not end playback.
+        // They are kept alive until then, so their identifiers aren't reused by new utterances.
+        for replaced in [utterance] + queued.map(\.utterance) {
+            replacedUtterances[ObjectIdentifier(replaced)] = replaced
+            endUtteranceInterval(replaced)
+        }
+        synthesizer.stopSpeaking(at: .immediate)
+        
+        let elapsed = utteranceStartDate.map { Date().timeIntervalSince($0) - totalPausedTime } ?? 0
+        let replacement = makeSpeechUtterance(remainder)
+        carriedElapsedTime = (ObjectIdentifier(replacement), elapsed)
+        if let segment = segment {
+            streamingUtterances[ObjectIdentifier(replacement)] = QueuedSegment(index: segment.index, words: remainderWords, wordOffset: remainderOffset, utterance: replacement)
+        } else {
+            fullText = remainder
+            words = remainderWords
+            wordOffset = remainderOffset
+        }
+        currentUtterance = replacement
+        speakSignposted(replacement)
+        
+        for queuedSegment in queued {
+            let requeued = makeSpeechUtterance(queuedSegment.utterance.speechString)
+            streamingUtterances[ObjectIdentifier(requeued)] = QueuedSegment(index: queuedSegment.index, words: queuedSegment.words, wordOffset: queuedSegment.wordOffset, utterance: requeued)
+            speakSignposted(requeued)
+        }
+        return true
+    }
+    
+    private static let sentenceTerminators = CharacterSet(charactersIn: ".!?…").union(.newlines)
+    private static let sentenceClosers = CharacterSet(charactersIn: "\"'”’)]").union(.whitespaces)
+    
+    /// Whether the text before `offset`, past spaces, quotes and brackets, ends a sentence
+    private static func startsSentence(at offset: Int, in text: NSString) -> Bool {
+        var location = offset - 1
+        while location >= 0 {
+            guard let scalar = Unicode.Scalar(text.character(at: location)) else { return false }
+            if sentenceTerminators.contains(scalar) {
+                return true
+            }
+            guard sentenceClosers.contains(scalar) else { return false }
+            location -= 1
+        }
+        return false
     }
     
     func setVoice(_ voice: AVSpeechSynthesisVoice) {
@@ -488,7 +717,7 @@ import Speech
     }
     
     nonisolated var availableVoices: [AVSpeechSynthesisVoice] {
-        return AVSpeechSynthesisVoice.speechVoices().filter { $0.language.hasPrefix("en") }
+        return VoiceCatalog.shared.englishVoices
     }
     
     // MARK: - Personal Voice Authorization
@@ -587,7 +816,7 @@ import Speech
         let requiredElements = ["<speak", "</speak>"]
         for element in requiredElements {
             if !ssml.contains(element) {
-                print("SSML Validation Error: Missing required element '\(element)'")
+                Log.speech.error("Invalid SSML: missing \(element, privacy: .public)")
                 return false
             }
         }
@@ -597,190 +826,67 @@ import Speech
         let closeSpeak = ssml.components(separatedBy: "</speak>").count - 1
         
         if openSpeak != closeSpeak {
-            print("SSML Validation Error: Mismatched speak tags")
+            Log.speech.error("Invalid SSML: mismatched speak tags")
             return false
         }
         
         return true
     }
     
-    private func preprocessTextForTTS(_ text: String) -> String {
-        var processedText = text
-        
-        // First, aggressively clean the text to remove problematic characters
-        processedText = cleanTextForTTS(processedText)
-        
-        // Handle LaTeX math delimiters more carefully to preserve content
-        processedText = processedText.replacingOccurrences(of: "\\(", with: " (")
-        processedText = processedText.replacingOccurrences(of: "\\)", with: ") ")
-        processedText = processedText.replacingOccurrences(of: "\\[", with: " [")
-        processedText = processedText.replacingOccurrences(of: "\\]", with: "] ")
-        processedText = processedText.replacingOccurrences(of: "$$", with: " ")
-        processedText = processedText.replacingOccurrences(of: "$", with: " ")
-        
-        // Handle common LaTeX commands
-        processedText = processedText.replacingOccurrences(of: "\\frac{", with: " fraction ")
-        processedText = processedText.replacingOccurrences(of: "\\sqrt{", with: " square root of ")
-        processedText = processedText.replacingOccurrences(of: "\\sum", with: " sum ")
-        processedText = processedText.replacingOccurrences(of: "\\int", with: " integral ")
-        processedText = processedText.replacingOccurrences(of: "\\lim", with: " limit ")
-        processedText = processedText.replacingOccurrences(of: "\\infty", with: " infinity ")
-        processedText = processedText.replacingOccurrences(of: "\\alpha", with: " alpha ")
-        processedText = processedText.replacingOccurrences(of: "\\beta", with: " beta ")
-        processedText = processedText.replacingOccurrences(of: "\\gamma", with: " gamma ")
-        processedText = processedText.replacingOccurrences(of: "\\delta", with: " delta ")
-        processedText = processedText.replacingOccurrences(of: "\\epsilon", with: " epsilon ")
-        processedText = processedText.replacingOccurrences(of: "\\theta", with: " theta ")
-        processedText = processedText.replacingOccurrences(of: "\\lambda", with: " lambda ")
-        processedText = processedText.replacingOccurrences(of: "\\mu", with: " mu ")
-        processedText = processedText.replacingOccurrences(of: "\\pi", with: " pi ")
-        processedText = processedText.replacingOccurrences(of: "\\sigma", with: " sigma ")
-        processedText = processedText.replacingOccurrences(of: "\\tau", with: " tau ")
-        processedText = processedText.replacingOccurrences(of: "\\phi", with: " phi ")
-        processedText = processedText.replacingOccurrences(of: "\\omega", with: " omega ")
-        
-        // Handle mathematical operators
-        processedText = processedText.replacingOccurrences(of: "\\times", with: " times ")
-        processedText = processedText.replacingOccurrences(of: "\\div", with: " divided by ")
-        processedText = processedText.replacingOccurrences(of: "\\pm", with: " plus or minus ")
-        processedText = processedText.replacingOccurrences(of: "\\mp", with: " minus or plus ")
-        processedText = processedText.replacingOccurrences(of: "\\leq", with: " less than or equal to ")
-        processedText = processedText.replacingOccurrences(of: "\\geq", with: " greater than or equal to ")
-        processedText = processedText.replacingOccurrences(of: "\\neq", with: " not equal to ")
-        processedText = processedText.replacingOccurrences(of: "\\approx", with: " approximately equal to ")
-        processedText = processedText.replacingOccurrences(of: "\\equiv", with: " equivalent to ")
-        processedText = processedText.replacingOccurrences(of: "\\propto", with: " proportional to ")
-        processedText = processedText.replacingOccurrences(of: "\\in", with: " in ")
-        processedText = processedText.replacingOccurrences(of: "\\notin", with: " not in ")
-        processedText = processedText.replacingOccurrences(of: "\\subset", with: " subset of ")
-        processedText = processedText.replacingOccurrences(of: "\\supset", with: " superset of ")
-        processedText = processedText.replacingOccurrences(of: "\\cup", with: " union ")
-        processedText = processedText.replacingOccurrences(of: "\\cap", with: " intersection ")
-        processedText = processedText.replacingOccurrences(of: "\\emptyset", with: " empty set ")
-        processedText = processedText.replacingOccurrences(of: "\\forall", with: " for all ")
-        processedText = processedText.replacingOccurrences(of: "\\exists", with: " there exists ")
-        processedText = processedText.replacingOccurrences(of: "\\rightarrow", with: " implies ")
-        processedText = processedText.replacingOccurrences(of: "\\leftarrow", with: " implied by ")
-        processedText = processedText.replacingOccurrences(of: "\\leftrightarrow", with: " if and only if ")
-        
-        // Handle superscripts and subscripts
-        processedText = processedText.replacingOccurrences(of: "^{", with: " to the power of ")
-        processedText = processedText.replacingOccurrences(of: "_{", with: " sub ")
-        processedText = processedText.replacingOccurrences(of: "}", with: " ")
-        
-        // Handle common mathematical symbols
-        processedText = processedText.replacingOccurrences(of: "∑", with: " sum ")
-        processedText = processedText.replacingOccurrences(of: "∏", with: " product ")
-        processedText = processedText.replacingOccurrences(of: "∫", with: " integral ")
-        processedText = processedText.replacingOccurrences(of: "√", with: " square root ")
-        processedText = processedText.replacingOccurrences(of: "∞", with: " infinity ")
-        processedText = processedText.replacingOccurrences(of: "α", with: " alpha ")
-        processedText = processedText.replacingOccurrences(of: "β", with: " beta ")
-        processedText = processedText.replacingOccurrences(of: "γ", with: " gamma ")
-        processedText = processedText.replacingOccurrences(of: "δ", with: " delta ")
-        processedText = processedText.replacingOccurrences(of: "ε", with: " epsilon ")
-        processedText = processedText.replacingOccurrences(of: "θ", with: " theta ")
-        processedText = processedText.replacingOccurrences(of: "λ", with: " lambda ")
-        processedText = processedText.replacingOccurrences(of: "μ", with: " mu ")
-        processedText = processedText.replacingOccurrences(of: "π", with: " pi ")
-        processedText = processedText.replacingOccurrences(of: "σ", with: " sigma ")
-        processedText = processedText.replacingOccurrences(of: "τ", with: " tau ")
-        processedText = processedText.replacingOccurrences(of: "φ", with: " phi ")
-        processedText = processedText.replacingOccurrences(of: "ω", with: " omega ")
-        processedText = processedText.replacingOccurrences(of: "×", with: " times ")
-        processedText = processedText.replacingOccurrences(of: "÷", with: " divided by ")
-        processedText = processedText.replacingOccurrences(of: "±", with: " plus or minus ")
-        processedText = processedText.replacingOccurrences(of: "≤", with: " less than or equal to ")
-        processedText = processedText.replacingOccurrences(of: "≥", with: " greater than or equal to ")
-        processedText = processedText.replacingOccurrences(of: "≠", with: " not equal to ")
-        processedText = processedText.replacingOccurrences(of: "≈", with: " approximately equal to ")
-        processedText = processedText.replacingOccurrences(of: "≡", with: " equivalent to ")
-        processedText = processedText.replacingOccurrences(of: "∝", with: " proportional to ")
-        processedText = processedText.replacingOccurrences(of: "∈", with: " in ")
-        processedText = processedText.replacingOccurrences(of: "∉", with: " not in ")
-        processedText = processedText.replacingOccurrences(of: "⊂", with: " subset of ")
-        processedText = processedText.replacingOccurrences(of: "⊃", with: " superset of ")
-        processedText = processedText.replacingOccurrences(of: "∪", with: " union ")
-        processedText = processedText.replacingOccurrences(of: "∩", with: " intersection ")
-        processedText = processedText.replacingOccurrences(of: "∅", with: " empty set ")
-        processedText = processedText.replacingOccurrences(of: "∀", with: " for all ")
-        processedText = processedText.replacingOccurrences(of: "∃", with: " there exists ")
-        processedText = processedText.replacingOccurrences(of: "→", with: " implies ")
-        processedText = processedText.replacingOccurrences(of: "←", with: " implied by ")
-        processedText = processedText.replacingOccurrences(of: "↔", with: " if and only if ")
-        
-        // Clean up excessive whitespace but preserve word boundaries
-        processedText = processedText.replacingOccurrences(of: "\\s{2,}", with: " ", options: .regularExpression)
-        
-        // Remove any remaining problematic characters that might cause TTS to stop
-        processedText = processedText.replacingOccurrences(of: "\u{00A0}", with: " ") // Non-breaking space
-        processedText = processedText.replacingOccurrences(of: "\u{2000}-\u{200F}", with: " ", options: .regularExpression) // Various spaces
-        processedText = processedText.replacingOccurrences(of: "\u{2028}-\u{202F}", with: " ", options: .regularExpression) // Line/paragraph separators
-        processedText = processedText.replacingOccurrences(of: "\u{205F}-\u{206F}", with: " ", options: .regularExpression) // More spaces
-        processedText = processedText.replacingOccurrences(of: "\u{3000}", with: " ") // Ideographic space
-        processedText = processedText.replacingOccurrences(of: "\u{FEFF}", with: "") // Zero-width no-break space
-        
-        // Remove all control characters except newlines and tabs
-        processedText = processedText.replacingOccurrences(of: "[\u{00}-\u{08}\u{0B}\u{0C}\u{0E}-\u{1F}\u{7F}]", with: "", options: .regularExpression)
-        
-        // Remove any remaining problematic Unicode characters
-        processedText = processedText.replacingOccurrences(of: "[\u{200B}-\u{200D}\u{2060}\u{FEFF}]", with: "", options: .regularExpression) // Zero-width characters
-        
-        // Clean up any remaining problematic characters that might cause audio issues
-        processedText = processedText.replacingOccurrences(of: "[\u{202A}-\u{202E}\u{2066}-\u{2069}]", with: "", options: .regularExpression) // Directional formatting characters
-        
-        // Final cleanup
-        processedText = processedText.trimmingCharacters(in: .whitespacesAndNewlines)
-        
-        // Ensure we have valid content
-        if processedText.isEmpty {
-            processedText = "No content available for speech synthesis."
+    nonisolated private func preprocessTextForTTS(_ text: String) -> String {
+        // Cleanup of characters that can stop the synthesizer, math/symbol rules and whitespace
+        // normalization all happen in a single pass
+        let processedText = Signpost.speech.withIntervalSignpost("Normalize", "\(text.utf8.count) bytes") {
+            TextNormalizer.shared.normalize(text, options: .speechSafe)
         }
         
-        return processedText
-    }
-    
-    private func cleanTextForTTS(_ text: String) -> String {
-        var cleanedText = text
-        
-        // Remove all control characters except newlines, carriage returns, and tabs
-        cleanedText = cleanedText.replacingOccurrences(of: "[\u{00}-\u{08}\u{0B}\u{0C}\u{0E}-\u{1F}\u{7F}]", with: "", options: .regularExpression)
-        
-        // Remove zero-width characters that can cause audio issues
-        cleanedText = cleanedText.replacingOccurrences(of: "[\u{200B}\u{200C}\u{200D}\u{2060}\u{FEFF}]", with: "", options: .regularExpression)
-        
-        // Remove directional formatting characters
-        cleanedText = cleanedText.replacingOccurrences(of: "[\u{202A}-\u{202E}\u{2066}-\u{2069}]", with: "", options: .regularExpression)
-        
-        // Replace problematic Unicode spaces with regular spaces
-        cleanedText = cleanedText.replacingOccurrences(of: "[\u{00A0}\u{2000}-\u{200F}\u{2028}-\u{202F}\u{205F}-\u{206F}\u{3000}]", with: " ", options: .regularExpression)
-        
-        // Remove any remaining non-printable characters (simplified approach)
-        let allowedCharacterSet = CharacterSet.alphanumerics
-            .union(CharacterSet.whitespacesAndNewlines)
-            .union(CharacterSet.punctuationCharacters)
-            .union(CharacterSet.symbols)
-        
-        cleanedText = cleanedText.components(separatedBy: allowedCharacterSet.inverted)
-            .joined(separator: " ")
-        
-        // Clean up multiple spaces and normalize whitespace
-        cleanedText = cleanedText.replacingOccurrences(of: "\\s{2,}", with: " ", options: .regularExpression)
-        cleanedText = cleanedText.trimmingCharacters(in: .whitespacesAndNewlines)
-        
-        return cleanedText
+        // Ensure we have valid content
+        return processedText.isEmpty ? "No content available for speech synthesis." : processedText
     }
 }
 
 @MainActor extension TextToSpeechManager: AVSpeechSynthesizerDelegate {
     func speechSynthesizer(_ synthesizer: AVSpeechSynthesizer, didStart utterance: AVSpeechUtterance) {
-        print("Speech synthesizer did start utterance")
-        print("Utterance speech string length: \(utterance.speechString.count)")
-        print("Utterance speech string preview: \(String(utterance.speechString.prefix(100)))")
+        let key = ObjectIdentifier(utterance)
+        if let state = pendingUtteranceIntervals.removeValue(forKey: key) {
+            Signpost.speech.endInterval("Speech start", state)
+        }
+        utteranceIntervals[key] = Signpost.speech.beginInterval("Utterance", id: Signpost.speech.makeSignpostID(from: utterance))
         
         self.isSpeaking = true
         self.isPaused = false
         self.utteranceStartDate = Date()
+        
+        // Streamed pages and look-ahead chunks track progress per utterance
+        if let segment = streamingUtterances[ObjectIdentifier(utterance)] {
+            if self.isChunked {
+                self.currentChunk = segment.index
+            }
+            self.currentUtterance = utterance
+            self.currentSegment = self.isChunked ? .chunk(segment.index) : .page(segment.index)
+            self.fullText = utterance.speechString
+            self.words = segment.words
+            self.wordOffset = segment.wordOffset
+            self.totalWords = self.words.count + segment.wordOffset
+            self.currentWordIndex = segment.wordOffset
+            self.readingProgress = 0.0
+            self.totalPausedTime = 0.0
+        }
+        
+        // SSML utterances report spoken ranges in their own speech string, not in the
+        // preprocessed text the word index was built from
+        if self.enableSSML {
+            self.words = WordIndex(utterance.speechString)
+            self.totalWords = self.words.count + self.wordOffset
+        }
+        
+        // A rate change replaced the utterance mid-way; elapsed time carries on
+        if let carried = carriedElapsedTime, carried.utterance == key {
+            carriedElapsedTime = nil
+            self.utteranceStartDate = Date().addingTimeInterval(-carried.elapsed)
+            self.totalPausedTime = 0.0
+        }
+        
         self.startProgressTracking()
     }
     
@@ -800,35 +906,29 @@ import Speech
     }
     
     func speechSynthesizer(_ synthesizer: AVSpeechSynthesizer, didFinish utterance: AVSpeechUtterance) {
-        print("Speech synthesizer did finish utterance")
-        print("Current chunk completion handler: \(self.chunkCompletionHandler != nil)")
-        print("Is chunked: \(self.isChunked)")
-        print("Current chunk: \(self.currentChunk) of \(self.totalChunks)")
-        print("Utterance speech string length: \(utterance.speechString.count)")
-        print("Utterance speech string preview: \(String(utterance.speechString.prefix(100)))")
-        print("Reading progress when finished: \(self.readingProgress)")
-        print("Total words: \(self.totalWords), Current word index: \(self.currentWordIndex)")
-        print("Current utterance reference: \(self.currentUtterance != nil)")
-        print("Utterance identity match: \(self.currentUtterance === utterance)")
+        endUtteranceInterval(utterance)
+        
+        if self.replacedUtterances.removeValue(forKey: ObjectIdentifier(utterance)) != nil {
+            return
+        }
+        
+        if self.streamingUtterances.removeValue(forKey: ObjectIdentifier(utterance)) != nil {
+            self.handleStreamUtteranceFinished()
+            return
+        }
         
         // Check if this is the current utterance or if we should process it anyway
         let isCurrentUtterance = self.currentUtterance === utterance
         let hasCompletionHandler = self.chunkCompletionHandler != nil
         
-        print("Processing didFinish - isCurrent: \(isCurrentUtterance), hasHandler: \(hasCompletionHandler)")
-        
         // Process completion if this is the current utterance OR if we have a completion handler
         // (in case of race conditions where utterance reference was cleared)
-        guard isCurrentUtterance || hasCompletionHandler else {
-            print("Ignoring didFinish - not current utterance and no completion handler")
-            return
-        }
+        guard isCurrentUtterance || hasCompletionHandler else { return }
         
         self.isSpeaking = false
         self.isPaused = false
         self.currentUtterance = nil
-        self.progressTimer?.cancel()
-        self.progressTimer = nil
+        self.cancelProgressUpdates()
         self.stopElapsedTimeTracking()
         self.timeoutTimer?.cancel()
         self.timeoutTimer = nil
@@ -837,32 +937,29 @@ import Speech
         
         // Call chunk completion handler if available
         if let handler = self.chunkCompletionHandler {
-            print("Calling chunk completion handler")
             self.chunkCompletionHandler = nil
             handler()
-        } else {
-            print("No chunk completion handler to call")
         }
     }
     
     func speechSynthesizer(_ synthesizer: AVSpeechSynthesizer, didCancel utterance: AVSpeechUtterance) {
-        print("Speech synthesizer did cancel utterance")
-        print("Current chunk completion handler: \(self.chunkCompletionHandler != nil)")
-        print("Is chunked: \(self.isChunked)")
-        print("Current chunk: \(self.currentChunk) of \(self.totalChunks)")
+        endUtteranceInterval(utterance)
+        
+        if self.replacedUtterances.removeValue(forKey: ObjectIdentifier(utterance)) != nil {
+            return
+        }
         
         self.isSpeaking = false
         self.isPaused = false
         self.currentUtterance = nil
-        self.progressTimer?.cancel()
-        self.progressTimer = nil
+        self.cancelProgressUpdates()
         self.utteranceStartDate = nil
     }
     
     func speechSynthesizer(_ synthesizer: AVSpeechSynthesizer, willSpeakRangeOfSpeechString characterRange: NSRange, utterance: AVSpeechUtterance) {
-        print("Speech synthesizer will speak range: \(characterRange.location)-\(characterRange.location + characterRange.length)")
-        let textToSpeak = (utterance.speechString as NSString).substring(with: characterRange)
-        print("Text to speak: \(String(textToSpeak.prefix(50)))...")
+        guard utterance === currentUtterance, !isPaused else { return }
+        guard !applyRateChangeIfNeeded(at: characterRange, in: utterance) else { return }
+        scheduleProgressUpdate(wordIndex: wordOffset + words.wordIndex(containingUTF16Offset: characterRange.location))
     }
 }
 
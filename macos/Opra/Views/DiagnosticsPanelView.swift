@@ -0,0 +1,47 @@
+//
+//  DiagnosticsPanelView.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import SwiftUI
+
+/// One line of live pipeline numbers, shown above the playback controls when diagnostics are on
+struct DiagnosticsPanelView: View {
+    @ObservedObject var diagnostics: PipelineDiagnostics
+
+    var body: some View {
+        let snapshot = diagnostics.snapshot
+        HStack(spacing: 16) {
+            metric("Extraction", String(format: "%.1f pages/s, %d left", snapshot.extractionPagesPerSecond, snapshot.pagesRemaining))
+            metric("Ready ahead", "\(snapshot.chunksAhead) chunks")
+            // Below 1 the provider synthesizes faster than it plays back
+            metric("Synthesis", snapshot.realTimeFactor.map { String(format: "%.2f× real time", $0) } ?? "live",
+                   warning: (snapshot.realTimeFactor ?? 0) > 1)
+            metric("Buffers", "\(snapshot.droppedBuffers) dropped, \(snapshot.lateBuffers) late",
+                   warning: snapshot.droppedBuffers + snapshot.lateBuffers > 0)
+            metric("UI hitches", hitchSummary(snapshot), warning: snapshot.hitches > 0)
+            Spacer()
+        }
+        .font(.caption2.monospacedDigit())
+        .padding(.horizontal, 20)
+        .padding(.vertical, 6)
+        .background(Color(NSColor.controlBackgroundColor).opacity(0.5))
+    }
+
+    private func metric(_ title: String, _ value: String, warning: Bool = false) -> some View {
+        HStack(spacing: 4) {
+            Text(title)
+                .foregroundColor(.secondary)
+            Text(value)
+                .foregroundColor(warning ? .orange : .primary)
+        }
+    }
+
+    private func hitchSummary(_ snapshot: PipelineDiagnostics.Snapshot) -> String {
+        guard snapshot.hitches > 0 else { return "none" }
+        let sources = snapshot.hitchSources.prefix(2).map { "\($0.name) \($0.count)" }.joined(separator: ", ")
+        return "\(snapshot.hitches), longest \(Int(snapshot.longestHitch * 1000)) ms (\(sources))"
+    }
+}
@@ -229,6 +229,32 @@ struct OllamaSetupView: View {
                         }
                     }
                     .padding(.horizontal, 30)
+                    
+                    // Speech Server
+                    VStack(alignment: .leading, spacing: 8) {
+                        Text("Speech Server")
+                            .font(.headline)
+                        
+                        TextField("Endpoint", text: Binding(
+                            get: { ollamaTTSManager.speechEndpoint },
+                            set: { ollamaTTSManager.setSpeechEndpoint($0) }
+                        ))
+                        .textFieldStyle(.roundedBorder)
+                        
+                        Text("Streaming TTS endpoint that runs the Orpheus model, e.g. Orpheus-FastAPI. Audio starts playing as soon as the first frame arrives.")
+                            .font(.caption)
+                            .foregroundColor(.secondary)
+                        
+                        Toggle("Batch requests", isOn: Binding(
+                            get: { ollamaTTSManager.batchRequests },
+                            set: { ollamaTTSManager.setBatchRequests($0) }
+                        ))
+                        
+                        Text("Sends several short chunks per request when rendering ahead. The server must accept a list as input and tag each frame with its index.")
+                            .font(.caption)
+                            .foregroundColor(.secondary)
+                    }
+                    .padding(.horizontal, 30)
                 }
                 
                 // Footer with refresh button
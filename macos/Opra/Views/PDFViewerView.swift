@@ -12,7 +12,14 @@ struct PDFViewerView: View {
     let pdfDocument: PDFDocument
     @Binding var currentPage: Int
     @ObservedObject var ttsProviderManager: TTSProviderManager
-    @State private var pdfView = PDFView()
+    @ObservedObject var search: DocumentSearch
+    let onSpeakFromHere: (SearchIndex.Hit) -> Void
+    @StateObject private var viewer = PDFViewHolder()
+    
+    // Hits highlighted in the document; more are listed but not drawn
+    private static let highlightedResultLimit = 50
+    
+    private var pdfView: PDFView { viewer.pdfView }
     
     var body: some View {
         VStack(spacing: 0) {
@@ -39,6 +46,13 @@ struct PDFViewerView: View {
                 
                 Spacer()
                 
+                TextField("Search", text: $search.query)
+                    .textFieldStyle(.roundedBorder)
+                    .frame(width: 180)
+                    .onSubmit {
+                        selectNextResult()
+                    }
+                
                 // Page jump
                 HStack {
                     Text("Go to:")
@@ -53,13 +67,80 @@ struct PDFViewerView: View {
             .padding()
             .background(Color(NSColor.controlBackgroundColor).opacity(0.5))
             
-            // PDF content with vertical scrolling
-            ZStack {
-                PDFViewRepresentable(pdfView: pdfView)
-                    .onAppear {
-                        setupPDFView()
+            HStack(spacing: 0) {
+                // PDF content with vertical scrolling
+                ZStack {
+                    PDFViewRepresentable(pdfView: pdfView)
+                        .onAppear {
+                            setupPDFView()
+                        }
+                        .onChange(of: pdfDocument) { _, _ in
+                            // Windowed loading reopens the document as reading moves through it
+                            setupPDFView()
+                            jumpToPage()
+                            highlightResults()
+                        }
+                }
+                
+                if !search.query.isEmpty {
+                    Divider()
+                    searchResults
+                        .frame(width: 260)
+                }
+            }
+        }
+        .onChange(of: search.results) { _, _ in
+            highlightResults()
+        }
+        .onChange(of: search.selected) { _, result in
+            if let result = result {
+                show(result)
+            }
+        }
+    }
+    
+    private var searchResults: some View {
+        VStack(alignment: .leading, spacing: 0) {
+            Text(resultsTitle)
+                .font(.caption)
+                .foregroundColor(.secondary)
+                .padding(8)
+            
+            List(search.results, selection: $search.selected) { result in
+                VStack(alignment: .leading, spacing: 4) {
+                    Text("Page \(result.hit.page)")
+                        .font(.caption)
+                        .fontWeight(.medium)
+                    if !result.snippet.isEmpty {
+                        Text(result.snippet)
+                            .font(.caption2)
+                            .foregroundColor(.secondary)
+                            .lineLimit(3)
+                    }
+                    Button("Speak from Here") {
+                        search.selected = result
+                        onSpeakFromHere(result.hit)
                     }
+                    .buttonStyle(.link)
+                    .font(.caption2)
+                }
+                .tag(result)
             }
+            .listStyle(.sidebar)
+        }
+    }
+    
+    private var resultsTitle: String {
+        if search.isSearching {
+            return "Searching…"
+        }
+        switch search.results.count {
+        case 0:
+            return "No matches"
+        case DocumentSearch.resultLimit:
+            return "First \(DocumentSearch.resultLimit) matches"
+        case let count:
+            return count == 1 ? "1 match" : "\(count) matches"
         }
     }
     
@@ -80,6 +161,38 @@ struct PDFViewerView: View {
         }
     }
     
+    /// Highlights the first hits on pages that have a text layer. Recognized pages don't, so
+    /// their hits are only listed.
+    private func highlightResults() {
+        pdfView.highlightedSelections = search.results.prefix(Self.highlightedResultLimit).compactMap(selection(for:))
+    }
+    
+    private func selection(for result: DocumentSearch.Result) -> PDFSelection? {
+        guard let range = result.range, let page = pdfDocument.page(at: result.hit.page - 1),
+              let selection = page.selection(for: range) else {
+            return nil
+        }
+        selection.color = .systemYellow
+        return selection
+    }
+    
+    private func show(_ result: DocumentSearch.Result) {
+        if let selection = selection(for: result) {
+            pdfView.setCurrentSelection(selection, animate: false)
+            pdfView.go(to: selection)
+        } else if let page = pdfDocument.page(at: result.hit.page - 1) {
+            pdfView.go(to: page)
+        }
+        currentPage = result.hit.page
+    }
+    
+    /// Return in the search field steps through the results
+    private func selectNextResult() {
+        guard !search.results.isEmpty else { return }
+        let next = search.selected.flatMap { search.results.firstIndex(of: $0) }.map { $0 + 1 } ?? 0
+        search.selected = search.results[next % search.results.count]
+    }
+    
     private func jumpToPage() {
         let targetPage = max(1, min(currentPage, pdfDocument.pageCount))
         if let page = pdfDocument.page(at: targetPage - 1) {
@@ -88,3 +201,10 @@ struct PDFViewerView: View {
         }
     }
 }
+
+/// Owns the viewer's PDFView. A `@State` default would build a new PDFView every time the parent
+/// re-renders, only for SwiftUI to keep the first; this one is built once, when the view is first
+/// drawn with a document.
+private final class PDFViewHolder: ObservableObject {
+    let pdfView = PDFView()
+}
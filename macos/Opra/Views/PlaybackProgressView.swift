@@ -0,0 +1,47 @@
+//
+//  PlaybackProgressView.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import SwiftUI
+
+/// Reading progress and elapsed time in the playback bar. The only view observing the
+/// telemetry, so its updates don't invalidate the rest of the window.
+struct PlaybackProgressView: View {
+    @ObservedObject var telemetry: PlaybackTelemetry
+    let showsWordPosition: Bool
+
+    var body: some View {
+        VStack(spacing: 4) {
+            ProgressView(value: telemetry.readingProgress)
+                .progressViewStyle(LinearProgressViewStyle())
+                .frame(width: 150)
+
+            HStack(spacing: 8) {
+                if showsWordPosition {
+                    Text("\(Int(telemetry.readingProgress * 100))% - Word \(telemetry.currentWordIndex) of \(telemetry.totalWords)")
+                        .font(.caption2)
+                        .foregroundColor(.secondary)
+                } else {
+                    Text("\(Int(telemetry.readingProgress * 100))%")
+                        .font(.caption2)
+                        .foregroundColor(.secondary)
+                }
+
+                // Timer display
+                Text(formatTime(telemetry.elapsedTime))
+                    .font(.caption2)
+                    .foregroundColor(.blue)
+                    .fontWeight(.medium)
+            }
+        }
+    }
+
+    private func formatTime(_ timeInterval: TimeInterval) -> String {
+        let minutes = Int(timeInterval) / 60
+        let seconds = Int(timeInterval) % 60
+        return String(format: "%02d:%02d", minutes, seconds)
+    }
+}
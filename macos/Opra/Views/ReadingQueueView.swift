@@ -0,0 +1,66 @@
+//
+//  ReadingQueueView.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import SwiftUI
+
+/// The reading queue in the top bar: a menu of the queued documents and a button moving on to
+/// the next one
+struct ReadingQueueView: View {
+    @ObservedObject var queue: ReadingQueue
+    let onSelect: (UUID) -> Void
+    let onNext: () -> Void
+    let onAdd: () -> Void
+
+    var body: some View {
+        HStack(spacing: 8) {
+            Menu {
+                ForEach(Array(queue.items.enumerated()), id: \.element.id) { index, item in
+                    if index == queue.currentIndex {
+                        Label(item.title, systemImage: "speaker.wave.2")
+                    } else {
+                        Menu {
+                            Button("Read Now") {
+                                onSelect(item.id)
+                            }
+                            Button("Remove from Queue") {
+                                queue.remove(item.id)
+                            }
+                        } label: {
+                            Label(item.title, systemImage: symbolName(for: item.state))
+                        }
+                    }
+                }
+
+                Divider()
+
+                Button("Add PDFs…", action: onAdd)
+            } label: {
+                Label("Queue (\(queue.items.count))", systemImage: "list.bullet")
+            }
+            .fixedSize()
+
+            Button("Next", action: onNext)
+                .buttonStyle(.bordered)
+                .disabled(queue.nextItem == nil)
+                .keyboardShortcut("]", modifiers: .command)
+                .help(queue.nextItem.map { "Read \($0.title)" } ?? "No document queued after this one")
+        }
+    }
+
+    private func symbolName(for state: ReadingQueue.PreparationState) -> String {
+        switch state {
+        case .waiting:
+            return "doc"
+        case .preparing:
+            return "hourglass"
+        case .ready:
+            return "checkmark.circle"
+        case .failed:
+            return "exclamationmark.triangle"
+        }
+    }
+}
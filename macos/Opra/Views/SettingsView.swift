@@ -192,11 +192,13 @@ struct SettingsView: View {
                             
                             HStack {
                                 VStack(alignment: .leading) {
-                                    Text(ttsProviderManager.ollamaTTSManager.selectedModel.isEmpty ? "No model selected" : ttsProviderManager.ollamaTTSManager.selectedModel)
+                                    let model = ttsProviderManager.ollamaTTSManager?.selectedModel ?? ""
+                                    let isAvailable = ttsProviderManager.ollamaTTSManager?.isAvailable ?? false
+                                    Text(model.isEmpty ? "No model selected" : model)
                                         .font(.subheadline)
-                                    Text(ttsProviderManager.ollamaTTSManager.isAvailable ? "Ollama connected" : "Ollama not available")
+                                    Text(isAvailable ? "Ollama connected" : "Ollama not available")
                                         .font(.caption)
-                                        .foregroundColor(ttsProviderManager.ollamaTTSManager.isAvailable ? .green : .red)
+                                        .foregroundColor(isAvailable ? .green : .red)
                                 }
                                 
                                 Spacer()
@@ -222,20 +224,111 @@ struct SettingsView: View {
                         
                         VStack(alignment: .leading, spacing: 8) {
                             HStack {
-                                Text("Chunk Size (words)")
+                                Text("Chunk Size")
                                     .font(.subheadline)
                                 
                                 Spacer()
                                 
-                                TextField("Chunk Size", value: $settingsManager.chunkSize, format: .number)
-                                    .textFieldStyle(.roundedBorder)
+                                Picker("Chunk Size", selection: $settingsManager.chunkBudget) {
+                                    ForEach(ChunkBudget.allCases, id: \.self) { budget in
+                                        Text(budget.rawValue).tag(budget)
+                                    }
+                                }
+                                .labelsHidden()
+                                .pickerStyle(SegmentedPickerStyle())
+                                .frame(width: 180)
+                                .onChange(of: settingsManager.chunkBudget) { _, newValue in
+                                    settingsManager.setChunkBudget(newValue)
+                                }
+                                
+                                if settingsManager.chunkBudget == .duration {
+                                    TextField("Minutes", value: $settingsManager.chunkDurationMinutes, format: .number)
+                                        .textFieldStyle(.roundedBorder)
+                                        .frame(width: 80)
+                                        .onChange(of: settingsManager.chunkDurationMinutes) { _, newValue in
+                                            settingsManager.setChunkDurationMinutes(newValue)
+                                        }
+                                    Text("min")
+                                        .font(.caption)
+                                        .foregroundColor(.secondary)
+                                } else {
+                                    TextField("Characters", value: $settingsManager.chunkCharacterLimit, format: .number)
+                                        .textFieldStyle(.roundedBorder)
+                                        .frame(width: 80)
+                                        .onChange(of: settingsManager.chunkCharacterLimit) { _, newValue in
+                                            settingsManager.setChunkCharacterLimit(newValue)
+                                        }
+                                }
+                            }
+                            
+                            Text("Large texts are split into chunks at paragraph and sentence boundaries. Default: about 5 minutes of speech per chunk")
+                                .font(.caption)
+                                .foregroundColor(.secondary)
+                        }
+                        
+                        VStack(alignment: .leading, spacing: 8) {
+                            HStack {
+                                Text("Extraction Threads")
+                                    .font(.subheadline)
+                                
+                                Spacer()
+                                
+                                Stepper("\(settingsManager.extractionConcurrency)", value: $settingsManager.extractionConcurrency, in: 1...16)
                                     .frame(width: 80)
-                                    .onChange(of: settingsManager.chunkSize) { _, newValue in
-                                        settingsManager.setChunkSize(newValue)
+                                    .onChange(of: settingsManager.extractionConcurrency) { _, newValue in
+                                        settingsManager.setExtractionConcurrency(newValue)
                                     }
                             }
                             
-                            Text("Large texts will be split into chunks to prevent crashes. Default: 10,000 words")
+                            Text("Number of pages extracted in parallel. Set to 1 to extract pages one at a time.")
+                                .font(.caption)
+                                .foregroundColor(.secondary)
+                        }
+                        
+                        VStack(alignment: .leading, spacing: 8) {
+                            Toggle("Windowed loading for large documents", isOn: $settingsManager.enableWindowedLoading)
+                                .onChange(of: settingsManager.enableWindowedLoading) { _, newValue in
+                                    settingsManager.setEnableWindowedLoading(newValue)
+                                }
+                            
+                            if settingsManager.enableWindowedLoading {
+                                HStack {
+                                    Text("Pages around reading position")
+                                        .font(.subheadline)
+                                    
+                                    Spacer()
+                                    
+                                    Stepper("±\(settingsManager.pageWindowRadius)", value: $settingsManager.pageWindowRadius, in: 1...100)
+                                        .frame(width: 80)
+                                        .onChange(of: settingsManager.pageWindowRadius) { _, newValue in
+                                            settingsManager.setPageWindowRadius(newValue)
+                                        }
+                                }
+                            }
+                            
+                            Text("Only keeps the pages around the reading position in memory, so very large PDFs use a bounded amount of memory. Reading always streams page by page.")
+                                .font(.caption)
+                                .foregroundColor(.secondary)
+                        }
+                        
+                        VStack(alignment: .leading, spacing: 8) {
+                            Toggle("Recognize text in scanned pages", isOn: $settingsManager.enableOCR)
+                                .onChange(of: settingsManager.enableOCR) { _, newValue in
+                                    settingsManager.setEnableOCR(newValue)
+                                }
+                            
+                            Text("Pages without a text layer are read with OCR in the background, ahead of the reading position. Each page is recognized once and kept in the extraction cache.")
+                                .font(.caption)
+                                .foregroundColor(.secondary)
+                        }
+                        
+                        VStack(alignment: .leading, spacing: 8) {
+                            Toggle("Layout-aware extraction", isOn: $settingsManager.enableLayoutExtraction)
+                                .onChange(of: settingsManager.enableLayoutExtraction) { _, newValue in
+                                    settingsManager.setEnableLayoutExtraction(newValue)
+                                }
+                            
+                            Text("Reads multi-column pages one column at a time and skips running headers, footers and page numbers. The open document is extracted again when this changes.")
                                 .font(.caption)
                                 .foregroundColor(.secondary)
                         }
@@ -253,6 +346,28 @@ struct SettingsView: View {
                             .onChange(of: settingsManager.autoStartReading) { _, newValue in
                                 settingsManager.setAutoStartReading(newValue)
                             }
+                        
+                        VStack(alignment: .leading, spacing: 4) {
+                            Toggle("Gapless chunk playback", isOn: $settingsManager.enableGaplessChunks)
+                                .onChange(of: settingsManager.enableGaplessChunks) { _, newValue in
+                                    settingsManager.setEnableGaplessChunks(newValue)
+                                }
+                            
+                            Text("Prepares the next chunk while the current one is playing so there is no pause between chunks.")
+                                .font(.caption)
+                                .foregroundColor(.secondary)
+                        }
+                        
+                        VStack(alignment: .leading, spacing: 4) {
+                            Toggle("Show diagnostics", isOn: $settingsManager.showDiagnostics)
+                                .onChange(of: settingsManager.showDiagnostics) { _, newValue in
+                                    settingsManager.setShowDiagnostics(newValue)
+                                }
+                            
+                            Text("Shows extraction speed, chunks prepared ahead, synthesis speed, audio gaps and UI hitches above the playback controls, to find what is slowing reading down.")
+                                .font(.caption)
+                                .foregroundColor(.secondary)
+                        }
                     }
                     
                     Divider()
@@ -340,7 +455,7 @@ struct SettingsView: View {
                                     .foregroundColor(.orange)
                                     .fontWeight(.medium)
                                 
-                                Text("Highlights the currently spoken word in the text. May cause performance issues or incorrect highlighting.")
+                                Text("Highlights the currently spoken word in the text and keeps it scrolled into view.")
                                     .font(.caption)
                                     .foregroundColor(.secondary)
                             }
@@ -0,0 +1,71 @@
+//
+//  VoiceCatalog.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import AVFoundation
+
+/// The installed speech voices, enumerated once.
+///
+/// `AVSpeechSynthesisVoice.speechVoices()` loads the attributes of every installed voice, which
+/// takes a noticeable time with many voices, and the voice list, the settings and the default
+/// voice all ask for it. The list is read on first use, or ahead of it off the main thread by
+/// `prefetch()`, and only read again when the system reports that voices were added or removed.
+final class VoiceCatalog: @unchecked Sendable {
+    static let shared = VoiceCatalog()
+
+    private let lock = NSLock()
+    private var cachedVoices: [AVSpeechSynthesisVoice]?
+    private var observer: NSObjectProtocol?
+
+    init() {
+        observer = NotificationCenter.default.addObserver(
+            forName: AVSpeechSynthesizer.availableVoicesDidChangeNotification, object: nil, queue: nil
+        ) { [weak self] _ in
+            self?.invalidate()
+        }
+    }
+
+    deinit {
+        if let observer = observer {
+            NotificationCenter.default.removeObserver(observer)
+        }
+    }
+
+    var voices: [AVSpeechSynthesisVoice] {
+        lock.lock()
+        if let voices = cachedVoices {
+            lock.unlock()
+            return voices
+        }
+        lock.unlock()
+
+        // Enumerated outside the lock; two callers racing on a cold catalog get the same list
+        let voices = AVSpeechSynthesisVoice.speechVoices()
+        lock.lock()
+        cachedVoices = cachedVoices ?? voices
+        lock.unlock()
+        return voices
+    }
+
+    /// The voices offered in the voice picker
+    var englishVoices: [AVSpeechSynthesisVoice] {
+        return voices.filter { $0.language.hasPrefix("en") }
+    }
+
+    /// Enumerates the voices in the background, so the first lookup from the UI doesn't wait
+    func prefetch() {
+        DispatchQueue.global(qos: .utility).async {
+            _ = self.voices
+        }
+    }
+
+    private func invalidate() {
+        lock.lock()
+        cachedVoices = nil
+        lock.unlock()
+    }
+}
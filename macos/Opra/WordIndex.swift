@@ -0,0 +1,101 @@
+//
+//  WordIndex.swift
+//  Opra
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+
+/// Word boundaries of a text, found in a single pass over its UTF-16 code units.
+///
+/// Each word is stored as a (UTF-16 offset, length) pair, the same units `NSString` and
+/// `AVSpeechSynthesizer` ranges use, so finding the n-th word is O(1) and reading it back does not
+/// allocate an array of strings. Words are separated by the same characters as
+/// `CharacterSet.whitespacesAndNewlines`.
+struct WordIndex {
+    private struct Span {
+        let offset: UInt32
+        let length: UInt32
+    }
+
+    private var spans: ContiguousArray<Span> = []
+
+    static let empty = WordIndex()
+
+    private init() {}
+
+    init(_ text: String) {
+        var wordStart = -1
+        var position = 0
+        for unit in text.utf16 {
+            if Self.isWhitespace(unit) {
+                if wordStart >= 0 {
+                    spans.append(Span(offset: UInt32(wordStart), length: UInt32(position - wordStart)))
+                    wordStart = -1
+                }
+            } else if wordStart < 0 {
+                wordStart = position
+            }
+            position += 1
+        }
+        if wordStart >= 0 {
+            spans.append(Span(offset: UInt32(wordStart), length: UInt32(position - wordStart)))
+        }
+    }
+
+    var count: Int {
+        return spans.count
+    }
+
+    var isEmpty: Bool {
+        return spans.isEmpty
+    }
+
+    /// UTF-16 range of the word at `index` in the indexed text
+    func range(at index: Int) -> NSRange {
+        return NSRange(location: Int(spans[index].offset), length: Int(spans[index].length))
+    }
+
+    /// Index of the word that contains `offset` (UTF-16), or of the last word before it.
+    /// Binary search, so mapping a speech range back to a word is O(log n).
+    func wordIndex(containingUTF16Offset offset: Int) -> Int {
+        var lower = 0
+        var upper = spans.count
+        while lower < upper {
+            let middle = (lower + upper) / 2
+            if Int(spans[middle].offset) <= offset {
+                lower = middle + 1
+            } else {
+                upper = middle
+            }
+        }
+        return max(0, lower - 1)
+    }
+
+    /// Index of the first word that ends after `offset` (UTF-16): the word containing it, or the
+    /// next one when `offset` falls between words. `count` if there is none.
+    func firstWord(atOrAfterUTF16Offset offset: Int) -> Int {
+        guard !spans.isEmpty else { return 0 }
+        let index = wordIndex(containingUTF16Offset: offset)
+        return Int(spans[index].offset + spans[index].length) <= offset ? index + 1 : index
+    }
+
+    /// The word at `index`, read from the same text the index was built from
+    func word(at index: Int, in text: String) -> Substring? {
+        guard index >= 0 && index < count,
+              let range = Range(range(at: index), in: text) else {
+            return nil
+        }
+        return text[range]
+    }
+
+    private static func isWhitespace(_ unit: UInt16) -> Bool {
+        switch unit {
+        case 0x09...0x0D, 0x20, 0x85, 0xA0, 0x1680, 0x2000...0x200A, 0x2028, 0x2029, 0x202F, 0x205F, 0x3000:
+            return true
+        default:
+            return false
+        }
+    }
+}
@@ -0,0 +1,420 @@
+//
+//  Benchmark.swift
+//  OpraCLI
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import AVFoundation
+
+/// `opra-cli benchmark`: measures each stage of the reading pipeline on its own over the
+/// generated `BenchmarkCorpus`, so a slowdown can be pinned to extraction, preprocessing,
+/// chunking or speech rather than showing up only as "conversion got slower".
+///
+/// Timed stages run `--iterations` times and report the median. `--json` writes the results with
+/// a label (usually the commit) and `--baseline` compares against a file written earlier, which is
+/// how results are compared across commits.
+enum Benchmark {
+    static let usage = """
+    Usage: opra-cli benchmark [options]
+
+    Options:
+      --corpus <dir>        Where the generated PDFs are kept (default: \(BenchmarkCorpus.defaultDirectory.path))
+      --kinds <list>        Comma-separated: \(BenchmarkCorpus.Kind.allCases.map(\.rawValue).joined(separator: ",")) (default: all)
+      --sizes <list>        Comma-separated: \(BenchmarkCorpus.Size.allCases.map(\.name).joined(separator: ",")) (default: all)
+      --iterations <n>      Runs per timed stage; the median is reported (default: \(BenchmarkOptions.defaultIterations))
+      --workers <n>         Extraction threads (default: \(BenchmarkOptions.defaultWorkers))
+      --speech-chunks <n>   Chunks to synthesize for the speech timings, 0 to skip (default: \(BenchmarkOptions.defaultSpeechChunks))
+      --app <path>          Also launch this Opra.app --iterations times and time its first window
+      --label <text>        Name for this run in the JSON, such as the commit (default: none)
+      --json <file>         Write the results as JSON
+      --baseline <file>     Compare against JSON written by an earlier run
+      --threshold <pct>     Change versus the baseline reported as a regression (default: \(BenchmarkOptions.defaultThreshold))
+      -h, --help            Show this help
+
+    Scanned documents are extracted once rather than --iterations times, since every page goes
+    through OCR; scanned-2000 takes a long time. Speech is rendered offline with
+    AVSpeechSynthesizer.write, so the timings exclude the audio device. Exits with status 1 if
+    any metric regressed past --threshold.
+    """
+
+    static func run(arguments: [String]) async -> Int32 {
+        let options: BenchmarkOptions
+        do {
+            options = try BenchmarkOptions(arguments: arguments)
+        } catch {
+            FileHandle.standardError.write(Data("\(error.localizedDescription)\n\n\(usage)\n".utf8))
+            return 2
+        }
+        if options.showHelp {
+            print(usage)
+            return 0
+        }
+
+        let documents: [BenchmarkCorpus.Document]
+        do {
+            documents = try BenchmarkCorpus(directory: options.corpusDirectory).documents(kinds: options.kinds, sizes: options.sizes)
+        } catch {
+            FileHandle.standardError.write(Data("Could not generate the corpus: \(error.localizedDescription)\n".utf8))
+            return 1
+        }
+
+        var report = BenchmarkReport(label: options.label)
+        if let appURL = options.app {
+            print("launch:")
+            guard let result = measureLaunch(of: appURL, runs: options.iterations) else {
+                FileHandle.standardError.write(Data("Could not launch \(appURL.path)\n".utf8))
+                return 1
+            }
+            print("  \(result.formatted)")
+            report.results.append(result)
+        }
+        for document in documents {
+            print("\(document.name):")
+            for result in await measure(document, options: options) {
+                print("  \(result.formatted)")
+                report.results.append(result)
+            }
+        }
+
+        if let jsonURL = options.jsonOutput {
+            do {
+                let encoder = JSONEncoder()
+                encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+                encoder.dateEncodingStrategy = .iso8601
+                try encoder.encode(report).write(to: jsonURL)
+                print("Results written to \(jsonURL.path)")
+            } catch {
+                FileHandle.standardError.write(Data("Could not write \(jsonURL.path): \(error.localizedDescription)\n".utf8))
+                return 1
+            }
+        }
+
+        if let baselineURL = options.baseline {
+            let decoder = JSONDecoder()
+            decoder.dateDecodingStrategy = .iso8601
+            guard let data = try? Data(contentsOf: baselineURL), let baseline = try? decoder.decode(BenchmarkReport.self, from: data) else {
+                FileHandle.standardError.write(Data("Could not read the baseline \(baselineURL.path)\n".utf8))
+                return 1
+            }
+            return compare(report, with: baseline, threshold: options.threshold) ? 0 : 1
+        }
+        return 0
+    }
+
+    /// Runs every stage over one document, each stage starting from the previous one's output
+    private static func measure(_ document: BenchmarkCorpus.Document, options: BenchmarkOptions) async -> [BenchmarkResult] {
+        var results: [BenchmarkResult] = []
+        func record(_ metric: String, _ value: Double, _ unit: String, higherIsBetter: Bool) {
+            results.append(BenchmarkResult(document: document.name, metric: metric, value: value, unit: unit, higherIsBetter: higherIsBetter))
+        }
+
+        // Extraction, without the on-disk cache so every run extracts every page
+        let extractionRuns = document.kind == .scanned ? 1 : options.iterations
+        let (extractionTime, pageTexts) = median(of: extractionRuns) {
+            PDFTextExtractor.extractDocument(at: document.url, workers: options.workers) ?? []
+        }
+        guard !pageTexts.isEmpty else {
+            print("  could not open \(document.url.path)")
+            return results
+        }
+        record("extract.pages_per_s", Double(pageTexts.count) / extractionTime, "pages/s", higherIsBetter: true)
+
+        var text = ""
+        for (pageIndex, pageText) in pageTexts.enumerated() {
+            if let pageText = pageText {
+                text += PDFTextExtractor.assembledPage(pageIndex, text: pageText)
+            }
+        }
+        text.makeContiguousUTF8()
+        let megabytes = Double(text.utf8.count) / 1_048_576
+
+        // Chunking, the way the extractor chunks its assembled text
+        let chunker = TextChunker()
+        let footprintBefore = MemoryGauge.footprint
+        let (chunkingTime, chunkRanges) = median(of: options.iterations) {
+            text.utf8.withContiguousStorageIfAvailable { chunker.chunkRanges(in: $0) } ?? []
+        }
+        let footprintAfter = MemoryGauge.footprint
+        let chunkMemory = Double(footprintAfter > footprintBefore ? footprintAfter - footprintBefore : 0) / 1_048_576
+        let utf8 = text.utf8
+        let chunks = chunkRanges.map { range in
+            text[utf8.index(utf8.startIndex, offsetBy: range.lowerBound)..<utf8.index(utf8.startIndex, offsetBy: range.upperBound)]
+        }
+        record("chunk.ms", chunkingTime * 1000, "ms", higherIsBetter: false)
+        record("chunk.memory_mb", chunkMemory, "MB", higherIsBetter: false)
+
+        // Preprocessing: TTS normalization of every chunk, as playback does before speaking it
+        let (preprocessTime, _) = median(of: options.iterations) {
+            chunks.map { TextNormalizer.shared.normalize(String($0), options: .speechSafe) }
+        }
+        record("preprocess.mb_per_s", megabytes / preprocessTime, "MB/s", higherIsBetter: true)
+        record("peak_footprint_mb", Double(MemoryGauge.peakFootprint) / 1_048_576, "MB", higherIsBetter: false)
+
+        // Speech: the first chunk on a fresh synthesizer, then each next one as soon as it finishes
+        if options.speechChunks > 0 {
+            let speechChunker = TextChunker(targetLength: TextChunker.minimumTargetLength)
+            let speechTexts = speechChunker.chunks(of: String(text.prefix(TextChunker.minimumTargetLength * options.speechChunks * 2)))
+                .prefix(options.speechChunks)
+                .map { TextNormalizer.shared.normalize(String($0), options: .speechSafe) }
+            var firstUtterance: [TimeInterval] = []
+            var gaps: [TimeInterval] = []
+            for _ in 0..<options.iterations {
+                let delays = await firstBufferDelays(Array(speechTexts))
+                if let first = delays.first {
+                    firstUtterance.append(first)
+                }
+                gaps += delays.dropFirst()
+            }
+            if !firstUtterance.isEmpty {
+                record("speech.first_utterance_ms", median(firstUtterance) * 1000, "ms", higherIsBetter: false)
+            }
+            if !gaps.isEmpty {
+                record("speech.chunk_gap_ms", median(gaps) * 1000, "ms", higherIsBetter: false)
+            }
+        }
+
+        return results
+    }
+
+    /// Median time from starting the app's process to its first window taking input, as the app
+    /// reports it with `LaunchTiming.measureArgument`. Nil if the app can't be started.
+    private static func measureLaunch(of appURL: URL, runs: Int) -> BenchmarkResult? {
+        guard let executableURL = Bundle(url: appURL)?.executableURL else { return nil }
+        var times: [TimeInterval] = []
+        for _ in 0..<max(1, runs) {
+            let outputURL = FileManager.default.temporaryDirectory.appendingPathComponent("opra-launch-\(UUID().uuidString).txt")
+            defer { try? FileManager.default.removeItem(at: outputURL) }
+
+            let process = Process()
+            process.executableURL = executableURL
+            process.arguments = [LaunchTiming.measureArgument, outputURL.path]
+            do {
+                try process.run()
+            } catch {
+                return nil
+            }
+            process.waitUntilExit()
+            if let text = try? String(contentsOf: outputURL, encoding: .utf8), let milliseconds = Double(text) {
+                times.append(milliseconds)
+            }
+        }
+        guard !times.isEmpty else { return nil }
+        return BenchmarkResult(document: "launch", metric: "launch.interactive_ms", value: median(times), unit: "ms", higherIsBetter: false)
+    }
+
+    /// For each text, the time from handing it to the synthesizer to its first audio buffer. The
+    /// texts go to one synthesizer in turn, each as soon as the previous one has been rendered.
+    private static func firstBufferDelays(_ texts: [String]) async -> [TimeInterval] {
+        let synthesizer = AVSpeechSynthesizer()
+        var delays: [TimeInterval] = []
+        for text in texts {
+            let utterance = AVSpeechUtterance(string: text)
+            let clock = FirstBufferClock()
+            await withCheckedContinuation { (continuation: CheckedContinuation<Void, Never>) in
+                synthesizer.write(utterance) { buffer in
+                    guard let pcmBuffer = buffer as? AVAudioPCMBuffer else { return }
+                    // An empty buffer marks the end of the utterance
+                    if pcmBuffer.frameLength > 0 {
+                        clock.markFirstBuffer()
+                    } else {
+                        continuation.resume()
+                    }
+                }
+            }
+            if let delay = clock.delay {
+                delays.append(delay)
+            }
+        }
+        return delays
+    }
+
+    /// Compares each metric with the baseline's and prints the change. Returns false if any got
+    /// worse by more than `threshold` percent.
+    private static func compare(_ report: BenchmarkReport, with baseline: BenchmarkReport, threshold: Double) -> Bool {
+        if report.corpus != baseline.corpus {
+            print("Warning: the baseline was measured on corpus \(baseline.corpus), this run on \(report.corpus)")
+        }
+        print("Compared with \(baseline.label ?? "baseline") (\(baseline.date.formatted(date: .abbreviated, time: .shortened))):")
+
+        let baselineValues = Dictionary(baseline.results.map { ("\($0.document) \($0.metric)", $0.value) }, uniquingKeysWith: { first, _ in first })
+        var regressions = 0
+        for result in report.results {
+            guard let previous = baselineValues["\(result.document) \(result.metric)"], previous != 0 else { continue }
+            let change = (result.value - previous) / previous * 100
+            let isRegression = (result.higherIsBetter ? -change : change) > threshold
+            regressions += isRegression ? 1 : 0
+            print(String(format: "  %@ %@: %.2f → %.2f %@ (%+.1f%%)%@",
+                         result.document, result.metric, previous, result.value, result.unit, change, isRegression ? "  REGRESSED" : ""))
+        }
+        print(regressions == 0 ? "No regressions past \(threshold)%" : "\(regressions) regression(s) past \(threshold)%")
+        return regressions == 0
+    }
+
+    /// Median wall-clock seconds of `runs` calls of `body`, and what the last call returned
+    private static func median<Output>(of runs: Int, _ body: () -> Output) -> (TimeInterval, Output) {
+        var times: [TimeInterval] = []
+        var output: Output?
+        for _ in 0..<max(1, runs) {
+            let start = DispatchTime.now().uptimeNanoseconds
+            output = body()
+            times.append(max(TimeInterval(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000_000, 1e-9))
+        }
+        return (median(times), output!)
+    }
+
+    private static func median(_ values: [TimeInterval]) -> TimeInterval {
+        let sorted = values.sorted()
+        return sorted.count.isMultiple(of: 2) ? (sorted[sorted.count / 2 - 1] + sorted[sorted.count / 2]) / 2 : sorted[sorted.count / 2]
+    }
+}
+
+/// Records when the synthesizer delivered its first buffer; written from the synthesizer's thread
+private final class FirstBufferClock: @unchecked Sendable {
+    private let lock = NSLock()
+    private let start = DispatchTime.now().uptimeNanoseconds
+    private var firstBuffer: UInt64?
+
+    func markFirstBuffer() {
+        lock.lock()
+        firstBuffer = firstBuffer ?? DispatchTime.now().uptimeNanoseconds
+        lock.unlock()
+    }
+
+    var delay: TimeInterval? {
+        lock.lock()
+        defer { lock.unlock() }
+        return firstBuffer.map { TimeInterval($0 - start) / 1_000_000_000 }
+    }
+}
+
+// MARK: - Memory
+
+enum MemoryGauge {
+    /// The process's physical footprint, the figure Activity Monitor shows as Memory
+    static var footprint: UInt64 {
+        return vmInfo()?.phys_footprint ?? 0
+    }
+
+    /// The highest `footprint` the process has reached so far
+    static var peakFootprint: UInt64 {
+        return vmInfo().map { UInt64($0.ledger_phys_footprint_peak) } ?? 0
+    }
+
+    private static func vmInfo() -> task_vm_info_data_t? {
+        var info = task_vm_info_data_t()
+        var count = mach_msg_type_number_t(MemoryLayout<task_vm_info_data_t>.size / MemoryLayout<natural_t>.size)
+        let result = withUnsafeMutablePointer(to: &info) { pointer in
+            pointer.withMemoryRebound(to: integer_t.self, capacity: Int(count)) {
+                task_info(mach_task_self_, task_flavor_t(TASK_VM_INFO), $0, &count)
+            }
+        }
+        return result == KERN_SUCCESS ? info : nil
+    }
+}
+
+// MARK: - Results
+
+struct BenchmarkResult: Codable {
+    let document: String
+    let metric: String
+    let value: Double
+    let unit: String
+    let higherIsBetter: Bool
+
+    var formatted: String {
+        return String(format: "%@: %.2f %@", metric, value, unit)
+    }
+}
+
+struct BenchmarkReport: Codable {
+    var label: String?
+    var date = Date()
+    var corpus = BenchmarkCorpus.version
+    var system = ProcessInfo.processInfo.operatingSystemVersionString
+    var processors = ProcessInfo.processInfo.activeProcessorCount
+    var results: [BenchmarkResult] = []
+
+    init(label: String?) {
+        self.label = label
+    }
+}
+
+// MARK: - Options
+
+struct BenchmarkOptions {
+    static let defaultIterations = 3
+    static let defaultWorkers = ProcessInfo.processInfo.activeProcessorCount
+    static let defaultSpeechChunks = 4
+    static let defaultThreshold = 5.0
+
+    var corpusDirectory = BenchmarkCorpus.defaultDirectory
+    var kinds = BenchmarkCorpus.Kind.allCases
+    var sizes = BenchmarkCorpus.Size.allCases
+    var iterations = defaultIterations
+    var workers = defaultWorkers
+    var speechChunks = defaultSpeechChunks
+    var app: URL?
+    var label: String?
+    var jsonOutput: URL?
+    var baseline: URL?
+    var threshold = defaultThreshold
+    var showHelp = false
+
+    init(arguments: [String]) throws {
+        var arguments = arguments.makeIterator()
+        while let argument = arguments.next() {
+            func value() throws -> String {
+                guard let value = arguments.next() else { throw Options.ParseError.missingValue(argument) }
+                return value
+            }
+            func count(allowingZero: Bool = false) throws -> Int {
+                let value = try value()
+                guard let count = Int(value), count > 0 || (allowingZero && count == 0) else {
+                    throw Options.ParseError.invalidValue(argument, value)
+                }
+                return count
+            }
+            func list<Value>(_ parse: (String) -> Value?) throws -> [Value] {
+                let value = try value()
+                let items = value.split(separator: ",").map { parse(String($0)) }
+                guard !items.isEmpty, !items.contains(where: { $0 == nil }) else {
+                    throw Options.ParseError.invalidValue(argument, value)
+                }
+                return items.compactMap { $0 }
+            }
+
+            switch argument {
+            case "--corpus":
+                corpusDirectory = URL(fileURLWithPath: try value(), isDirectory: true)
+            case "--kinds":
+                kinds = try list { BenchmarkCorpus.Kind(rawValue: $0) }
+            case "--sizes":
+                sizes = try list { name in BenchmarkCorpus.Size.allCases.first { $0.name == name } }
+            case "--iterations":
+                iterations = try count()
+            case "--workers":
+                workers = try count()
+            case "--speech-chunks":
+                speechChunks = try count(allowingZero: true)
+            case "--app":
+                app = URL(fileURLWithPath: try value(), isDirectory: true)
+            case "--label":
+                label = try value()
+            case "--json":
+                jsonOutput = URL(fileURLWithPath: try value())
+            case "--baseline":
+                baseline = URL(fileURLWithPath: try value())
+            case "--threshold":
+                let value = try value()
+                guard let threshold = Double(value), threshold >= 0 else { throw Options.ParseError.invalidValue(argument, value) }
+                self.threshold = threshold
+            case "-h", "--help":
+                showHelp = true
+            default:
+                throw Options.ParseError.unknownOption(argument)
+            }
+        }
+    }
+}
@@ -0,0 +1,224 @@
+//
+//  BenchmarkCorpus.swift
+//  OpraCLI
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import CoreGraphics
+import CoreText
+
+/// The fixed set of PDFs `opra-cli benchmark` measures: every `Kind` at every `Size`.
+///
+/// Documents are generated from a seeded generator, so every machine and every commit measures
+/// the same pages. They are written once into a directory named after `version` and reused; bump
+/// `version` whenever the generator changes so results from different corpora are never compared.
+struct BenchmarkCorpus {
+    static let version = "v1"
+    static let pageSize = CGSize(width: 612, height: 792) // US Letter
+    static let margin: CGFloat = 72
+    static let wordsPerPage = 380
+
+    enum Kind: String, CaseIterable {
+        /// Plain prose with a text layer
+        case text
+        /// Prose mixed with LaTeX commands and Unicode math, the input TextNormalizer rewrites most
+        case math
+        /// Prose pages drawn as images with no text layer, so every page goes through OCR
+        case scanned
+    }
+
+    enum Size: Int, CaseIterable {
+        case small = 10
+        case medium = 500
+        case large = 2000
+
+        var name: String {
+            switch self {
+            case .small: return "small"
+            case .medium: return "500"
+            case .large: return "2000"
+            }
+        }
+    }
+
+    struct Document {
+        let kind: Kind
+        let size: Size
+        let url: URL
+
+        var name: String { "\(kind.rawValue)-\(size.name)" }
+        var pageCount: Int { size.rawValue }
+    }
+
+    static var defaultDirectory: URL {
+        let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first
+            ?? FileManager.default.temporaryDirectory
+        return caches.appendingPathComponent("Opra/BenchmarkCorpus", isDirectory: true)
+    }
+
+    let directory: URL
+
+    init(directory: URL = BenchmarkCorpus.defaultDirectory) {
+        self.directory = directory.appendingPathComponent(Self.version, isDirectory: true)
+    }
+
+    /// The requested documents, generating the ones not on disk yet
+    func documents(kinds: [Kind], sizes: [Size]) throws -> [Document] {
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+
+        var documents: [Document] = []
+        for kind in kinds {
+            for size in sizes {
+                let document = Document(kind: kind, size: size, url: directory.appendingPathComponent("\(kind.rawValue)-\(size.name).pdf"))
+                if !FileManager.default.fileExists(atPath: document.url.path) {
+                    print("Generating \(document.name).pdf (\(size.rawValue) pages)")
+                    try Self.generate(document)
+                }
+                documents.append(document)
+            }
+        }
+        return documents
+    }
+
+    // MARK: - Generation
+
+    private enum GenerationError: LocalizedError {
+        case cannotCreate(URL)
+
+        var errorDescription: String? {
+            switch self {
+            case .cannotCreate(let url):
+                return "Could not create \(url.path)"
+            }
+        }
+    }
+
+    private static func generate(_ document: Document) throws {
+        // Written next to the final name and moved into place, so an interrupted run never leaves
+        // a truncated document behind to be measured next time
+        let partialURL = document.url.appendingPathExtension("partial")
+        var mediaBox = CGRect(origin: .zero, size: pageSize)
+        guard let context = CGContext(partialURL as CFURL, mediaBox: &mediaBox, nil) else {
+            throw GenerationError.cannotCreate(partialURL)
+        }
+
+        // Each kind gets its own seed so text and math pages don't share sentences
+        var generator = SeededGenerator(seed: UInt64(Kind.allCases.firstIndex(of: document.kind)! + 1))
+        for pageIndex in 0..<document.pageCount {
+            autoreleasepool {
+                let text = pageText(pageIndex, kind: document.kind, using: &generator)
+                context.beginPDFPage(nil)
+                if document.kind == .scanned, let image = renderedPage(text) {
+                    context.draw(image, in: mediaBox)
+                } else {
+                    draw(text, in: context)
+                }
+                context.endPDFPage()
+            }
+        }
+        context.closePDF()
+
+        try? FileManager.default.removeItem(at: document.url)
+        try FileManager.default.moveItem(at: partialURL, to: document.url)
+    }
+
+    private static func pageText(_ pageIndex: Int, kind: Kind, using generator: inout SeededGenerator) -> String {
+        var paragraphs: [String] = ["Chapter \(pageIndex / 20 + 1), section \(pageIndex + 1)"]
+        var words = 0
+        while words < wordsPerPage {
+            var sentences: [String] = []
+            for _ in 0..<Int.random(in: 3...6, using: &generator) {
+                let sentence = self.sentence(kind: kind, using: &generator)
+                words += sentence.split(separator: " ").count
+                sentences.append(sentence)
+            }
+            paragraphs.append(sentences.joined(separator: " "))
+        }
+        return paragraphs.joined(separator: "\n\n")
+    }
+
+    private static func sentence(kind: Kind, using generator: inout SeededGenerator) -> String {
+        var words = (0..<Int.random(in: 8...22, using: &generator)).map { _ in vocabulary.randomElement(using: &generator)! }
+        if kind == .math {
+            // A third of math sentences carry one to three formula fragments
+            for _ in 0..<(Int.random(in: 0...2, using: &generator) == 0 ? Int.random(in: 1...3, using: &generator) : 0) {
+                let position = Int.random(in: 1..<words.count, using: &generator)
+                words.insert(formula(using: &generator), at: position)
+            }
+        }
+        return words[0].prefix(1).uppercased() + words.joined(separator: " ").dropFirst() + "."
+    }
+
+    private static func formula(using generator: inout SeededGenerator) -> String {
+        let parts = (0..<Int.random(in: 2...4, using: &generator)).map { index in
+            index.isMultiple(of: 2) ? operands.randomElement(using: &generator)! : mathSymbols.randomElement(using: &generator)!
+        }
+        return "$" + parts.joined(separator: " ") + "$"
+    }
+
+    private static func framesetter(for text: String) -> CTFramesetter {
+        let font = CTFontCreateWithName("Times New Roman" as CFString, 11, nil)
+        let attributed = NSAttributedString(string: text, attributes: [NSAttributedString.Key(kCTFontAttributeName as String): font])
+        return CTFramesetterCreateWithAttributedString(attributed)
+    }
+
+    private static func draw(_ text: String, in context: CGContext) {
+        let bounds = CGRect(origin: .zero, size: pageSize).insetBy(dx: margin, dy: margin)
+        let frame = CTFramesetterCreateFrame(framesetter(for: text), CFRange(location: 0, length: 0), CGPath(rect: bounds, transform: nil), nil)
+        CTFrameDraw(frame, context)
+    }
+
+    /// The page drawn into a grayscale bitmap at the resolution PageRecognizer renders at
+    private static func renderedPage(_ text: String) -> CGImage? {
+        let scale = PageRecognizer.renderScale
+        guard let context = CGContext(data: nil,
+                                      width: Int(pageSize.width * scale),
+                                      height: Int(pageSize.height * scale),
+                                      bitsPerComponent: 8,
+                                      bytesPerRow: 0,
+                                      space: CGColorSpaceCreateDeviceGray(),
+                                      bitmapInfo: CGImageAlphaInfo.none.rawValue) else {
+            return nil
+        }
+        context.setFillColor(gray: 1, alpha: 1)
+        context.fill(CGRect(x: 0, y: 0, width: context.width, height: context.height))
+        context.scaleBy(x: scale, y: scale)
+        draw(text, in: context)
+        return context.makeImage()
+    }
+
+    // The LaTeX commands and Unicode symbols TextNormalizer knows, without the $ delimiters
+    private static let mathSymbols = TextNormalizer.mathRules.map(\.pattern).filter {
+        !$0.contains("$") && ($0.count > 1 || $0.unicodeScalars.first!.value > 0x7F)
+    }
+    private static let operands = ["x", "y", "n", "k", "f(x)", "a_i", "2", "10"]
+
+    private static let vocabulary = """
+    the of and to in is that for it as was with be by on not he this are or his from at which but \
+    have an they you were her she there been one all we their has would when if so no what up out \
+    reading voice page document chapter system model result value process method figure table \
+    between through during before after under within against without among toward around \
+    important different possible general several particular common available recent original \
+    measure describe consider provide develop require suggest remain include continue follow \
+    energy structure function pattern language history theory evidence analysis sequence
+    """.split(whereSeparator: { $0 == " " || $0 == "\n" }).map(String.init)
+}
+
+/// SplitMix64: small, fast and the same on every platform, unlike `SystemRandomNumberGenerator`
+struct SeededGenerator: RandomNumberGenerator {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E37_79B9_7F4A_7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58_476D_1CE4_E5B9
+        z = (z ^ (z >> 27)) &* 0x94D0_49BB_1331_11EB
+        return z ^ (z >> 31)
+    }
+}
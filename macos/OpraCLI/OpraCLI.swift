@@ -0,0 +1,272 @@
+//
+//  OpraCLI.swift
+//  OpraCLI
+//
+//  Created by Francesco Vezzani on 12/10/25.
+//
+
+import Foundation
+import AVFoundation
+
+/// Headless bulk converter: runs the app's extraction → normalization → speech pipeline over many
+/// PDFs and writes `<name>.m4a` plus its `<name>.chapters.txt` timing sidecar for each.
+///
+/// Documents are converted `--jobs` at a time, each with its own synthesizer. Every document and
+/// the whole run report pages per second and seconds of audio per wall-clock second.
+@main
+struct OpraCLI {
+    static let usage = """
+    Usage: opra-cli [options] <file.pdf | folder>...
+           opra-cli benchmark [options]   Measure each pipeline stage (see opra-cli benchmark --help)
+
+    Options:
+      -o, --output <dir>   Write audio to <dir> instead of next to each PDF; PDFs
+                           found in subfolders keep their subfolder under <dir>
+      -j, --jobs <n>       Documents to convert at once (default: \(Options.defaultJobs))
+      --voice <id>         Voice identifier to speak with (default: system voice)
+      --rate <rate>        Speech rate from \(AVSpeechUtteranceMinimumSpeechRate) to \(AVSpeechUtteranceMaximumSpeechRate) (default: \(AVSpeechUtteranceDefaultSpeechRate))
+      --layout             Read columns in order and skip running headers, footers and page numbers
+      --list-voices        Print the available voice identifiers and exit
+      -h, --help           Show this help
+    """
+
+    static func main() async {
+        if CommandLine.arguments.dropFirst().first == "benchmark" {
+            exit(await Benchmark.run(arguments: Array(CommandLine.arguments.dropFirst(2))))
+        }
+
+        let options: Options
+        do {
+            options = try Options(arguments: Array(CommandLine.arguments.dropFirst()))
+        } catch {
+            FileHandle.standardError.write(Data("\(error.localizedDescription)\n\n\(usage)\n".utf8))
+            exit(2)
+        }
+
+        if options.showHelp {
+            print(usage)
+            return
+        }
+        if options.listVoices {
+            for voice in AVSpeechSynthesisVoice.speechVoices() {
+                print("\(voice.identifier)\t\(voice.language)\t\(voice.name)")
+            }
+            return
+        }
+
+        let voice = options.voiceIdentifier.flatMap { AVSpeechSynthesisVoice(identifier: $0) }
+        if let identifier = options.voiceIdentifier, voice == nil {
+            FileHandle.standardError.write(Data("Unknown voice \(identifier); see --list-voices\n".utf8))
+            exit(2)
+        }
+
+        let documents = collectDocuments(options.inputs)
+        guard !documents.isEmpty else {
+            FileHandle.standardError.write(Data("No PDF files found\n".utf8))
+            exit(1)
+        }
+
+        // Two outputs with one name would overwrite each other, at the same time with --jobs
+        let destinations = documents.map { outputURL(for: $0, in: options.outputDirectory) }
+        var sources: [String: URL] = [:]
+        for (document, destination) in zip(documents, destinations) {
+            let name = destination.standardizedFileURL.path.lowercased() // File names are case-insensitive
+            if let other = sources[name] {
+                FileHandle.standardError.write(Data("\(other.path) and \(document.url.path) would both be written to \(destination.path)\n".utf8))
+                exit(2)
+            }
+            sources[name] = document.url
+        }
+        for directory in Set(destinations.map { $0.deletingLastPathComponent() }) {
+            try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        }
+
+        print("Converting \(documents.count) document(s) with \(options.jobs) worker(s)")
+        let start = Date()
+        var totals = Throughput()
+        var failures = 0
+
+        await withTaskGroup(of: Throughput?.self) { group in
+            var remaining = zip(documents, destinations).makeIterator()
+
+            // Keep `jobs` conversions running; a new document starts whenever one finishes
+            func startNext() {
+                guard let (document, destination) = remaining.next() else { return }
+                let url = document.url
+                let rate = options.rate
+                let mode = options.extractionMode
+                group.addTask {
+                    await convert(url, to: destination, voice: voice, rate: rate, mode: mode)
+                }
+            }
+
+            for _ in 0..<options.jobs {
+                startNext()
+            }
+            for await throughput in group {
+                if let throughput = throughput {
+                    totals.pages += throughput.pages
+                    totals.audioDuration += throughput.audioDuration
+                } else {
+                    failures += 1
+                }
+                startNext()
+            }
+        }
+
+        totals.wallTime = Date().timeIntervalSince(start)
+        print("Done: \(documents.count - failures) converted, \(failures) failed. \(totals.summary)")
+        exit(failures == 0 ? 0 : 1)
+    }
+
+    /// Converts one document and prints its throughput. Returns nil if it failed.
+    private static func convert(_ document: URL, to outputURL: URL, voice: AVSpeechSynthesisVoice?, rate: Float, mode: ExtractionMode) async -> Throughput? {
+        let start = Date()
+        guard let stream = PDFTextExtractor.streamDocumentPages(at: document, mode: mode) else {
+            FileHandle.standardError.write(Data("\(document.lastPathComponent): could not open PDF\n".utf8))
+            return nil
+        }
+
+        do {
+            let result = try await AudioExporter.renderDocument(stream.pages, voice: voice, rate: rate, to: outputURL)
+            let throughput = Throughput(pages: result.pageCount, audioDuration: result.duration, wallTime: Date().timeIntervalSince(start))
+            print("\(document.lastPathComponent): \(result.pageCount) of \(stream.pageCount) pages → \(outputURL.lastPathComponent). \(throughput.summary)")
+            return throughput
+        } catch {
+            FileHandle.standardError.write(Data("\(document.lastPathComponent): export failed: \(error.localizedDescription)\n".utf8))
+            return nil
+        }
+    }
+
+    /// A PDF to convert, with the subfolder it was found in below a folder named on the command line
+    private struct Document {
+        let url: URL
+        var subfolders: [String] = []
+    }
+
+    /// PDFs named on the command line, plus every PDF found (recursively) in the folders named.
+    /// A PDF named more than once is converted once.
+    private static func collectDocuments(_ inputs: [URL]) -> [Document] {
+        var documents: [String: Document] = [:]
+        func add(_ document: Document) {
+            let path = document.url.standardizedFileURL.path
+            if documents[path] == nil {
+                documents[path] = document
+            }
+        }
+        for input in inputs {
+            var isDirectory: ObjCBool = false
+            guard FileManager.default.fileExists(atPath: input.path, isDirectory: &isDirectory) else {
+                FileHandle.standardError.write(Data("Skipping \(input.path): no such file or folder\n".utf8))
+                continue
+            }
+            guard isDirectory.boolValue else {
+                add(Document(url: input))
+                continue
+            }
+
+            let folder = input.standardizedFileURL.pathComponents
+            let enumerator = FileManager.default.enumerator(at: input, includingPropertiesForKeys: nil, options: [.skipsHiddenFiles])
+            while let fileURL = enumerator?.nextObject() as? URL {
+                if fileURL.pathExtension.lowercased() == "pdf" {
+                    let subfolders = fileURL.deletingLastPathComponent().standardizedFileURL.pathComponents.dropFirst(folder.count)
+                    add(Document(url: fileURL, subfolders: Array(subfolders)))
+                }
+            }
+        }
+        return documents.values.sorted { $0.url.path < $1.url.path }
+    }
+
+    private static func outputURL(for document: Document, in outputDirectory: URL?) -> URL {
+        let directory = outputDirectory.map { document.subfolders.reduce($0) { $0.appendingPathComponent($1, isDirectory: true) } }
+            ?? document.url.deletingLastPathComponent()
+        return directory.appendingPathComponent(document.url.deletingPathExtension().lastPathComponent).appendingPathExtension("m4a")
+    }
+}
+
+// MARK: - Throughput
+
+struct Throughput {
+    var pages = 0
+    var audioDuration: TimeInterval = 0
+    var wallTime: TimeInterval = 0
+
+    var summary: String {
+        let wallTime = max(self.wallTime, 0.001)
+        return String(format: "%d pages, %.1f s audio in %.1f s (%.2f pages/s, %.2f audio-s/s)",
+                      pages, audioDuration, wallTime, Double(pages) / wallTime, audioDuration / wallTime)
+    }
+}
+
+// MARK: - Options
+
+struct Options {
+    static let defaultJobs = max(1, ProcessInfo.processInfo.activeProcessorCount / 2)
+
+    var inputs: [URL] = []
+    var outputDirectory: URL?
+    var jobs = defaultJobs
+    var voiceIdentifier: String?
+    var rate = AVSpeechUtteranceDefaultSpeechRate
+    var extractionMode = ExtractionMode.plain
+    var listVoices = false
+    var showHelp = false
+
+    enum ParseError: LocalizedError {
+        case missingValue(String)
+        case invalidValue(String, String)
+        case unknownOption(String)
+        case noInputs
+
+        var errorDescription: String? {
+            switch self {
+            case .missingValue(let option):
+                return "Missing value for \(option)"
+            case .invalidValue(let option, let value):
+                return "Invalid value \(value) for \(option)"
+            case .unknownOption(let option):
+                return "Unknown option \(option)"
+            case .noInputs:
+                return "No PDF files or folders given"
+            }
+        }
+    }
+
+    init(arguments: [String]) throws {
+        var arguments = arguments.makeIterator()
+        while let argument = arguments.next() {
+            func value() throws -> String {
+                guard let value = arguments.next() else { throw ParseError.missingValue(argument) }
+                return value
+            }
+
+            switch argument {
+            case "-o", "--output":
+                outputDirectory = URL(fileURLWithPath: try value(), isDirectory: true)
+            case "-j", "--jobs":
+                let value = try value()
+                guard let jobs = Int(value), jobs > 0 else { throw ParseError.invalidValue(argument, value) }
+                self.jobs = jobs
+            case "--voice":
+                voiceIdentifier = try value()
+            case "--rate":
+                let value = try value()
+                guard let rate = Float(value) else { throw ParseError.invalidValue(argument, value) }
+                self.rate = max(AVSpeechUtteranceMinimumSpeechRate, min(AVSpeechUtteranceMaximumSpeechRate, rate))
+            case "--layout":
+                extractionMode = .layout
+            case "--list-voices":
+                listVoices = true
+            case "-h", "--help":
+                showHelp = true
+            default:
+                guard !argument.hasPrefix("-") else { throw ParseError.unknownOption(argument) }
+                inputs.append(URL(fileURLWithPath: argument))
+            }
+        }
+
+        if inputs.isEmpty && !listVoices && !showHelp {
+            throw ParseError.noInputs
+        }
+    }
+}
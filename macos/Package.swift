@@ -0,0 +1,50 @@
+// swift-tools-version:5.9
+//
+// Headless command-line converter. The app itself is built from Opra.xcodeproj; this package
+// compiles the UI-free parts of the pipeline from Opra/ together with OpraCLI/, which also holds
+// the `opra-cli benchmark` harness.
+
+import PackageDescription
+
+let package = Package(
+    name: "OpraCLI",
+    platforms: [.macOS(.v14)],
+    products: [
+        .executable(name: "opra-cli", targets: ["opra-cli"])
+    ],
+    targets: [
+        .executableTarget(
+            name: "opra-cli",
+            path: ".",
+            exclude: [
+                "Opra.xcodeproj",
+                "ExportOptions.plist",
+                "README.md",
+                "Opra/Assets.xcassets",
+                "Opra/Preview Content",
+                "Opra/Info.plist",
+                "Opra/Opra.entitlements"
+            ],
+            sources: [
+                "Opra/AudioExporter.swift",
+                "Opra/ExtractedPageQueue.swift",
+                "Opra/ExtractionCache.swift",
+                "Opra/Instrumentation.swift",
+                "Opra/PageLayout.swift",
+                "Opra/PageRecognizer.swift",
+                "Opra/PDFTextExtractor.swift",
+                "Opra/PipelineMetrics.swift",
+                "Opra/SearchIndex.swift",
+                "Opra/SettingsManager.swift",
+                "Opra/TextChunker.swift",
+                "Opra/TextNormalizer.swift",
+                "Opra/TextStore.swift",
+                "Opra/VoiceCatalog.swift",
+                "Opra/WordIndex.swift",
+                "OpraCLI/Benchmark.swift",
+                "OpraCLI/BenchmarkCorpus.swift",
+                "OpraCLI/OpraCLI.swift"
+            ]
+        )
+    ]
+)
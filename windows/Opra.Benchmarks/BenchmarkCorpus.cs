@@ -0,0 +1,282 @@
+using iText.IO.Font.Constants;
+using iText.IO.Image;
+using iText.Kernel.Font;
+using iText.Kernel.Geom;
+using iText.Kernel.Pdf;
+using iText.Kernel.Pdf.Canvas;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using Windows.Storage;
+using Windows.Storage.Streams;
+using Path = System.IO.Path;
+using WinPdf = Windows.Data.Pdf;
+
+namespace Opra.Benchmarks;
+
+/// <summary>
+/// The fixed set of PDFs the benchmarks measure: text, math-heavy and scanned documents of 10,
+/// 500 and 2000 pages, named like <c>text-500</c>.
+///
+/// Documents are generated from a seeded generator the first time they are asked for and kept in
+/// a directory named after <see cref="Version"/>, so every run measures the same pages. Bump
+/// <see cref="Version"/> whenever the generator changes so results from different corpora are
+/// never compared. The macOS harness generates its own corpus the same way.
+/// </summary>
+public static class BenchmarkCorpus
+{
+    public const string Version = "v1";
+
+    private const int WordsPerPage = 380;
+    private const float FontSize = 11;
+    private const float Leading = 14;
+    private const float Margin = 72;
+    // Same as PageRecognizer's render scale, so scanned pages look like what OCR is given
+    private const double ScanScale = 2.0;
+
+    public static readonly string[] Kinds = { "text", "math", "scanned" };
+    public static readonly (string Name, int Pages)[] Sizes = { ("small", 10), ("500", 500), ("2000", 2000) };
+
+    public static string Directory { get; } = Path.Combine(
+        Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData), "Opra", "BenchmarkCorpus", Version);
+
+    /// <summary>Every document of the given kinds, smallest first.</summary>
+    public static IEnumerable<string> Names(params string[] kinds) =>
+        kinds.SelectMany(kind => Sizes.Select(size => $"{kind}-{size.Name}"));
+
+    public static int PageCount(string name) =>
+        Sizes.First(size => name.EndsWith("-" + size.Name, StringComparison.Ordinal)).Pages;
+
+    /// <summary>The path of a document, generating it first if it is not on disk yet.</summary>
+    public static string PathOf(string name)
+    {
+        var path = Path.Combine(Directory, name + ".pdf");
+        if (!File.Exists(path))
+        {
+            System.IO.Directory.CreateDirectory(Directory);
+            var kind = name[..name.IndexOf('-')];
+            // Written under a temporary name and moved into place, so an interrupted run never
+            // leaves a truncated document behind to be measured next time
+            var partialPath = path + ".partial";
+            if (kind == "scanned")
+            {
+                GenerateScanned(partialPath, PageCount(name));
+            }
+            else
+            {
+                GenerateText(partialPath, PageCount(name), kind);
+            }
+            File.Move(partialPath, path, overwrite: true);
+        }
+        return path;
+    }
+
+    /// <summary>
+    /// The document's text as the app extracts it, without the extraction cache. Kept next to the
+    /// PDF so the stages after extraction start from the same input without extracting again.
+    /// </summary>
+    public static string ExtractedText(string name)
+    {
+        var textPath = Path.Combine(Directory, name + ".txt");
+        if (File.Exists(textPath))
+        {
+            return File.ReadAllText(textPath);
+        }
+
+        var extractor = new PDFTextExtractor { Cache = null };
+        var result = extractor.ExtractTextAsync(PathOf(name)).GetAwaiter().GetResult();
+        if (!result.Success)
+        {
+            throw new InvalidOperationException($"Could not extract {name}: {result.ErrorMessage}");
+        }
+        File.WriteAllText(textPath, result.FullText);
+        return result.FullText;
+    }
+
+    /// <summary>UTF-8 size of <see cref="ExtractedText"/>, or null if it has not been extracted yet.</summary>
+    public static long? ExtractedTextBytes(string name)
+    {
+        var file = new FileInfo(Path.Combine(Directory, name + ".txt"));
+        return file.Exists ? file.Length : null;
+    }
+
+    private static void GenerateText(string path, int pageCount, string kind)
+    {
+        using var writer = new PdfWriter(path);
+        using var document = new PdfDocument(writer);
+        var font = PdfFontFactory.CreateFont(StandardFonts.TIMES_ROMAN);
+        float width = PageSize.LETTER.GetWidth() - 2 * Margin;
+
+        // Each kind gets its own seed so text and math pages don't share sentences
+        var random = new SeededRandom((ulong)Array.IndexOf(Kinds, kind) + 1);
+        for (int pageIndex = 0; pageIndex < pageCount; pageIndex++)
+        {
+            var canvas = new PdfCanvas(document.AddNewPage(PageSize.LETTER));
+            canvas.BeginText()
+                .SetFontAndSize(font, FontSize)
+                .SetLeading(Leading)
+                .MoveText(Margin, PageSize.LETTER.GetHeight() - Margin);
+            foreach (var paragraph in PageParagraphs(pageIndex, kind == "math", random))
+            {
+                foreach (var line in Wrap(paragraph, font, width))
+                {
+                    canvas.NewlineShowText(line);
+                }
+                canvas.NewlineText();
+            }
+            canvas.EndText();
+        }
+    }
+
+    /// <summary>
+    /// Text pages rendered to images with Windows.Data.Pdf and placed on otherwise empty pages, so
+    /// the document has no text layer at all.
+    /// </summary>
+    private static void GenerateScanned(string path, int pageCount)
+    {
+        var sourcePath = path + ".source.pdf";
+        GenerateText(sourcePath, pageCount, "scanned");
+        try
+        {
+            using var writer = new PdfWriter(path);
+            using var document = new PdfDocument(writer);
+            var source = LoadForRendering(sourcePath).GetAwaiter().GetResult();
+            for (uint pageIndex = 0; pageIndex < pageCount; pageIndex++)
+            {
+                var image = ImageDataFactory.Create(RenderPage(source, pageIndex).GetAwaiter().GetResult());
+                var canvas = new PdfCanvas(document.AddNewPage(PageSize.LETTER));
+                canvas.AddImageFittedIntoRectangle(image, PageSize.LETTER, false);
+            }
+        }
+        finally
+        {
+            File.Delete(sourcePath);
+        }
+    }
+
+    private static async Task<WinPdf.PdfDocument> LoadForRendering(string path)
+    {
+        var file = await StorageFile.GetFileFromPathAsync(Path.GetFullPath(path));
+        return await WinPdf.PdfDocument.LoadFromFileAsync(file);
+    }
+
+    private static async Task<byte[]> RenderPage(WinPdf.PdfDocument document, uint pageIndex)
+    {
+        using var page = document.GetPage(pageIndex);
+        using var stream = new InMemoryRandomAccessStream();
+        // Rendered as PNG, the default encoding
+        await page.RenderToStreamAsync(stream, new WinPdf.PdfPageRenderOptions { DestinationWidth = (uint)(page.Size.Width * ScanScale) });
+
+        using var bytes = new MemoryStream();
+        stream.Seek(0);
+        await stream.AsStreamForRead().CopyToAsync(bytes);
+        return bytes.ToArray();
+    }
+
+    private static IEnumerable<string> PageParagraphs(int pageIndex, bool withMath, SeededRandom random)
+    {
+        yield return $"Chapter {pageIndex / 20 + 1}, section {pageIndex + 1}";
+        int words = 0;
+        while (words < WordsPerPage)
+        {
+            var paragraph = new StringBuilder();
+            int sentences = random.Next(3, 7);
+            for (int i = 0; i < sentences; i++)
+            {
+                var sentence = Sentence(withMath, random);
+                words += sentence.Count(c => c == ' ') + 1;
+                paragraph.Append(i == 0 ? "" : " ").Append(sentence);
+            }
+            yield return paragraph.ToString();
+        }
+    }
+
+    private static string Sentence(bool withMath, SeededRandom random)
+    {
+        var words = Enumerable.Range(0, random.Next(8, 23)).Select(_ => Vocabulary[random.Next(0, Vocabulary.Length)]).ToList();
+        // A third of math sentences carry one to three formula fragments
+        if (withMath && random.Next(0, 3) == 0)
+        {
+            int formulas = random.Next(1, 4);
+            for (int i = 0; i < formulas; i++)
+            {
+                words.Insert(random.Next(1, words.Count), Formula(random));
+            }
+        }
+        var text = string.Join(" ", words);
+        return char.ToUpperInvariant(text[0]) + text[1..] + ".";
+    }
+
+    private static string Formula(SeededRandom random)
+    {
+        var parts = Enumerable.Range(0, random.Next(2, 5)).Select(index =>
+            index % 2 == 0 ? Operands[random.Next(0, Operands.Length)] : MathCommands[random.Next(0, MathCommands.Length)]);
+        return "$" + string.Join(" ", parts) + "$";
+    }
+
+    private static IEnumerable<string> Wrap(string paragraph, PdfFont font, float width)
+    {
+        var line = new StringBuilder();
+        foreach (var word in paragraph.Split(' '))
+        {
+            var candidate = line.Length == 0 ? word : line + " " + word;
+            if (line.Length > 0 && font.GetWidth(candidate, FontSize) > width)
+            {
+                yield return line.ToString();
+                line.Clear().Append(word);
+            }
+            else
+            {
+                line.Clear().Append(candidate);
+            }
+        }
+        if (line.Length > 0)
+        {
+            yield return line.ToString();
+        }
+    }
+
+    // The standard PDF fonts only cover Latin-1, so math is written as LaTeX commands
+    private static readonly string[] MathCommands =
+    {
+        "\\frac{a}{b}", "\\sum_{i=1}^{n}", "\\int_0^1", "\\alpha", "\\beta", "\\lambda", "\\leq", "\\geq",
+        "\\neq", "\\approx", "\\infty", "\\sqrt{x}", "\\partial", "\\cdot", "\\in", "\\rightarrow", "^2", "_k"
+    };
+
+    private static readonly string[] Operands = { "x", "y", "n", "k", "f(x)", "a_i", "2", "10" };
+
+    private static readonly string[] Vocabulary = (
+        "the of and to in is that for it as was with be by on not he this are or his from at which but " +
+        "have an they you were her she there been one all we their has would when if so no what up out " +
+        "reading voice page document chapter system model result value process method figure table " +
+        "between through during before after under within against without among toward around " +
+        "important different possible general several particular common available recent original " +
+        "measure describe consider provide develop require suggest remain include continue follow " +
+        "energy structure function pattern language history theory evidence analysis sequence").Split(' ');
+
+    /// <summary>SplitMix64, so the corpus does not depend on how <see cref="Random"/> is seeded.</summary>
+    private sealed class SeededRandom
+    {
+        private ulong state;
+
+        public SeededRandom(ulong seed)
+        {
+            state = seed;
+        }
+
+        /// <summary>A number from <paramref name="min"/> up to but not including <paramref name="max"/>.</summary>
+        public int Next(int min, int max) => min + (int)(NextUInt64() % (ulong)(max - min));
+
+        private ulong NextUInt64()
+        {
+            state += 0x9E3779B97F4A7C15;
+            ulong z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+            return z ^ (z >> 31);
+        }
+    }
+}
@@ -0,0 +1,234 @@
+using BenchmarkDotNet.Attributes;
+using BenchmarkDotNet.Configs;
+using BenchmarkDotNet.Diagnosers;
+using BenchmarkDotNet.Engines;
+using BenchmarkDotNet.Exporters.Json;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Speech.AudioFormat;
+using System.Speech.Synthesis;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Opra.Benchmarks;
+
+/// <summary>
+/// Shared setup: allocations and a full JSON report for every benchmark, plus the throughput
+/// columns that apply to it.
+/// </summary>
+public class PipelineConfig : ManualConfig
+{
+    public PipelineConfig()
+    {
+        AddDiagnoser(MemoryDiagnoser.Default);
+        AddExporter(JsonExporter.Full);
+    }
+}
+
+public class ExtractionConfig : PipelineConfig
+{
+    public ExtractionConfig()
+    {
+        AddColumn(ThroughputColumn.PagesPerSecond);
+    }
+}
+
+public class SegmentationConfig : PipelineConfig
+{
+    public SegmentationConfig()
+    {
+        AddColumn(ThroughputColumn.MegabytesPerSecond);
+    }
+}
+
+/// <summary>
+/// <see cref="PDFTextExtractor.ExtractTextAsync"/> over documents with a text layer, with the
+/// extraction cache turned off so every page is extracted every time.
+/// </summary>
+[Config(typeof(ExtractionConfig))]
+public class ExtractionBenchmarks
+{
+    private readonly PDFTextExtractor extractor = new() { Cache = null };
+    private string path = string.Empty;
+
+    [ParamsSource(nameof(Documents))]
+    public string Document { get; set; } = string.Empty;
+
+    public static IEnumerable<string> Documents => BenchmarkCorpus.Names("text", "math");
+
+    [GlobalSetup]
+    public void Setup() => path = BenchmarkCorpus.PathOf(Document);
+
+    [Benchmark]
+    public Task<PDFTextExtractor.ExtractionResult> Extract() => extractor.ExtractTextAsync(path);
+}
+
+/// <summary>
+/// Extraction of scanned documents, where every page goes through OCR. A single cold run per
+/// document, since one pass over 2000 pages already takes a long time.
+/// </summary>
+[Config(typeof(ExtractionConfig))]
+[SimpleJob(RunStrategy.ColdStart, launchCount: 1, warmupCount: 0, iterationCount: 1)]
+public class ScannedExtractionBenchmarks
+{
+    private readonly PDFTextExtractor extractor = new() { Cache = null };
+    private string path = string.Empty;
+
+    [ParamsSource(nameof(Documents))]
+    public string Document { get; set; } = string.Empty;
+
+    public static IEnumerable<string> Documents => BenchmarkCorpus.Names("scanned");
+
+    [GlobalSetup]
+    public void Setup() => path = BenchmarkCorpus.PathOf(Document);
+
+    [Benchmark]
+    public Task<PDFTextExtractor.ExtractionResult> Extract() => extractor.ExtractTextAsync(path);
+}
+
+/// <summary>
+/// The work done on extracted text before it is spoken: splitting it with
+/// <see cref="TextSegmenter"/> and building a prompt for every segment, as
+/// <c>TextToSpeech</c> does ahead of playback.
+/// </summary>
+[Config(typeof(SegmentationConfig))]
+public class SegmentationBenchmarks
+{
+    private string text = string.Empty;
+
+    [ParamsSource(nameof(Documents))]
+    public string Document { get; set; } = string.Empty;
+
+    public static IEnumerable<string> Documents => BenchmarkCorpus.Names("text", "math");
+
+    [GlobalSetup]
+    public void Setup() => text = BenchmarkCorpus.ExtractedText(Document);
+
+    [Benchmark]
+    public int Segment()
+    {
+        int count = 0;
+        foreach (var segment in TextSegmenter.Split(text))
+        {
+            count += segment.WordCount;
+        }
+        return count;
+    }
+
+    [Benchmark]
+    public int BuildPrompts()
+    {
+        int count = 0;
+        foreach (var segment in TextSegmenter.Split(text))
+        {
+            var builder = new PromptBuilder();
+            builder.AppendText(segment.Text);
+            _ = new Prompt(builder);
+            count++;
+        }
+        return count;
+    }
+}
+
+/// <summary>
+/// Time from handing the synthesizer a prompt to its first audio. A new prompt on a new
+/// synthesizer is the wait before reading starts; a prompt built ahead on a synthesizer that has
+/// just finished speaking is the gap between queued segments.
+/// </summary>
+[Config(typeof(PipelineConfig))]
+public class SpeechBenchmarks
+{
+    private static readonly SpeechAudioFormatInfo Format = new(22050, AudioBitsPerSample.Sixteen, AudioChannel.Mono);
+
+    private readonly FirstWriteStream output = new();
+    private SpeechSynthesizer synthesizer = null!;
+    private string firstSegment = string.Empty;
+    private Prompt prebuiltPrompt = null!;
+
+    [Params("text-small", "math-small")]
+    public string Document { get; set; } = string.Empty;
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        using var segments = TextSegmenter.Split(BenchmarkCorpus.ExtractedText(Document)).GetEnumerator();
+        segments.MoveNext();
+        firstSegment = segments.Current.Text;
+
+        var builder = new PromptBuilder();
+        builder.AppendText(firstSegment);
+        prebuiltPrompt = new Prompt(builder);
+
+        synthesizer = NewSynthesizer();
+        SpeakUntilFirstAudio(synthesizer, prebuiltPrompt, output); // Warms up the voice
+    }
+
+    [GlobalCleanup]
+    public void Cleanup() => synthesizer.Dispose();
+
+    [Benchmark]
+    public void FirstUtterance()
+    {
+        using var coldSynthesizer = NewSynthesizer();
+        var builder = new PromptBuilder();
+        builder.AppendText(firstSegment);
+        SpeakUntilFirstAudio(coldSynthesizer, new Prompt(builder), output);
+    }
+
+    [Benchmark]
+    public void QueuedSegmentGap() => SpeakUntilFirstAudio(synthesizer, prebuiltPrompt, output);
+
+    private SpeechSynthesizer NewSynthesizer()
+    {
+        var newSynthesizer = new SpeechSynthesizer();
+        newSynthesizer.SetOutputToAudioStream(output, Format);
+        return newSynthesizer;
+    }
+
+    /// <summary>Speaks <paramref name="prompt"/>, returns at its first audio and stops it there.</summary>
+    private static void SpeakUntilFirstAudio(SpeechSynthesizer synthesizer, Prompt prompt, FirstWriteStream output)
+    {
+        using var completed = new ManualResetEventSlim();
+        void OnCompleted(object? sender, SpeakCompletedEventArgs e) => completed.Set();
+        synthesizer.SpeakCompleted += OnCompleted;
+        try
+        {
+            output.Reset();
+            synthesizer.SpeakAsync(prompt);
+            output.FirstWrite.Wait();
+            synthesizer.SpeakAsyncCancelAll();
+            completed.Wait();
+        }
+        finally
+        {
+            synthesizer.SpeakCompleted -= OnCompleted;
+        }
+    }
+
+    /// <summary>Discards the audio and signals when the first of it arrives.</summary>
+    private sealed class FirstWriteStream : Stream
+    {
+        public ManualResetEventSlim FirstWrite { get; } = new();
+
+        public void Reset() => FirstWrite.Reset();
+
+        public override void Write(byte[] buffer, int offset, int count)
+        {
+            if (count > 0)
+            {
+                FirstWrite.Set();
+            }
+        }
+
+        public override bool CanRead => false;
+        public override bool CanSeek => false;
+        public override bool CanWrite => true;
+        public override long Length => 0;
+        public override long Position { get => 0; set { } }
+        public override void Flush() { }
+        public override int Read(byte[] buffer, int offset, int count) => throw new NotSupportedException();
+        public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+        public override void SetLength(long value) => throw new NotSupportedException();
+    }
+}
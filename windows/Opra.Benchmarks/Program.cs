@@ -0,0 +1,83 @@
+using BenchmarkDotNet.Running;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text.Json;
+
+namespace Opra.Benchmarks;
+
+/// <summary>
+/// Benchmarks for each stage of the reading pipeline, run with BenchmarkDotNet:
+/// <c>dotnet run -c Release -- --filter *</c>. Every run writes a full JSON report per class to
+/// BenchmarkDotNet.Artifacts/results; <c>compare &lt;baseline-dir&gt; &lt;results-dir&gt;</c>
+/// prints the change in median time between two such runs, e.g. before and after a commit.
+/// </summary>
+public static class Program
+{
+    private const double DefaultThreshold = 5.0;
+
+    public static int Main(string[] args)
+    {
+        if (args.Length > 0 && args[0] == "compare")
+        {
+            return Compare(args.Skip(1).ToArray());
+        }
+
+        BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args);
+        return 0;
+    }
+
+    /// <summary>
+    /// Compares the medians in two results directories and returns 1 if any benchmark got slower by
+    /// more than the threshold percentage.
+    /// </summary>
+    private static int Compare(string[] args)
+    {
+        double threshold = DefaultThreshold;
+        if (args.Length == 4 && args[2] == "--threshold" && double.TryParse(args[3], out var value) && value >= 0)
+        {
+            threshold = value;
+        }
+        else if (args.Length != 2)
+        {
+            Console.Error.WriteLine($"Usage: Opra.Benchmarks compare <baseline-dir> <results-dir> [--threshold <pct>] (default: {DefaultThreshold})");
+            return 2;
+        }
+
+        var baseline = ReadMedians(args[0]);
+        var current = ReadMedians(args[1]);
+        int regressions = 0;
+        foreach (var (name, median) in current.OrderBy(entry => entry.Key, StringComparer.Ordinal))
+        {
+            if (!baseline.TryGetValue(name, out var previous) || previous <= 0)
+            {
+                continue;
+            }
+            double change = (median - previous) / previous * 100;
+            bool isRegression = change > threshold;
+            regressions += isRegression ? 1 : 0;
+            Console.WriteLine($"{name}: {previous / 1e6:F3} → {median / 1e6:F3} ms ({change:+0.0;-0.0}%){(isRegression ? "  REGRESSED" : "")}");
+        }
+        Console.WriteLine(regressions == 0 ? $"No regressions past {threshold}%" : $"{regressions} regression(s) past {threshold}%");
+        return regressions == 0 ? 0 : 1;
+    }
+
+    /// <summary>Median nanoseconds of every benchmark in the *-report-full.json files of a directory.</summary>
+    private static Dictionary<string, double> ReadMedians(string directory)
+    {
+        var medians = new Dictionary<string, double>();
+        foreach (var file in Directory.EnumerateFiles(directory, "*-report-full.json"))
+        {
+            using var report = JsonDocument.Parse(File.ReadAllText(file));
+            foreach (var benchmark in report.RootElement.GetProperty("Benchmarks").EnumerateArray())
+            {
+                if (benchmark.TryGetProperty("Statistics", out var statistics) && statistics.ValueKind == JsonValueKind.Object)
+                {
+                    medians[benchmark.GetProperty("FullName").GetString()!] = statistics.GetProperty("Median").GetDouble();
+                }
+            }
+        }
+        return medians;
+    }
+}
@@ -0,0 +1,54 @@
+using BenchmarkDotNet.Columns;
+using BenchmarkDotNet.Reports;
+using BenchmarkDotNet.Running;
+using System;
+
+namespace Opra.Benchmarks;
+
+/// <summary>
+/// A summary column that turns a benchmark's mean time into throughput over its
+/// <c>Document</c> parameter: pages per second for extraction, megabytes of extracted text per
+/// second for the text stages.
+/// </summary>
+public class ThroughputColumn : IColumn
+{
+    public static readonly IColumn PagesPerSecond = new ThroughputColumn("Pages/s",
+        document => BenchmarkCorpus.PageCount(document));
+
+    public static readonly IColumn MegabytesPerSecond = new ThroughputColumn("MB/s",
+        document => BenchmarkCorpus.ExtractedTextBytes(document) / (1024.0 * 1024.0));
+
+    private readonly Func<string, double?> unitsPerDocument;
+
+    private ThroughputColumn(string name, Func<string, double?> unitsPerDocument)
+    {
+        ColumnName = name;
+        this.unitsPerDocument = unitsPerDocument;
+    }
+
+    public string Id => nameof(ThroughputColumn) + "." + ColumnName;
+    public string ColumnName { get; }
+    public bool AlwaysShow => true;
+    public ColumnCategory Category => ColumnCategory.Custom;
+    public int PriorityInCategory => 0;
+    public bool IsNumeric => true;
+    public UnitType UnitType => UnitType.Dimensionless;
+    public string Legend => $"{ColumnName} at the mean time";
+
+    public bool IsAvailable(Summary summary) => true;
+    public bool IsDefault(Summary summary, BenchmarkCase benchmarkCase) => false;
+
+    public string GetValue(Summary summary, BenchmarkCase benchmarkCase) =>
+        GetValue(summary, benchmarkCase, SummaryStyle.Default);
+
+    public string GetValue(Summary summary, BenchmarkCase benchmarkCase, SummaryStyle style)
+    {
+        var meanNanoseconds = summary[benchmarkCase]?.ResultStatistics?.Mean;
+        if (benchmarkCase.Parameters["Document"] is not string document || meanNanoseconds is not > 0)
+        {
+            return "-";
+        }
+        var units = unitsPerDocument(document);
+        return units == null ? "-" : (units.Value / (meanNanoseconds.Value / 1e9)).ToString("F2");
+    }
+}
@@ -0,0 +1,299 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Speech.Synthesis;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Opra.Cli;
+
+/// <summary>
+/// Headless bulk converter: runs the app's extraction and speech pipeline over many PDFs and
+/// writes <c>&lt;name&gt;.m4a</c> plus its <c>&lt;name&gt;.chapters.txt</c> timing sidecar for each.
+///
+/// Documents are converted <c>--jobs</c> at a time, each with its own synthesizer. Every document
+/// and the whole run report pages per second and seconds of audio per wall-clock second.
+/// </summary>
+public static class Program
+{
+    private static readonly int DefaultJobs = Math.Max(1, Environment.ProcessorCount / 2);
+
+    private static readonly string Usage = $@"Usage: opra-cli [options] <file.pdf | folder>...
+
+Options:
+  -o, --output <dir>   Write audio to <dir> instead of next to each PDF; PDFs
+                       found in subfolders keep their subfolder under <dir>
+  -j, --jobs <n>       Documents to convert at once (default: {DefaultJobs})
+  --voice <name>       Installed voice to speak with (default: system voice)
+  --rate <rate>        Speech rate from -10 to 10 (default: 0)
+  --layout             Read columns in order and skip running headers, footers and page numbers
+  --list-voices        Print the installed voice names and exit
+  -h, --help           Show this help";
+
+    private class Options
+    {
+        public List<string> Inputs { get; } = new();
+        public string? OutputDirectory { get; set; }
+        public int Jobs { get; set; } = DefaultJobs;
+        public string? VoiceName { get; set; }
+        public int Rate { get; set; }
+        public ExtractionMode Mode { get; set; } = ExtractionMode.Plain;
+        public bool ListVoices { get; set; }
+        public bool ShowHelp { get; set; }
+    }
+
+    /// <summary>A PDF to convert, with the subfolder it was found in below a folder named on the command line.</summary>
+    private record Document(string Path, string Subfolder = "");
+
+    private record Throughput(int Pages, TimeSpan AudioDuration, TimeSpan WallTime)
+    {
+        public string Summary
+        {
+            get
+            {
+                var seconds = Math.Max(WallTime.TotalSeconds, 0.001);
+                return $"{Pages} pages, {AudioDuration.TotalSeconds:F1} s audio in {WallTime.TotalSeconds:F1} s " +
+                       $"({Pages / seconds:F2} pages/s, {AudioDuration.TotalSeconds / seconds:F2} audio-s/s)";
+            }
+        }
+    }
+
+    public static async Task<int> Main(string[] args)
+    {
+        Options options;
+        try
+        {
+            options = ParseOptions(args);
+        }
+        catch (ArgumentException ex)
+        {
+            Console.Error.WriteLine($"{ex.Message}\n\n{Usage}");
+            return 2;
+        }
+
+        if (options.ShowHelp)
+        {
+            Console.WriteLine(Usage);
+            return 0;
+        }
+        if (options.ListVoices || options.VoiceName != null)
+        {
+            using var synthesizer = new SpeechSynthesizer();
+            var voices = synthesizer.GetInstalledVoices().Where(v => v.Enabled).Select(v => v.VoiceInfo).ToList();
+            if (options.ListVoices)
+            {
+                foreach (var voice in voices)
+                {
+                    Console.WriteLine($"{voice.Name}\t{voice.Culture.Name}");
+                }
+                return 0;
+            }
+            if (!voices.Any(v => v.Name == options.VoiceName))
+            {
+                Console.Error.WriteLine($"Unknown voice {options.VoiceName}; see --list-voices");
+                return 2;
+            }
+        }
+
+        var documents = CollectDocuments(options.Inputs);
+        if (documents.Count == 0)
+        {
+            Console.Error.WriteLine("No PDF files found");
+            return 1;
+        }
+
+        // Two outputs with one name would overwrite each other, at the same time with --jobs
+        var outputPaths = documents.Select(document => OutputPath(document, options.OutputDirectory)).ToList();
+        var sources = new Dictionary<string, string>(StringComparer.OrdinalIgnoreCase);
+        for (int i = 0; i < documents.Count; i++)
+        {
+            if (sources.TryGetValue(outputPaths[i], out var other))
+            {
+                Console.Error.WriteLine($"{other} and {documents[i].Path} would both be written to {outputPaths[i]}");
+                return 2;
+            }
+            sources[outputPaths[i]] = documents[i].Path;
+        }
+        foreach (var directory in outputPaths.Select(Path.GetDirectoryName).Distinct(StringComparer.OrdinalIgnoreCase))
+        {
+            Directory.CreateDirectory(directory!);
+        }
+
+        using var cancellation = new CancellationTokenSource();
+        Console.CancelKeyPress += (_, e) =>
+        {
+            e.Cancel = true; // Let running exports clean up their partial files
+            cancellation.Cancel();
+        };
+
+        Console.WriteLine($"Converting {documents.Count} document(s) with {options.Jobs} worker(s)");
+        var stopwatch = Stopwatch.StartNew();
+
+        // Keep Jobs conversions running; a new document starts whenever one finishes
+        using var workers = new SemaphoreSlim(options.Jobs);
+        var conversions = documents.Select(async (document, i) =>
+        {
+            await workers.WaitAsync(cancellation.Token);
+            try
+            {
+                return await ConvertAsync(document.Path, outputPaths[i], options, cancellation.Token);
+            }
+            finally
+            {
+                workers.Release();
+            }
+        }).ToList();
+
+        Throughput?[] results;
+        try
+        {
+            results = await Task.WhenAll(conversions);
+        }
+        catch (OperationCanceledException)
+        {
+            Console.Error.WriteLine("Cancelled");
+            return 1;
+        }
+
+        var converted = results.Where(r => r != null).Select(r => r!).ToList();
+        var failures = results.Length - converted.Count;
+        var totals = new Throughput(converted.Sum(r => r.Pages),
+            TimeSpan.FromTicks(converted.Sum(r => r.AudioDuration.Ticks)), stopwatch.Elapsed);
+        Console.WriteLine($"Done: {converted.Count} converted, {failures} failed. {totals.Summary}");
+        return failures == 0 ? 0 : 1;
+    }
+
+    /// <summary>
+    /// Converts one document and prints its throughput. Returns null if it failed.
+    /// </summary>
+    private static async Task<Throughput?> ConvertAsync(string document, string outputPath, Options options, CancellationToken cancellationToken)
+    {
+        var stopwatch = Stopwatch.StartNew();
+        var name = Path.GetFileName(document);
+        try
+        {
+            var exporter = new AudioExporter
+            {
+                VoiceName = options.VoiceName,
+                Rate = options.Rate
+            };
+            // Pages are read lazily on the export thread, so extraction overlaps speech
+            var extractor = new PDFTextExtractor { Mode = options.Mode };
+            var result = await exporter.ExportAsync(extractor.EnumeratePages(document), 0, outputPath,
+                cancellationToken: cancellationToken);
+
+            var throughput = new Throughput(result.PageCount, result.Duration, stopwatch.Elapsed);
+            Console.WriteLine($"{name}: {result.PageCount} pages → {Path.GetFileName(outputPath)}. {throughput.Summary}");
+            return throughput;
+        }
+        catch (OperationCanceledException)
+        {
+            throw;
+        }
+        catch (Exception ex)
+        {
+            Console.Error.WriteLine($"{name}: export failed: {ex.Message}");
+            return null;
+        }
+    }
+
+    private static Options ParseOptions(string[] args)
+    {
+        var options = new Options();
+        for (int i = 0; i < args.Length; i++)
+        {
+            var argument = args[i];
+            string Value() => i + 1 < args.Length ? args[++i] : throw new ArgumentException($"Missing value for {argument}");
+
+            switch (argument)
+            {
+                case "-o":
+                case "--output":
+                    options.OutputDirectory = Value();
+                    break;
+                case "-j":
+                case "--jobs":
+                    var jobs = Value();
+                    options.Jobs = int.TryParse(jobs, out var jobCount) && jobCount > 0
+                        ? jobCount
+                        : throw new ArgumentException($"Invalid value {jobs} for {argument}");
+                    break;
+                case "--voice":
+                    options.VoiceName = Value();
+                    break;
+                case "--rate":
+                    var rate = Value();
+                    options.Rate = int.TryParse(rate, out var rateValue)
+                        ? Math.Clamp(rateValue, -10, 10)
+                        : throw new ArgumentException($"Invalid value {rate} for {argument}");
+                    break;
+                case "--layout":
+                    options.Mode = ExtractionMode.Layout;
+                    break;
+                case "--list-voices":
+                    options.ListVoices = true;
+                    break;
+                case "-h":
+                case "--help":
+                    options.ShowHelp = true;
+                    break;
+                default:
+                    if (argument.StartsWith("-"))
+                    {
+                        throw new ArgumentException($"Unknown option {argument}");
+                    }
+                    options.Inputs.Add(argument);
+                    break;
+            }
+        }
+
+        if (options.Inputs.Count == 0 && !options.ListVoices && !options.ShowHelp)
+        {
+            throw new ArgumentException("No PDF files or folders given");
+        }
+        return options;
+    }
+
+    /// <summary>
+    /// PDFs named on the command line, plus every PDF found (recursively) in the folders named.
+    /// A PDF named more than once is converted once.
+    /// </summary>
+    private static List<Document> CollectDocuments(IEnumerable<string> inputs)
+    {
+        var documents = new Dictionary<string, Document>(StringComparer.OrdinalIgnoreCase);
+        foreach (var input in inputs)
+        {
+            if (Directory.Exists(input))
+            {
+                foreach (var file in Directory.EnumerateFiles(input, "*.pdf", new EnumerationOptions
+                {
+                    RecurseSubdirectories = true,
+                    MatchCasing = MatchCasing.CaseInsensitive
+                }))
+                {
+                    var subfolder = Path.GetRelativePath(input, Path.GetDirectoryName(file)!);
+                    documents.TryAdd(Path.GetFullPath(file), new Document(file, subfolder == "." ? "" : subfolder));
+                }
+            }
+            else if (File.Exists(input))
+            {
+                documents.TryAdd(Path.GetFullPath(input), new Document(input));
+            }
+            else
+            {
+                Console.Error.WriteLine($"Skipping {input}: no such file or folder");
+            }
+        }
+        return documents.Values.OrderBy(document => document.Path, StringComparer.OrdinalIgnoreCase).ToList();
+    }
+
+    private static string OutputPath(Document document, string? outputDirectory)
+    {
+        var directory = outputDirectory != null
+            ? Path.Combine(outputDirectory, document.Subfolder)
+            : Path.GetDirectoryName(Path.GetFullPath(document.Path)) ?? ".";
+        return Path.GetFullPath(Path.Combine(directory, Path.GetFileNameWithoutExtension(document.Path) + ".m4a"));
+    }
+}
@@ -0,0 +1,184 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Speech.AudioFormat;
+using System.Speech.Synthesis;
+using System.Threading;
+using System.Threading.Tasks;
+using Windows.Media.MediaProperties;
+using Windows.Media.Transcoding;
+using Windows.Storage;
+
+namespace Opra;
+
+/// <summary>
+/// Renders a whole document to an AAC audiobook file without playing it.
+///
+/// Pages are synthesized one after another straight into a PCM file on disk, which runs as fast as
+/// the voice can render rather than in real time, so the audio is never held in memory. The file is
+/// then encoded to M4A with Media Foundation. Page starts are written next to the audio as
+/// <c>&lt;name&gt;.chapters.txt</c> (<c>HH:MM:SS.mmm Page N</c> per line), the same chapter list
+/// the macOS app writes.
+/// </summary>
+public class AudioExporter
+{
+    // 16-bit mono at 22.05 kHz, what the built-in voices render natively
+    private const int SampleRate = 22050;
+    private const int BytesPerSample = 2;
+    private const int WavHeaderSize = 44;
+
+    // Share of the progress bar taken by synthesis; encoding takes the rest
+    private const double RenderProgressShare = 0.9;
+
+    /// <summary>
+    /// What was written: the pages that had text to speak and the length of the audio.
+    /// </summary>
+    public record ExportResult(int PageCount, TimeSpan Duration);
+
+    public string? VoiceName { get; set; }
+    public int Rate { get; set; }
+    public int Volume { get; set; } = 100;
+
+    public async Task<ExportResult> ExportAsync(IEnumerable<(int PageNumber, string Text)> pages, int pageCount, string outputPath,
+        IProgress<double>? progress = null, CancellationToken cancellationToken = default)
+    {
+        var wavPath = Path.Combine(Path.GetTempPath(), $"opra-export-{Guid.NewGuid():N}.wav");
+        try
+        {
+            var (chapters, duration) = await Task.Run(() => RenderAsync(pages, pageCount, wavPath, progress, cancellationToken), cancellationToken);
+            cancellationToken.ThrowIfCancellationRequested();
+
+            await EncodeAsync(wavPath, outputPath, progress, cancellationToken);
+            WriteChapters(chapters, Path.ChangeExtension(outputPath, ".chapters.txt"));
+            progress?.Report(1.0);
+            return new ExportResult(chapters.Count, duration);
+        }
+        finally
+        {
+            File.Delete(wavPath);
+        }
+    }
+
+    private async Task<(List<(TimeSpan Start, string Title)> Chapters, TimeSpan Duration)> RenderAsync(IEnumerable<(int PageNumber, string Text)> pages, int pageCount,
+        string wavPath, IProgress<double>? progress, CancellationToken cancellationToken)
+    {
+        var chapters = new List<(TimeSpan Start, string Title)>();
+
+        using var output = new FileStream(wavPath, FileMode.Create, FileAccess.Write, FileShare.None);
+        output.Write(new byte[WavHeaderSize]); // Filled in once the data length is known
+
+        using var synthesizer = new SpeechSynthesizer();
+        if (!string.IsNullOrEmpty(VoiceName))
+        {
+            synthesizer.SelectVoice(VoiceName);
+        }
+        synthesizer.Rate = Rate;
+        synthesizer.Volume = Volume;
+        synthesizer.SetOutputToAudioStream(output, new SpeechAudioFormatInfo(SampleRate, AudioBitsPerSample.Sixteen, AudioChannel.Mono));
+
+        foreach (var (pageNumber, text) in pages)
+        {
+            cancellationToken.ThrowIfCancellationRequested();
+            if (string.IsNullOrWhiteSpace(text))
+            {
+                continue;
+            }
+
+            chapters.Add((DurationOf(output.Position - WavHeaderSize), $"Page {pageNumber}"));
+            PipelineEventSource.Log.ExportPageStart(pageNumber);
+            await SpeakPageAsync(synthesizer, text, cancellationToken);
+            PipelineEventSource.Log.ExportPageStop(pageNumber);
+
+            if (pageCount > 0)
+            {
+                progress?.Report(RenderProgressShare * Math.Min(1.0, (double)pageNumber / pageCount));
+            }
+        }
+
+        synthesizer.SetOutputToNull();
+        var dataLength = output.Length - WavHeaderSize;
+        output.Position = 0;
+        WriteWavHeader(output, dataLength);
+        return (chapters, DurationOf(dataLength));
+    }
+
+    private static TimeSpan DurationOf(long pcmBytes) => TimeSpan.FromSeconds((double)pcmBytes / (SampleRate * BytesPerSample));
+
+    private static async Task SpeakPageAsync(SpeechSynthesizer synthesizer, string text, CancellationToken cancellationToken)
+    {
+        var completion = new TaskCompletionSource(TaskCreationOptions.RunContinuationsAsynchronously);
+        void OnCompleted(object? sender, SpeakCompletedEventArgs e)
+        {
+            if (e.Cancelled)
+            {
+                completion.TrySetCanceled(cancellationToken);
+            }
+            else if (e.Error != null)
+            {
+                completion.TrySetException(e.Error);
+            }
+            else
+            {
+                completion.TrySetResult();
+            }
+        }
+
+        synthesizer.SpeakCompleted += OnCompleted;
+        try
+        {
+            using (cancellationToken.Register(() => synthesizer.SpeakAsyncCancelAll()))
+            {
+                synthesizer.SpeakAsync(text);
+                await completion.Task;
+            }
+        }
+        finally
+        {
+            synthesizer.SpeakCompleted -= OnCompleted;
+        }
+    }
+
+    private static async Task EncodeAsync(string wavPath, string outputPath, IProgress<double>? progress, CancellationToken cancellationToken)
+    {
+        var fullPath = Path.GetFullPath(outputPath);
+        var source = await StorageFile.GetFileFromPathAsync(wavPath);
+        var folder = await StorageFolder.GetFolderFromPathAsync(Path.GetDirectoryName(fullPath));
+        var destination = await folder.CreateFileAsync(Path.GetFileName(fullPath), CreationCollisionOption.ReplaceExisting);
+
+        var transcoder = new MediaTranscoder();
+        var prepared = await transcoder.PrepareFileTranscodeAsync(source, destination, MediaEncodingProfile.CreateM4a(AudioEncodingQuality.Medium));
+        if (!prepared.CanTranscode)
+        {
+            throw new InvalidOperationException($"Cannot encode audio: {prepared.FailureReason}");
+        }
+
+        var operation = prepared.TranscodeAsync();
+        operation.Progress = (_, percent) => progress?.Report(RenderProgressShare + (1 - RenderProgressShare) * percent / 100.0);
+        await operation.AsTask(cancellationToken);
+    }
+
+    private static void WriteWavHeader(Stream stream, long dataLength)
+    {
+        using var writer = new BinaryWriter(stream, System.Text.Encoding.ASCII, leaveOpen: true);
+        writer.Write("RIFF".ToCharArray());
+        writer.Write((uint)(36 + dataLength));
+        writer.Write("WAVE".ToCharArray());
+        writer.Write("fmt ".ToCharArray());
+        writer.Write(16u); // PCM format chunk size
+        writer.Write((ushort)1); // PCM
+        writer.Write((ushort)1); // Mono
+        writer.Write((uint)SampleRate);
+        writer.Write((uint)(SampleRate * BytesPerSample));
+        writer.Write((ushort)BytesPerSample);
+        writer.Write((ushort)(BytesPerSample * 8));
+        writer.Write("data".ToCharArray());
+        writer.Write((uint)dataLength);
+    }
+
+    private static void WriteChapters(List<(TimeSpan Start, string Title)> chapters, string path)
+    {
+        File.WriteAllLines(path, chapters.Select(c =>
+            $"{(int)c.Start.TotalHours:00}:{c.Start.Minutes:00}:{c.Start.Seconds:00}.{c.Start.Milliseconds:000} {c.Title}"));
+    }
+}
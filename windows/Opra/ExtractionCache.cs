@@ -0,0 +1,354 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Linq;
+using System.Security.Cryptography;
+using System.Text;
+using System.Text.Json;
+
+namespace Opra;
+
+/// <summary>
+/// Persistent per-page text cache for extracted PDFs, shared in format with the macOS app
+/// (macos/Opra/ExtractionCache.swift).
+///
+/// Each document gets one <c>&lt;sha256&gt;.opracache</c> file per extraction mode, with <c>-layout</c>
+/// after the hash for <see cref="ExtractionMode.Layout"/>, little-endian throughout:
+/// <code>
+/// header  64 bytes          "OPRX", version:u32, pageCount:u32, reserved:u32,
+///                           fileSize:u64, modificationTime:f64, sha256:[32]
+/// pages   16 x pageCount    offset:u64, length:u32, state:u32
+/// text    UTF-8 page text referenced by the page table (offsets are from the start of the file)
+/// </code>
+/// </summary>
+public class ExtractionCache
+{
+    public enum PageState : uint
+    {
+        Missing = 0,     // never extracted
+        Text = 1,        // PDF text layer
+        Empty = 2,       // page has no text layer, not run through OCR yet
+        Recognized = 3,  // no text layer, text recognized with OCR
+        Unrecognized = 4 // no text layer and OCR found no text
+    }
+
+    public static bool HasText(PageState state) => state == PageState.Text || state == PageState.Recognized;
+
+    public record DocumentKey(string ContentHash, ulong FileSize, double ModificationTime);
+
+    private static readonly byte[] Magic = Encoding.ASCII.GetBytes("OPRX");
+    private const uint FormatVersion = 1;
+    private const int HeaderSize = 64;
+    private const int PageEntrySize = 16;
+
+    private readonly string directory;
+    private readonly string indexPath;
+    private readonly Dictionary<string, DocumentKey> index = new();
+    private readonly object indexLock = new();
+
+    // Open caches by file, so a load and an export of the same document store into one
+    // instance; two would both write the file, and the last save would drop the other's pages
+    private readonly Dictionary<string, WeakReference<DocumentTextCache>> openCaches = new();
+    private readonly object openCachesLock = new();
+
+    public static ExtractionCache Shared { get; } = new();
+
+    public ExtractionCache(string? directory = null)
+    {
+        this.directory = directory ?? Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData), "Opra", "ExtractionCache");
+        indexPath = Path.Combine(this.directory, "index.json");
+
+        try
+        {
+            Directory.CreateDirectory(this.directory);
+            if (File.Exists(indexPath))
+            {
+                var saved = JsonSerializer.Deserialize<Dictionary<string, DocumentKey>>(File.ReadAllText(indexPath));
+                if (saved != null)
+                {
+                    index = saved;
+                }
+            }
+        }
+        catch
+        {
+            // An unreadable index only costs a re-hash
+        }
+    }
+
+    /// <summary>
+    /// Returns the cache key for a file. The file is only re-hashed when its size or
+    /// modification time no longer match what was recorded the last time it was opened.
+    /// </summary>
+    public DocumentKey? GetKey(string filePath)
+    {
+        try
+        {
+            var info = new FileInfo(filePath);
+            var fileSize = (ulong)info.Length;
+            var modificationTime = (info.LastWriteTimeUtc - DateTime.UnixEpoch).TotalSeconds;
+
+            lock (indexLock)
+            {
+                if (index.TryGetValue(filePath, out var known)
+                    && known.FileSize == fileSize
+                    && known.ModificationTime == modificationTime)
+                {
+                    return known;
+                }
+            }
+
+            string contentHash;
+            using (var stream = File.OpenRead(filePath))
+            {
+                contentHash = Convert.ToHexString(SHA256.HashData(stream)).ToLowerInvariant();
+            }
+
+            var key = new DocumentKey(contentHash, fileSize, modificationTime);
+            string json;
+            lock (indexLock)
+            {
+                index[filePath] = key;
+                json = JsonSerializer.Serialize(index);
+            }
+            File.WriteAllText(indexPath, json);
+            return key;
+        }
+        catch
+        {
+            return null;
+        }
+    }
+
+    /// <summary>
+    /// Opens the cached pages for a document, or an empty cache if none exists yet. Callers that
+    /// open the same document while it is still in use share the same instance.
+    /// </summary>
+    public DocumentTextCache Open(DocumentKey key, int pageCount, ExtractionMode mode = ExtractionMode.Plain)
+    {
+        var name = mode == ExtractionMode.Plain ? key.ContentHash : $"{key.ContentHash}-{mode.ToString().ToLowerInvariant()}";
+        var filePath = Path.Combine(directory, $"{name}.opracache");
+        lock (openCachesLock)
+        {
+            if (openCaches.TryGetValue(filePath, out var reference)
+                && reference.TryGetTarget(out var open)
+                && open.PageCount == pageCount)
+            {
+                return open;
+            }
+
+            foreach (var stale in openCaches.Where(entry => !entry.Value.TryGetTarget(out _)).ToList())
+            {
+                openCaches.Remove(stale.Key);
+            }
+
+            var cache = new DocumentTextCache(key, pageCount, filePath);
+            openCaches[filePath] = new WeakReference<DocumentTextCache>(cache);
+            return cache;
+        }
+    }
+
+    /// <summary>Cached page text for one document. Safe to use from parallel extraction.</summary>
+    public class DocumentTextCache
+    {
+        private readonly DocumentKey key;
+        private readonly string filePath;
+        private readonly PageState[] states;
+        private readonly string?[] texts;
+        private readonly bool[] pending;
+        private readonly object cacheLock = new();
+
+        public int PageCount { get; }
+
+        internal DocumentTextCache(DocumentKey key, int pageCount, string filePath)
+        {
+            this.key = key;
+            this.filePath = filePath;
+            PageCount = pageCount;
+            states = new PageState[pageCount];
+            texts = new string?[pageCount];
+            pending = new bool[pageCount];
+            Load();
+        }
+
+        /// <summary>
+        /// Returns true if the page was extracted before; <paramref name="text"/> is null for pages
+        /// without a text layer. Pages are 1-based, matching iText.
+        /// </summary>
+        public bool TryGetPage(int pageNumber, out string? text)
+        {
+            text = null;
+            int index = pageNumber - 1;
+            if (index < 0 || index >= PageCount)
+            {
+                return false;
+            }
+            lock (cacheLock)
+            {
+                if (states[index] == PageState.Missing)
+                {
+                    return false;
+                }
+                text = texts[index];
+                return true;
+            }
+        }
+
+        /// <summary>How the page's text was obtained, <see cref="PageState.Missing"/> if it never was.</summary>
+        public PageState GetState(int pageNumber)
+        {
+            int index = pageNumber - 1;
+            if (index < 0 || index >= PageCount)
+            {
+                return PageState.Missing;
+            }
+            lock (cacheLock)
+            {
+                return states[index];
+            }
+        }
+
+        /// <summary>
+        /// Records a freshly extracted page. A null text marks the page as having no text layer,
+        /// unless <paramref name="state"/> already says why there is none.
+        /// </summary>
+        public void Store(int pageNumber, string? text, PageState state = PageState.Text)
+        {
+            int index = pageNumber - 1;
+            if (index < 0 || index >= PageCount)
+            {
+                return;
+            }
+            lock (cacheLock)
+            {
+                states[index] = text == null && HasText(state) ? PageState.Empty : state;
+                texts[index] = text;
+                pending[index] = true;
+            }
+        }
+
+        /// <summary>
+        /// Writes the cache file if any pages were added since it was loaded. A failed write is
+        /// traced and otherwise ignored, so it never fails the extraction that saves.
+        /// </summary>
+        public void Save()
+        {
+            lock (cacheLock)
+            {
+                if (Array.IndexOf(pending, true) < 0)
+                {
+                    return;
+                }
+
+                var encoded = new byte[PageCount][];
+                for (int i = 0; i < PageCount; i++)
+                {
+                    encoded[i] = texts[i] == null ? Array.Empty<byte>() : Encoding.UTF8.GetBytes(texts[i]!);
+                }
+
+                var tempPath = filePath + ".tmp";
+                try
+                {
+                    using (var stream = new FileStream(tempPath, FileMode.Create, FileAccess.Write))
+                    using (var writer = new BinaryWriter(stream))
+                    {
+                        writer.Write(Magic);
+                        writer.Write(FormatVersion);
+                        writer.Write((uint)PageCount);
+                        writer.Write(0u);
+                        writer.Write(key.FileSize);
+                        writer.Write(key.ModificationTime);
+                        writer.Write(Convert.FromHexString(key.ContentHash));
+
+                        ulong offset = (ulong)(HeaderSize + PageCount * PageEntrySize);
+                        for (int i = 0; i < PageCount; i++)
+                        {
+                            writer.Write(offset);
+                            writer.Write((uint)encoded[i].Length);
+                            writer.Write((uint)states[i]);
+                            offset += (ulong)encoded[i].Length;
+                        }
+                        foreach (var bytes in encoded)
+                        {
+                            writer.Write(bytes);
+                        }
+                    }
+                    File.Move(tempPath, filePath, overwrite: true);
+                    Array.Clear(pending);
+                }
+                catch (Exception error) when (error is IOException or UnauthorizedAccessException)
+                {
+                    // The cache is best-effort: the pages stay pending for the next save
+                    PipelineEventSource.Log.CacheSaveFailed(error.Message);
+                    try
+                    {
+                        File.Delete(tempPath);
+                    }
+                    catch
+                    {
+                        // Overwritten by the next save
+                    }
+                }
+            }
+        }
+
+        private void Load()
+        {
+            if (!File.Exists(filePath))
+            {
+                return;
+            }
+
+            try
+            {
+                using var file = MemoryMappedFile.CreateFromFile(filePath, FileMode.Open, null, 0, MemoryMappedFileAccess.Read);
+                using var view = file.CreateViewAccessor(0, 0, MemoryMappedFileAccess.Read);
+                long length = new FileInfo(filePath).Length;
+                if (length < HeaderSize + (long)PageCount * PageEntrySize)
+                {
+                    return;
+                }
+
+                var header = new byte[HeaderSize];
+                view.ReadArray(0, header, 0, HeaderSize);
+                if (!header.AsSpan(0, 4).SequenceEqual(Magic)
+                    || BitConverter.ToUInt32(header, 4) != FormatVersion
+                    || BitConverter.ToUInt32(header, 8) != (uint)PageCount
+                    || !header.AsSpan(32, 32).SequenceEqual(Convert.FromHexString(key.ContentHash)))
+                {
+                    return;
+                }
+
+                for (int i = 0; i < PageCount; i++)
+                {
+                    long entry = HeaderSize + (long)i * PageEntrySize;
+                    long offset = (long)view.ReadUInt64(entry);
+                    int byteCount = (int)view.ReadUInt32(entry + 8);
+                    var state = (PageState)view.ReadUInt32(entry + 12);
+                    if (offset + byteCount > length)
+                    {
+                        // Treat a damaged table as an empty cache
+                        Array.Clear(states);
+                        Array.Clear(texts);
+                        return;
+                    }
+
+                    states[i] = state;
+                    if (HasText(state))
+                    {
+                        var bytes = new byte[byteCount];
+                        view.ReadArray(offset, bytes, 0, byteCount);
+                        texts[i] = Encoding.UTF8.GetString(bytes);
+                    }
+                }
+            }
+            catch
+            {
+                Array.Clear(states);
+                Array.Clear(texts);
+            }
+        }
+    }
+}
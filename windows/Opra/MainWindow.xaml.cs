@@ -5,7 +5,9 @@ using System;
 using System.Collections.Generic;
 using System.Collections.ObjectModel;
 using System.ComponentModel;
+using System.Diagnostics;
 using System.Runtime.CompilerServices;
+using System.Threading;
 using System.Threading.Tasks;
 using Windows.Storage.Pickers;
 using Windows.Storage;
@@ -23,6 +25,10 @@ public sealed partial class MainWindow : Window, INotifyPropertyChanged
     private int endPage = 1;
     private string extractedText = string.Empty;
     private bool hasPDF = false;
+    private CancellationTokenSource? loadCancellation;
+    private double loadProgress = 0;
+    private CancellationTokenSource? exportCancellation;
+    private double exportProgress = 0;
 
     public MainWindow()
     {
@@ -34,6 +40,7 @@ public sealed partial class MainWindow : Window, INotifyPropertyChanged
         textToSpeech.SpeechFinished += OnSpeechFinished;
         textToSpeech.SpeechPaused += OnSpeechPaused;
         textToSpeech.SpeechResumed += OnSpeechResumed;
+        textToSpeech.ProgressChanged += OnSpeechProgressChanged;
         
         // Initialize available voices
         AvailableVoices = new ObservableCollection<TextToSpeech.Voice>(textToSpeech.GetAvailableVoices());
@@ -70,6 +77,22 @@ public sealed partial class MainWindow : Window, INotifyPropertyChanged
 
     public string PageCountText => $"Pages: {totalPages} total";
 
+    public bool IsLoading => loadCancellation != null;
+
+    public Visibility IsLoadingVisibility => IsLoading ? Visibility.Visible : Visibility.Collapsed;
+
+    public double LoadProgress
+    {
+        get => loadProgress;
+        set
+        {
+            SetProperty(ref loadProgress, value);
+            OnPropertyChanged(nameof(LoadProgressText));
+        }
+    }
+
+    public string LoadProgressText => $"Extracting text... {(int)(loadProgress * 100)}%";
+
     public string ExtractedText
     {
         get => extractedText;
@@ -133,6 +156,24 @@ public sealed partial class MainWindow : Window, INotifyPropertyChanged
         ? $"{textToSpeech.CurrentWordIndex} of {textToSpeech.TotalWords} words" 
         : string.Empty;
 
+    public bool IsExporting => exportCancellation != null;
+
+    public bool CanExport => !IsExporting;
+
+    public Visibility IsExportingVisibility => IsExporting ? Visibility.Visible : Visibility.Collapsed;
+
+    public double ExportProgress
+    {
+        get => exportProgress;
+        set
+        {
+            SetProperty(ref exportProgress, value);
+            OnPropertyChanged(nameof(ExportProgressText));
+        }
+    }
+
+    public string ExportProgressText => $"Exporting audio... {(int)(exportProgress * 100)}%";
+
     // Event handlers
     private async void OnSelectPDFClicked(object sender, RoutedEventArgs e)
     {
@@ -149,17 +190,32 @@ public sealed partial class MainWindow : Window, INotifyPropertyChanged
         }
     }
 
-    private void OnSettingsClicked(object sender, RoutedEventArgs e)
+    private async void OnSettingsClicked(object sender, RoutedEventArgs e)
     {
-        // TODO: Implement settings dialog
+        var layoutCheckBox = new CheckBox
+        {
+            Content = "Layout-aware extraction: read columns in order and skip running headers, footers and page numbers",
+            IsChecked = pdfExtractor.Mode == ExtractionMode.Layout
+        };
         var dialog = new ContentDialog
         {
             Title = "Settings",
-            Content = "Settings dialog will be implemented here",
+            Content = layoutCheckBox,
             CloseButtonText = "Close",
             XamlRoot = this.Content.XamlRoot
         };
-        _ = dialog.ShowAsync();
+        await dialog.ShowAsync();
+
+        var mode = layoutCheckBox.IsChecked == true ? ExtractionMode.Layout : ExtractionMode.Plain;
+        if (mode != pdfExtractor.Mode)
+        {
+            pdfExtractor.Mode = mode;
+            if (hasPDF)
+            {
+                // Pages of the other mode have their own cache file, so switching back is instant
+                await LoadPDF(selectedFilePath);
+            }
+        }
     }
 
     private void OnPlayPauseClicked(object sender, RoutedEventArgs e)
@@ -186,15 +242,115 @@ public sealed partial class MainWindow : Window, INotifyPropertyChanged
         textToSpeech.Stop();
     }
 
+    private async void OnExportAudioClicked(object sender, RoutedEventArgs e)
+    {
+        var picker = new FileSavePicker
+        {
+            SuggestedFileName = System.IO.Path.GetFileNameWithoutExtension(selectedFilePath)
+        };
+        picker.FileTypeChoices.Add("MPEG-4 Audio", new List<string> { ".m4a" });
+
+        var hwnd = WinRT.Interop.WindowNative.GetWindowHandle(this);
+        WinRT.Interop.InitializeWithWindow.Initialize(picker, hwnd);
+
+        var file = await picker.PickSaveFileAsync();
+        if (file != null)
+        {
+            await ExportAudio(file.Path);
+        }
+    }
+
+    private void OnCancelExportClicked(object sender, RoutedEventArgs e)
+    {
+        exportCancellation?.Cancel();
+    }
+
+    private async Task ExportAudio(string outputPath)
+    {
+        exportCancellation = new CancellationTokenSource();
+        ExportProgress = 0;
+        OnExportStateChanged();
+
+        try
+        {
+            // Progress<T> reports back on the UI thread
+            var progress = new Progress<double>(value => ExportProgress = value);
+            await textToSpeech.ExportAsync(pdfExtractor.EnumeratePages(selectedFilePath), totalPages, outputPath, progress, exportCancellation.Token);
+        }
+        catch (OperationCanceledException)
+        {
+            // Cancelled from the export bar
+        }
+        catch (Exception ex)
+        {
+            var dialog = new ContentDialog
+            {
+                Title = "Error",
+                Content = $"Failed to export audio: {ex.Message}",
+                CloseButtonText = "OK",
+                XamlRoot = this.Content.XamlRoot
+            };
+            await dialog.ShowAsync();
+        }
+        finally
+        {
+            exportCancellation.Dispose();
+            exportCancellation = null;
+            OnExportStateChanged();
+        }
+    }
+
+    private void OnExportStateChanged()
+    {
+        OnPropertyChanged(nameof(IsExporting));
+        OnPropertyChanged(nameof(CanExport));
+        OnPropertyChanged(nameof(IsExportingVisibility));
+    }
+
     private async Task LoadPDF(string filePath)
     {
+        // A new file replaces any extraction still running for the previous one
+        loadCancellation?.Cancel();
+        var cancellation = new CancellationTokenSource();
+        loadCancellation = cancellation;
+
+        selectedFilePath = filePath;
+        selectedFileName = System.IO.Path.GetFileName(filePath);
+        extractedText = string.Empty;
+        totalPages = 0;
+        LoadProgress = 0;
+        OnPropertyChanged(nameof(SelectedFileName));
+        OnPropertyChanged(nameof(ExtractedText));
+        OnLoadStateChanged();
+
+        // Pages arrive in order on the UI thread; the text view is refreshed a few times a second
+        // rather than per page, since every refresh lays out the whole text again
+        var streamedText = new System.Text.StringBuilder();
+        var sinceRefresh = Stopwatch.StartNew();
+        var progress = new Progress<PDFTextExtractor.ExtractionProgress>(page =>
+        {
+            if (cancellation.IsCancellationRequested)
+            {
+                return;
+            }
+            if (page.Text != null)
+            {
+                streamedText.Append(page.Text).Append("\n\n");
+            }
+            LoadProgress = (double)page.CompletedPages / page.TotalPages;
+            totalPages = page.TotalPages; // The whole document is extracted
+            HasPDF = true;
+
+            if (sinceRefresh.ElapsedMilliseconds >= 250)
+            {
+                ExtractedText = streamedText.ToString();
+                sinceRefresh.Restart();
+            }
+        });
+
         try
         {
-            selectedFilePath = filePath;
-            selectedFileName = System.IO.Path.GetFileName(filePath);
-            
-            // Extract text from PDF
-            var result = pdfExtractor.ExtractText(filePath);
+            var result = await pdfExtractor.ExtractTextAsync(filePath, progress: progress, cancellationToken: cancellation.Token);
             if (result.Success)
             {
                 totalPages = result.PageRange.TotalPages;
@@ -221,6 +377,10 @@ public sealed partial class MainWindow : Window, INotifyPropertyChanged
                 await dialog.ShowAsync();
             }
         }
+        catch (OperationCanceledException)
+        {
+            // Another file was selected while this one was loading
+        }
         catch (Exception ex)
         {
             var dialog = new ContentDialog
@@ -232,6 +392,22 @@ public sealed partial class MainWindow : Window, INotifyPropertyChanged
             };
             await dialog.ShowAsync();
         }
+        finally
+        {
+            if (loadCancellation == cancellation)
+            {
+                loadCancellation = null;
+                OnLoadStateChanged();
+            }
+            cancellation.Dispose();
+        }
+    }
+
+    private void OnLoadStateChanged()
+    {
+        OnPropertyChanged(nameof(IsLoading));
+        OnPropertyChanged(nameof(IsLoadingVisibility));
+        OnPropertyChanged(nameof(PageCountText));
     }
 
     private void StartSpeaking()
@@ -278,6 +454,12 @@ public sealed partial class MainWindow : Window, INotifyPropertyChanged
         OnPropertyChanged(nameof(StatusColor));
     }
 
+    private void OnSpeechProgressChanged(object? sender, EventArgs e)
+    {
+        OnPropertyChanged(nameof(Progress));
+        OnPropertyChanged(nameof(ProgressText));
+    }
+
 
     // INotifyPropertyChanged implementation
     public event PropertyChangedEventHandler? PropertyChanged;
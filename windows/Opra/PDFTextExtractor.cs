@@ -2,6 +2,10 @@ using iText.Kernel.Pdf;
 using iText.Kernel.Pdf.Canvas.Parser;
 using iText.Kernel.Pdf.Canvas.Parser.Listener;
 using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
 
 namespace Opra;
 
@@ -22,6 +26,27 @@ public class PDFTextExtractor
         public string ErrorMessage { get; set; } = string.Empty;
     }
 
+    /// <summary>
+    /// Reported by <see cref="ExtractTextAsync"/> for each page, in page order. <see cref="Text"/>
+    /// is null for pages without a text layer.
+    /// </summary>
+    public record ExtractionProgress(int PageNumber, string? Text, int CompletedPages, int TotalPages);
+
+    // Below this many pages to extract, a single reader is faster than opening more
+    private const int MinPagesPerWorker = 8;
+
+    /// <summary>
+    /// Where extracted pages are kept between runs. Null extracts every page every time, which the
+    /// benchmarks use to measure extraction itself.
+    /// </summary>
+    public ExtractionCache? Cache { get; init; } = ExtractionCache.Shared;
+
+    /// <summary>
+    /// How page text is read. Each mode has its own cache file, so changing it between documents
+    /// never mixes page texts.
+    /// </summary>
+    public ExtractionMode Mode { get; set; } = ExtractionMode.Plain;
+
     public ExtractionResult ExtractText(string filePath, int startPage = 1, int endPage = -1)
     {
         try
@@ -33,19 +58,30 @@ public class PDFTextExtractor
             int start = Math.Max(1, startPage);
             int end = endPage == -1 ? pageCount : Math.Min(endPage, pageCount);
             
-            var text = string.Empty;
+            // Previously extracted pages of this file are reused from the on-disk cache
+            var cacheKey = Cache?.GetKey(filePath);
+            var pageCache = cacheKey == null ? null : Cache!.Open(cacheKey, pageCount, Mode);
+            var layout = Mode == ExtractionMode.Layout ? new PageLayout(pageCount) : null;
+            
+            var text = new StringBuilder();
             for (int i = start; i <= end; i++)
             {
-                var page = pdfDocument.GetPage(i);
-                var strategy = new SimpleTextExtractionStrategy();
-                text += PdfTextExtractor.GetTextFromPage(page, strategy);
-                text += "\n\n";
+                if (pageCache == null || !pageCache.TryGetPage(i, out var pageText))
+                {
+                    PipelineEventSource.Log.ExtractPageStart(i);
+                    pageText = ExtractPageText(pdfDocument, i, layout);
+                    pageCache?.Store(i, string.IsNullOrWhiteSpace(pageText) ? null : pageText);
+                    PipelineEventSource.Log.ExtractPageStop(i, pageText.Length);
+                }
+                text.Append(pageText);
+                text.Append("\n\n");
             }
+            pageCache?.Save();
             
             return new ExtractionResult
             {
                 Success = true,
-                FullText = text.Trim(),
+                FullText = text.ToString().Trim(),
                 PageRange = new PageRangeInfo
                 {
                     TotalPages = pageCount,
@@ -69,5 +105,232 @@ public class PDFTextExtractor
             };
         }
     }
-}
 
+    /// <summary>
+    /// Extracts <paramref name="startPage"/>..<paramref name="endPage"/> off the calling thread.
+    ///
+    /// iText documents are not thread-safe, so each worker opens its own reader on the file and
+    /// takes the next uncached page from a shared cursor. Pages are reported through
+    /// <paramref name="progress"/> in page order as soon as every page before them is done, so the
+    /// UI can show text while the rest is still being extracted. Pages without a text layer are
+    /// handed to a <see cref="PageRecognizer"/> and reported once OCR is done, while the workers
+    /// carry on with the pages after them. Cancelling throws <see cref="OperationCanceledException"/>;
+    /// pages extracted so far stay in the cache.
+    /// </summary>
+    public async Task<ExtractionResult> ExtractTextAsync(string filePath, int startPage = 1, int endPage = -1,
+        IProgress<ExtractionProgress>? progress = null, CancellationToken cancellationToken = default)
+    {
+        try
+        {
+            return await Task.Run(() => ExtractPagesAsync(filePath, startPage, endPage, Cache, Mode, progress, cancellationToken), cancellationToken);
+        }
+        catch (OperationCanceledException)
+        {
+            throw;
+        }
+        catch (Exception ex)
+        {
+            return new ExtractionResult
+            {
+                Success = false,
+                ErrorMessage = ex.Message,
+                PageRange = new PageRangeInfo
+                {
+                    TotalPages = 0,
+                    StartPage = 0,
+                    EndPage = 0
+                }
+            };
+        }
+    }
+
+    private static async Task<ExtractionResult> ExtractPagesAsync(string filePath, int startPage, int endPage, ExtractionCache? cache,
+        ExtractionMode mode, IProgress<ExtractionProgress>? progress, CancellationToken cancellationToken)
+    {
+        int pageCount;
+        using (var pdfReader = new PdfReader(filePath))
+        using (var pdfDocument = new PdfDocument(pdfReader))
+        {
+            pageCount = pdfDocument.GetNumberOfPages();
+        }
+        int start = Math.Max(1, startPage);
+        int end = endPage == -1 ? pageCount : Math.Min(endPage, pageCount);
+        int rangeLength = Math.Max(0, end - start + 1);
+
+        var cacheKey = cache?.GetKey(filePath);
+        var pageCache = cacheKey == null ? null : cache!.Open(cacheKey, pageCount, mode);
+        using var recognizer = new PageRecognizer(filePath, pageCache);
+        // Shared by the workers, so headers are compared across the pages each of them extracts
+        var layout = mode == ExtractionMode.Layout ? new PageLayout(pageCount) : null;
+
+        // Slot i holds page start + i; cached pages are filled in up front
+        var texts = new string?[rangeLength];
+        var isDone = new bool[rangeLength];
+        var missing = new List<int>();
+        var needsOCR = new List<int>();
+        for (int i = 0; i < rangeLength; i++)
+        {
+            if (pageCache != null && pageCache.GetState(start + i) == ExtractionCache.PageState.Empty && recognizer.IsAvailable)
+            {
+                needsOCR.Add(i);
+            }
+            else if (pageCache != null && pageCache.TryGetPage(start + i, out var cached))
+            {
+                texts[i] = cached;
+                isDone[i] = true;
+            }
+            else
+            {
+                missing.Add(i);
+            }
+        }
+
+        var reportLock = new object();
+        int nextToReport = 0;
+        void ReportReadyPages()
+        {
+            // Pages finish out of order; only the finished prefix of the range is reported
+            lock (reportLock)
+            {
+                while (nextToReport < rangeLength && Volatile.Read(ref isDone[nextToReport]))
+                {
+                    progress?.Report(new ExtractionProgress(start + nextToReport, texts[nextToReport], nextToReport + 1, rangeLength));
+                    nextToReport++;
+                }
+            }
+        }
+        ReportReadyPages();
+
+        var recognitions = new List<Task>();
+        void Recognize(int slot)
+        {
+            var recognition = recognizer.RecognizeAsync(start + slot, cancellationToken).ContinueWith(task =>
+            {
+                texts[slot] = task.Result;
+                Volatile.Write(ref isDone[slot], true);
+                ReportReadyPages();
+            }, cancellationToken, TaskContinuationOptions.OnlyOnRanToCompletion, TaskScheduler.Default);
+            lock (recognitions)
+            {
+                recognitions.Add(recognition);
+            }
+        }
+        needsOCR.ForEach(Recognize);
+
+        int workerCount = Math.Clamp(missing.Count / MinPagesPerWorker, 1, Environment.ProcessorCount);
+        int cursor = -1;
+        var workers = new Task[workerCount];
+        for (int w = 0; w < workerCount; w++)
+        {
+            workers[w] = Task.Run(() =>
+            {
+                using var pdfReader = new PdfReader(filePath);
+                using var pdfDocument = new PdfDocument(pdfReader);
+                int next;
+                while ((next = Interlocked.Increment(ref cursor)) < missing.Count)
+                {
+                    cancellationToken.ThrowIfCancellationRequested();
+                    int slot = missing[next];
+                    PipelineEventSource.Log.ExtractPageStart(start + slot);
+                    var pageText = ExtractPageText(pdfDocument, start + slot, layout);
+                    pageText = string.IsNullOrWhiteSpace(pageText) ? null : pageText;
+                    PipelineEventSource.Log.ExtractPageStop(start + slot, pageText?.Length ?? 0);
+                    pageCache?.Store(start + slot, pageText);
+                    if (pageText == null && recognizer.IsAvailable)
+                    {
+                        Recognize(slot);
+                        continue;
+                    }
+
+                    texts[slot] = pageText;
+                    Volatile.Write(ref isDone[slot], true);
+                    ReportReadyPages();
+                }
+            }, cancellationToken);
+        }
+
+        try
+        {
+            await Task.WhenAll(workers);
+            Task[] pendingRecognitions;
+            lock (recognitions)
+            {
+                pendingRecognitions = recognitions.ToArray();
+            }
+            await Task.WhenAll(pendingRecognitions);
+        }
+        finally
+        {
+            pageCache?.Save();
+        }
+
+        var text = new StringBuilder();
+        foreach (var pageText in texts)
+        {
+            text.Append(pageText);
+            text.Append("\n\n");
+        }
+
+        return new ExtractionResult
+        {
+            Success = true,
+            FullText = text.ToString().Trim(),
+            PageRange = new PageRangeInfo
+            {
+                TotalPages = pageCount,
+                StartPage = start,
+                EndPage = end
+            }
+        };
+    }
+
+    /// <summary>
+    /// Yields the text of every page that has any, in order, for exporting the whole document.
+    /// Pages are read lazily and reuse <see cref="Cache"/> like <see cref="ExtractText"/>; pages
+    /// without a text layer are recognized with OCR, blocking the enumerating thread.
+    /// </summary>
+    public IEnumerable<(int PageNumber, string Text)> EnumeratePages(string filePath)
+    {
+        using var pdfReader = new PdfReader(filePath);
+        using var pdfDocument = new PdfDocument(pdfReader);
+
+        int pageCount = pdfDocument.GetNumberOfPages();
+        var cacheKey = Cache?.GetKey(filePath);
+        var pageCache = cacheKey == null ? null : Cache!.Open(cacheKey, pageCount, Mode);
+        using var recognizer = new PageRecognizer(filePath, pageCache);
+        var layout = Mode == ExtractionMode.Layout ? new PageLayout(pageCount) : null;
+
+        for (int i = 1; i <= pageCount; i++)
+        {
+            if (pageCache == null || !pageCache.TryGetPage(i, out var pageText))
+            {
+                PipelineEventSource.Log.ExtractPageStart(i);
+                pageText = ExtractPageText(pdfDocument, i, layout);
+                pageText = string.IsNullOrWhiteSpace(pageText) ? null : pageText;
+                PipelineEventSource.Log.ExtractPageStop(i, pageText?.Length ?? 0);
+                pageCache?.Store(i, pageText);
+            }
+            if (pageText == null && (pageCache == null || pageCache.GetState(i) == ExtractionCache.PageState.Empty))
+            {
+                pageText = recognizer.RecognizeAsync(i).GetAwaiter().GetResult();
+            }
+            if (!string.IsNullOrWhiteSpace(pageText))
+            {
+                yield return (i, pageText);
+            }
+        }
+        pageCache?.Save();
+    }
+
+    /// <summary>
+    /// The page's text read from the PDF itself, in reading order with a <paramref name="layout"/>.
+    /// </summary>
+    private static string ExtractPageText(PdfDocument pdfDocument, int pageNumber, PageLayout? layout)
+    {
+        if (layout != null)
+        {
+            return layout.GetText(pdfDocument, pageNumber) ?? string.Empty;
+        }
+        return PdfTextExtractor.GetTextFromPage(pdfDocument.GetPage(pageNumber), new SimpleTextExtractionStrategy());
+    }
+}
@@ -0,0 +1,462 @@
+using iText.Kernel.Geom;
+using iText.Kernel.Pdf;
+using iText.Kernel.Pdf.Canvas.Parser;
+using iText.Kernel.Pdf.Canvas.Parser.Data;
+using iText.Kernel.Pdf.Canvas.Parser.Listener;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+namespace Opra;
+
+/// <summary>How the text of a page is taken from the PDF.</summary>
+public enum ExtractionMode
+{
+    Plain,  // iText's text in the order the PDF draws it
+    Layout  // lines in reading order, without running headers, footers and page numbers
+}
+
+/// <summary>
+/// Layout-aware text of a document's pages, for <see cref="ExtractionMode.Layout"/>; the same
+/// analysis as macos/Opra/PageLayout.swift.
+///
+/// Lines are built from the positions of the text iText reports, and a wide horizontal gap ends a
+/// line, so the lines of columns side by side stay apart. Columns are found as vertical gutters
+/// that narrow lines don't cross, and a page is read column by column between the lines that span
+/// them, such as titles and full-width figures.
+///
+/// Lines in the top or bottom band of a page are dropped when they are page numbers, or when the
+/// same line, with its numbers ignored, is in the same band of a page up to two pages away, which
+/// also catches headers that alternate between even and odd pages. The bands of every page are
+/// kept in a table shared by the extraction workers, and a page parsed early for its bands keeps
+/// its lines until its own text is asked for, so every page is parsed once however the pages are
+/// split between the workers. Each worker passes its own document.
+/// </summary>
+public class PageLayout
+{
+    private record Line(string Text, float Left, float Right, float Top, float Bottom)
+    {
+        public float Width => Right - Left;
+        public float MidY => (Top + Bottom) / 2;
+    }
+
+    private record Edges(HashSet<string> Top, HashSet<string> Bottom);
+
+    private record ParsedPage(List<Line> Lines, Rectangle Bounds);
+
+    // Share of the page height at the top and bottom where running headers and footers are looked for
+    private const float EdgeBand = 0.1f;
+    // Pages on either side compared for repeated headers and footers
+    private const int NeighborDistance = 2;
+    // Lines at least this share of the text width are never column lines
+    private const float ColumnLineWidth = 0.6f;
+    // A horizontal gap wider than this many line heights separates two lines
+    private const float LineGap = 1.5f;
+    // Pages parsed for their bands whose text nobody asked for are only kept up to this many
+    private const int MaxParsedAhead = 16;
+
+    private readonly Dictionary<int, Edges> edges = new();
+    private readonly Dictionary<int, ParsedPage> parsedAhead = new();
+    private readonly object tableLock = new();
+
+    public int PageCount { get; }
+
+    public PageLayout(int pageCount)
+    {
+        PageCount = pageCount;
+    }
+
+    /// <summary>
+    /// Text of the page in reading order, or null if it has no text. Pages are 1-based, matching iText.
+    /// </summary>
+    public string? GetText(PdfDocument document, int pageNumber)
+    {
+        // Parsed already if a neighbor needed its headers first
+        ParsedPage? page;
+        lock (tableLock)
+        {
+            parsedAhead.Remove(pageNumber, out page);
+        }
+        page ??= Parse(document, pageNumber);
+        if (page.Lines.Count == 0)
+        {
+            return null;
+        }
+
+        var repeated = RepeatedEdges(document, pageNumber);
+        var body = page.Lines.Where(line => BandOf(line, page.Bounds) switch
+        {
+            Band.Top => !IsBoilerplate(line.Text, repeated.Top),
+            Band.Bottom => !IsBoilerplate(line.Text, repeated.Bottom),
+            _ => true
+        }).ToList();
+        var text = string.Join("\n", ReadingOrder(body).Select(line => line.Text));
+        return text.Length == 0 ? null : text;
+    }
+
+    // Headers and footers
+
+    private Edges RepeatedEdges(PdfDocument document, int pageNumber)
+    {
+        var own = EdgesOf(document, pageNumber);
+        var top = new HashSet<string>();
+        var bottom = new HashSet<string>();
+        for (int distance = 1; distance <= NeighborDistance; distance++)
+        {
+            foreach (var neighbor in new[] { pageNumber - distance, pageNumber + distance })
+            {
+                if (neighbor < 1 || neighbor > PageCount)
+                {
+                    continue;
+                }
+                var other = EdgesOf(document, neighbor);
+                top.UnionWith(own.Top.Intersect(other.Top));
+                bottom.UnionWith(own.Bottom.Intersect(other.Bottom));
+            }
+        }
+        return new Edges(top, bottom);
+    }
+
+    private Edges EdgesOf(PdfDocument document, int pageNumber)
+    {
+        lock (tableLock)
+        {
+            if (edges.TryGetValue(pageNumber, out var known))
+            {
+                return known;
+            }
+        }
+
+        // Parsed outside the lock; two workers reaching the same page find the same lines
+        var page = Parse(document, pageNumber);
+        lock (tableLock)
+        {
+            if (parsedAhead.Count < MaxParsedAhead)
+            {
+                parsedAhead[pageNumber] = page;
+            }
+            return edges[pageNumber];
+        }
+    }
+
+    private ParsedPage Parse(PdfDocument document, int pageNumber)
+    {
+        var pdfPage = document.GetPage(pageNumber);
+        var collector = new TextRunCollector();
+        new PdfCanvasProcessor(collector).ProcessPageContent(pdfPage);
+        var page = new ParsedPage(collector.BuildLines(), pdfPage.GetCropBox());
+
+        var found = new Edges(new HashSet<string>(), new HashSet<string>());
+        foreach (var line in page.Lines)
+        {
+            var band = BandOf(line, page.Bounds);
+            var signature = Signature(line.Text);
+            if (band != Band.None && signature.Length > 0)
+            {
+                (band == Band.Top ? found.Top : found.Bottom).Add(signature);
+            }
+        }
+        lock (tableLock)
+        {
+            edges.TryAdd(pageNumber, found);
+        }
+        return page;
+    }
+
+    private enum Band
+    {
+        None,
+        Top,
+        Bottom
+    }
+
+    private static Band BandOf(Line line, Rectangle bounds)
+    {
+        var bandHeight = bounds.GetHeight() * EdgeBand;
+        if (line.MidY >= bounds.GetTop() - bandHeight)
+        {
+            return Band.Top;
+        }
+        if (line.MidY <= bounds.GetBottom() + bandHeight)
+        {
+            return Band.Bottom;
+        }
+        return Band.None;
+    }
+
+    private static bool IsBoilerplate(string line, HashSet<string> repeated)
+    {
+        var signature = Signature(line);
+        return signature.Length == 0 || repeated.Contains(signature) || IsPageNumber(signature);
+    }
+
+    /// <summary>
+    /// The line folded so that it matches the same header on another page: lowercased, every run
+    /// of digits as <c>#</c> and runs of whitespace as one space.
+    /// </summary>
+    public static string Signature(string line)
+    {
+        var signature = new StringBuilder(line.Length);
+        bool lastWasDigit = false;
+        bool lastWasSpace = true;
+        foreach (var character in line.ToLowerInvariant())
+        {
+            if (char.IsDigit(character))
+            {
+                if (!lastWasDigit)
+                {
+                    signature.Append('#');
+                }
+                lastWasDigit = true;
+                lastWasSpace = false;
+            }
+            else if (char.IsWhiteSpace(character))
+            {
+                if (!lastWasSpace)
+                {
+                    signature.Append(' ');
+                }
+                lastWasDigit = false;
+                lastWasSpace = true;
+            }
+            else
+            {
+                signature.Append(character);
+                lastWasDigit = false;
+                lastWasSpace = false;
+            }
+        }
+        return signature.ToString().Trim();
+    }
+
+    private static readonly HashSet<string> PageNumberWords = new() { "#", "page", "p", "pp", "of", "pag", "pagina", "di", "seite", "von" };
+
+    // "12", "- 12 -", "Page 12 of 300", "xiv" and the like, as signatures
+    private static bool IsPageNumber(string signature)
+    {
+        var tokens = new List<string>();
+        var token = new StringBuilder();
+        foreach (var character in signature + " ")
+        {
+            if (char.IsLetter(character) || character == '#')
+            {
+                token.Append(character);
+            }
+            else if (token.Length > 0)
+            {
+                tokens.Add(token.ToString());
+                token.Clear();
+            }
+        }
+        if (tokens.Count == 0)
+        {
+            return true; // Only punctuation left
+        }
+        return tokens.Any(t => t == "#" || IsRomanNumeral(t))
+            && tokens.All(t => PageNumberWords.Contains(t) || IsRomanNumeral(t));
+    }
+
+    private static bool IsRomanNumeral(string token) => token.Length <= 6 && token.All(c => "ivxlc".Contains(c));
+
+    // Reading order
+
+    // Lines top to bottom, one column at a time between the lines that span several columns
+    private static List<Line> ReadingOrder(List<Line> lines)
+    {
+        var columns = Columns(lines);
+        if (columns.Count <= 1)
+        {
+            return lines;
+        }
+
+        var ordered = new List<Line>();
+        var pending = columns.Select(_ => new List<Line>()).ToList();
+        foreach (var line in lines)
+        {
+            int column = columns.FindIndex(c => line.Left >= c.Left && line.Right <= c.Right);
+            if (column >= 0)
+            {
+                pending[column].Add(line);
+                continue;
+            }
+            // A line across columns ends the columns above it
+            pending.ForEach(ordered.AddRange);
+            pending.ForEach(p => p.Clear());
+            ordered.Add(line);
+        }
+        pending.ForEach(ordered.AddRange);
+        return ordered;
+    }
+
+    // X ranges of the columns of the page, left to right, split at gutters no column line crosses
+    private static List<(float Left, float Right)> Columns(List<Line> lines)
+    {
+        if (lines.Count == 0)
+        {
+            return new();
+        }
+        float left = lines.Min(l => l.Left);
+        float right = lines.Max(l => l.Right);
+        var columnLines = lines.Where(l => l.Width < (right - left) * ColumnLineWidth).ToList();
+        return Split(columnLines, left, right);
+    }
+
+    private static List<(float Left, float Right)> Split(List<Line> lines, float left, float right)
+    {
+        // A gutter needs a few lines on each side of it, so a stray short line isn't a column
+        const int minimumLines = 3;
+        if (lines.Count < minimumLines * 2)
+        {
+            return new() { (left, right) };
+        }
+
+        // Horizontal extents of the lines merged where they overlap; the widest gap between them
+        // in the middle of the range is the gutter
+        var covered = new List<(float Left, float Right)>();
+        foreach (var line in lines.OrderBy(l => l.Left))
+        {
+            if (covered.Count > 0 && line.Left <= covered[^1].Right)
+            {
+                covered[^1] = (covered[^1].Left, Math.Max(covered[^1].Right, line.Right));
+            }
+            else
+            {
+                covered.Add((line.Left, line.Right));
+            }
+        }
+        float width = right - left;
+        float middleLeft = left + width * 0.2f;
+        float middleRight = right - width * 0.2f;
+        (float Left, float Right)? gutter = null;
+        for (int i = 1; i < covered.Count; i++)
+        {
+            var gap = (Left: covered[i - 1].Right, Right: covered[i].Left);
+            float center = (gap.Left + gap.Right) / 2;
+            if (center >= middleLeft && center <= middleRight
+                && (gutter == null || gap.Right - gap.Left > gutter.Value.Right - gutter.Value.Left))
+            {
+                gutter = gap;
+            }
+        }
+        if (gutter == null)
+        {
+            return new() { (left, right) };
+        }
+
+        var leftLines = lines.Where(l => l.Right <= gutter.Value.Left).ToList();
+        var rightLines = lines.Where(l => l.Left >= gutter.Value.Right).ToList();
+        if (leftLines.Count < minimumLines || rightLines.Count < minimumLines)
+        {
+            return new() { (left, right) };
+        }
+        return Split(leftLines, left, gutter.Value.Left).Concat(Split(rightLines, gutter.Value.Right, right)).ToList();
+    }
+
+    /// <summary>
+    /// Collects each run of text the page draws with its position, and builds lines from them.
+    /// </summary>
+    private class TextRunCollector : IEventListener
+    {
+        private record TextRun(string Text, float Left, float Right, float Baseline, float Top, float Bottom, float SpaceWidth);
+
+        private readonly List<TextRun> runs = new();
+
+        public void EventOccurred(IEventData data, EventType type)
+        {
+            if (type != EventType.RENDER_TEXT || data is not TextRenderInfo info)
+            {
+                return;
+            }
+            var text = info.GetText();
+            if (string.IsNullOrEmpty(text))
+            {
+                return;
+            }
+            // Read right away: iText reuses the render info once the event returns
+            var baseline = info.GetBaseline();
+            var ascent = info.GetAscentLine();
+            var descent = info.GetDescentLine();
+            float start = baseline.GetStartPoint().Get(Vector.I1);
+            float end = baseline.GetEndPoint().Get(Vector.I1);
+            runs.Add(new TextRun(text, Math.Min(start, end), Math.Max(start, end),
+                baseline.GetStartPoint().Get(Vector.I2),
+                ascent.GetStartPoint().Get(Vector.I2),
+                descent.GetStartPoint().Get(Vector.I2),
+                info.GetSingleSpaceWidth()));
+        }
+
+        public ICollection<EventType> GetSupportedEvents() => new[] { EventType.RENDER_TEXT };
+
+        /// <summary>
+        /// Lines top to bottom, and left to right within a row of runs sharing a baseline. A row is
+        /// cut into several lines at gaps wider than <see cref="LineGap"/> line heights.
+        /// </summary>
+        public List<Line> BuildLines()
+        {
+            var rows = new List<List<TextRun>>();
+            foreach (var run in runs.OrderByDescending(r => r.Baseline))
+            {
+                var row = rows.Count > 0 ? rows[^1] : null;
+                if (row != null && row[0].Baseline - run.Baseline < Math.Min(Height(row[0]), Height(run)) / 2)
+                {
+                    row.Add(run);
+                }
+                else
+                {
+                    rows.Add(new List<TextRun> { run });
+                }
+            }
+
+            var lines = new List<Line>();
+            foreach (var row in rows)
+            {
+                var text = new StringBuilder();
+                TextRun? first = null;
+                TextRun? previous = null;
+                float top = float.MinValue;
+                float bottom = float.MaxValue;
+                void EndLine()
+                {
+                    var lineText = text.ToString().Trim();
+                    if (first != null && previous != null && lineText.Length > 0)
+                    {
+                        lines.Add(new Line(lineText, first.Left, previous.Right, top, bottom));
+                    }
+                    text.Clear();
+                    top = float.MinValue;
+                    bottom = float.MaxValue;
+                }
+
+                foreach (var run in row.OrderBy(r => r.Left))
+                {
+                    if (previous != null)
+                    {
+                        float gap = run.Left - previous.Right;
+                        if (gap > Height(run) * LineGap)
+                        {
+                            EndLine();
+                            first = run;
+                        }
+                        else if (gap > run.SpaceWidth / 2 && (text.Length == 0 || text[^1] != ' ') && !run.Text.StartsWith(' '))
+                        {
+                            text.Append(' ');
+                        }
+                    }
+                    else
+                    {
+                        first = run;
+                    }
+                    text.Append(run.Text);
+                    top = Math.Max(top, run.Top);
+                    bottom = Math.Min(bottom, run.Bottom);
+                    previous = run;
+                }
+                EndLine();
+            }
+            return lines;
+        }
+
+        private static float Height(TextRun run) => Math.Max(1, run.Top - run.Bottom);
+    }
+}
@@ -0,0 +1,142 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Windows.Data.Pdf;
+using Windows.Graphics.Imaging;
+using Windows.Media.Ocr;
+using Windows.Storage;
+using Windows.Storage.Streams;
+
+namespace Opra;
+
+/// <summary>
+/// OCR for the pages of one document that have no text layer, such as scanned pages, using
+/// Windows.Media.Ocr (the macOS app does the same with Vision in PageRecognizer.swift).
+///
+/// Requested pages are recognized one at a time on a background task, lowest page number first,
+/// since reading goes front to back. Pages are rendered with Windows.Data.Pdf, which is separate
+/// from the iText readers used for the text layer. Results go into the document's extraction cache
+/// as <see cref="ExtractionCache.PageState.Recognized"/> or
+/// <see cref="ExtractionCache.PageState.Unrecognized"/>, so a page is only ever recognized once.
+/// </summary>
+public sealed class PageRecognizer : IDisposable
+{
+    // 2x the PDF point size (144 dpi) is enough for body text without huge bitmaps
+    private const double RenderScale = 2.0;
+
+    private readonly string filePath;
+    private readonly ExtractionCache.DocumentTextCache? pageCache;
+    private readonly OcrEngine? engine = OcrEngine.TryCreateFromUserProfileLanguages();
+    private readonly SortedDictionary<int, TaskCompletionSource<string?>> backlog = new();
+    private readonly object backlogLock = new();
+    private readonly CancellationTokenSource disposal = new();
+    private Task? worker;
+    private PdfDocument? document;
+
+    public PageRecognizer(string filePath, ExtractionCache.DocumentTextCache? pageCache)
+    {
+        this.filePath = filePath;
+        this.pageCache = pageCache;
+    }
+
+    /// <summary>False when no OCR language is installed for the user's profile languages.</summary>
+    public bool IsAvailable => engine != null;
+
+    /// <summary>
+    /// Recognizes a page (1-based) in the background and returns its text, or null if OCR found
+    /// none. Asking again for a page that is already queued returns the same result.
+    /// </summary>
+    public Task<string?> RecognizeAsync(int pageNumber, CancellationToken cancellationToken = default)
+    {
+        if (engine == null)
+        {
+            return Task.FromResult<string?>(null);
+        }
+
+        TaskCompletionSource<string?>? completion;
+        lock (backlogLock)
+        {
+            if (!backlog.TryGetValue(pageNumber, out completion))
+            {
+                completion = new TaskCompletionSource<string?>(TaskCreationOptions.RunContinuationsAsynchronously);
+                backlog.Add(pageNumber, completion);
+            }
+            if (worker == null || worker.IsCompleted)
+            {
+                worker = Task.Run(DrainBacklogAsync);
+            }
+        }
+        return completion.Task.WaitAsync(cancellationToken);
+    }
+
+    public void Dispose()
+    {
+        disposal.Cancel();
+    }
+
+    private async Task DrainBacklogAsync()
+    {
+        while (true)
+        {
+            int pageNumber;
+            TaskCompletionSource<string?> completion;
+            lock (backlogLock)
+            {
+                if (backlog.Count == 0 || disposal.IsCancellationRequested)
+                {
+                    foreach (var pending in backlog.Values)
+                    {
+                        pending.TrySetCanceled();
+                    }
+                    backlog.Clear();
+                    worker = null;
+                    return;
+                }
+                (pageNumber, completion) = backlog.First();
+            }
+
+            try
+            {
+                var text = await RecognizePageAsync(pageNumber);
+                pageCache?.Store(pageNumber, text, text == null ? ExtractionCache.PageState.Unrecognized : ExtractionCache.PageState.Recognized);
+                completion.TrySetResult(text);
+            }
+            catch (Exception)
+            {
+                // Left as Empty in the cache, so the page is tried again next time
+                completion.TrySetResult(null);
+            }
+
+            lock (backlogLock)
+            {
+                backlog.Remove(pageNumber);
+            }
+        }
+    }
+
+    private async Task<string?> RecognizePageAsync(int pageNumber)
+    {
+        PipelineEventSource.Log.RecognizePageStart(pageNumber);
+        if (document == null)
+        {
+            var file = await StorageFile.GetFileFromPathAsync(Path.GetFullPath(filePath));
+            document = await PdfDocument.LoadFromFileAsync(file);
+        }
+
+        using var page = document.GetPage((uint)(pageNumber - 1));
+        using var stream = new InMemoryRandomAccessStream();
+        var width = Math.Min(page.Size.Width * RenderScale, OcrEngine.MaxImageDimension);
+        await page.RenderToStreamAsync(stream, new PdfPageRenderOptions { DestinationWidth = (uint)width });
+
+        var decoder = await BitmapDecoder.CreateAsync(stream);
+        using var bitmap = await decoder.GetSoftwareBitmapAsync(BitmapPixelFormat.Bgra8, BitmapAlphaMode.Premultiplied);
+        var result = await engine!.RecognizeAsync(bitmap);
+
+        var text = string.Join("\n", result.Lines.Select(line => line.Text));
+        PipelineEventSource.Log.RecognizePageStop(pageNumber, text.Length);
+        return string.IsNullOrWhiteSpace(text) ? null : text;
+    }
+}
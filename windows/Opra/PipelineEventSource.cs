@@ -0,0 +1,143 @@
+using System.Diagnostics.Tracing;
+
+namespace Opra;
+
+/// <summary>
+/// ETW events for each stage of the reading pipeline, the Windows counterpart of the signposts in
+/// Instrumentation.swift. Record them with PerfView (<c>/OnlyProviders=*Opra-Pipeline</c>),
+/// <c>dotnet-trace collect --providers Opra-Pipeline</c> or Windows Performance Recorder.
+///
+/// Nothing is written unless a session has enabled the provider, so every method costs one
+/// <see cref="EventSource.IsEnabled()"/> check otherwise. Pairs named Start/Stop become activities
+/// with a duration in PerfView. Prompts are queued, started and completed from different callbacks
+/// of the synthesizer, so speech uses plain events matched up by segment number instead.
+/// </summary>
+[EventSource(Name = "Opra-Pipeline")]
+public sealed class PipelineEventSource : EventSource
+{
+    public static readonly PipelineEventSource Log = new();
+
+    public static class Keywords
+    {
+        public const EventKeywords Extraction = (EventKeywords)0x1;
+        public const EventKeywords Recognition = (EventKeywords)0x2;
+        public const EventKeywords Speech = (EventKeywords)0x4;
+        public const EventKeywords Export = (EventKeywords)0x8;
+    }
+
+    private PipelineEventSource()
+    {
+    }
+
+    [Event(1, Keywords = Keywords.Extraction, Level = EventLevel.Verbose)]
+    public void ExtractPageStart(int pageNumber)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(1, pageNumber);
+        }
+    }
+
+    /// <summary><paramref name="characters"/> is 0 for a page without a text layer.</summary>
+    [Event(2, Keywords = Keywords.Extraction, Level = EventLevel.Verbose)]
+    public void ExtractPageStop(int pageNumber, int characters)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(2, pageNumber, characters);
+        }
+    }
+
+    [Event(3, Keywords = Keywords.Recognition, Level = EventLevel.Verbose)]
+    public void RecognizePageStart(int pageNumber)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(3, pageNumber);
+        }
+    }
+
+    /// <summary><paramref name="characters"/> is 0 when OCR found no text.</summary>
+    [Event(4, Keywords = Keywords.Recognition, Level = EventLevel.Verbose)]
+    public void RecognizePageStop(int pageNumber, int characters)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(4, pageNumber, characters);
+        }
+    }
+
+    [Event(5, Keywords = Keywords.Speech, Level = EventLevel.Verbose)]
+    public void BuildPromptStart(int segment)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(5, segment);
+        }
+    }
+
+    [Event(6, Keywords = Keywords.Speech, Level = EventLevel.Verbose)]
+    public void BuildPromptStop(int segment, int words)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(6, segment, words);
+        }
+    }
+
+    /// <summary>A prompt was handed to the synthesizer, behind any still playing.</summary>
+    [Event(7, Keywords = Keywords.Speech, Level = EventLevel.Verbose)]
+    public void PromptQueued(int segment)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(7, segment);
+        }
+    }
+
+    [Event(8, Keywords = Keywords.Speech, Level = EventLevel.Verbose)]
+    public void PromptStarted(int segment)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(8, segment);
+        }
+    }
+
+    [Event(9, Keywords = Keywords.Speech, Level = EventLevel.Verbose)]
+    public void PromptCompleted(int segment)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(9, segment);
+        }
+    }
+
+    [Event(10, Keywords = Keywords.Export, Level = EventLevel.Verbose)]
+    public void ExportPageStart(int pageNumber)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(10, pageNumber);
+        }
+    }
+
+    [Event(11, Keywords = Keywords.Export, Level = EventLevel.Verbose)]
+    public void ExportPageStop(int pageNumber)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(11, pageNumber);
+        }
+    }
+
+    /// <summary>The extraction cache could not be written; reading carries on without it.</summary>
+    [Event(12, Keywords = Keywords.Extraction, Level = EventLevel.Warning)]
+    public void CacheSaveFailed(string message)
+    {
+        if (IsEnabled())
+        {
+            WriteEvent(12, message);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+using System;
+using System.Collections.Generic;
+
+namespace Opra;
+
+/// <summary>
+/// Splits text into sentence-sized segments for the speech prompt queue.
+///
+/// A segment ends at the first sentence end or paragraph break once it is at least
+/// <see cref="MinLength"/> characters long, so segments are one or a few whole sentences. Text
+/// with no sentence end in reach is cut at the last space before <see cref="MaxLength"/>.
+/// Segments are produced lazily, so the first one is ready without scanning the whole text.
+/// </summary>
+public static class TextSegmenter
+{
+    public const int MinLength = 80;
+    public const int MaxLength = 600;
+
+    public record Segment(string Text, int WordCount);
+
+    public static IEnumerable<Segment> Split(string text)
+    {
+        int position = SkipWhitespace(text, 0);
+        while (position < text.Length)
+        {
+            int end = FindCut(text, position);
+            var segmentText = text.Substring(position, end - position).TrimEnd();
+            if (segmentText.Length > 0)
+            {
+                yield return new Segment(segmentText, CountWords(segmentText));
+            }
+            position = SkipWhitespace(text, end);
+        }
+    }
+
+    /// <summary>
+    /// Counts whitespace-separated words without allocating.
+    /// </summary>
+    public static int CountWords(string text)
+    {
+        int count = 0;
+        bool inWord = false;
+        foreach (var c in text)
+        {
+            if (char.IsWhiteSpace(c))
+            {
+                inWord = false;
+            }
+            else if (!inWord)
+            {
+                inWord = true;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    private static int FindCut(string text, int start)
+    {
+        int limit = Math.Min(text.Length, start + MaxLength);
+        int lastSpace = -1;
+        for (int i = start; i < limit; i++)
+        {
+            if (!char.IsWhiteSpace(text[i]))
+            {
+                continue;
+            }
+            if (i - start >= MinLength && (IsSentenceEnd(text, start, i) || IsParagraphBreak(text, i)))
+            {
+                return i;
+            }
+            lastSpace = i;
+        }
+        return limit == text.Length || lastSpace < 0 ? limit : lastSpace;
+    }
+
+    /// <summary>
+    /// True if the whitespace at <paramref name="index"/> follows '.', '!' or '?', allowing for
+    /// closing quotes and brackets in between.
+    /// </summary>
+    private static bool IsSentenceEnd(string text, int start, int index)
+    {
+        int i = index - 1;
+        while (i > start && (text[i] == '"' || text[i] == '\'' || text[i] == ')' || text[i] == ']' || text[i] == '”' || text[i] == '’'))
+        {
+            i--;
+        }
+        return text[i] == '.' || text[i] == '!' || text[i] == '?';
+    }
+
+    private static bool IsParagraphBreak(string text, int index)
+    {
+        if (text[index] != '\n')
+        {
+            return false;
+        }
+        for (int i = index + 1; i < text.Length && char.IsWhiteSpace(text[i]); i++)
+        {
+            if (text[i] == '\n')
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    private static int SkipWhitespace(string text, int index)
+    {
+        while (index < text.Length && char.IsWhiteSpace(text[index]))
+        {
+            index++;
+        }
+        return index;
+    }
+}
@@ -2,11 +2,32 @@ using System;
 using System.Collections.Generic;
 using System.Linq;
 using System.Speech.Synthesis;
+using System.Threading;
+using System.Threading.Tasks;
 
 namespace Opra;
 
+/// <summary>
+/// Reads text aloud as a queue of sentence-sized prompts.
+///
+/// Prompts are built on a background thread and handed to the synthesizer while earlier ones are
+/// still playing, up to <see cref="PromptsAhead"/> at a time, so speech starts after the first
+/// sentence and there is no gap between prompts. Word progress comes from the synthesizer's
+/// <c>SpeakProgress</c> events, which fire once per spoken word.
+/// </summary>
 public class TextToSpeech
 {
+    // Prompts waiting in the synthesizer behind the one being spoken
+    private const int PromptsAhead = 2;
+
+    private class QueuedPrompt
+    {
+        public Prompt Prompt { get; init; } = null!;
+        public int Index { get; init; }
+        public int WordOffset { get; init; }
+        public int WordCount { get; init; }
+    }
+
     private readonly SpeechSynthesizer synthesizer;
     private bool isSpeaking = false;
     private bool isPaused = false;
@@ -14,6 +35,14 @@ public class TextToSpeech
     private int currentWordIndex = 0;
     private int totalWords = 0;
 
+    // Prompts handed to the synthesizer and not yet completed, in speaking order. Only touched on
+    // the thread that called Speak, which is where the synthesizer raises its events.
+    private readonly Queue<QueuedPrompt> queuedPrompts = new();
+    private CancellationTokenSource? playbackCancellation;
+    private SemaphoreSlim? promptSlots;
+    private bool isBuildingPrompts = false;
+    private int wordsSpokenInPrompt = 0;
+
     public class Voice
     {
         public string Id { get; set; } = string.Empty;
@@ -31,6 +60,7 @@ public class TextToSpeech
     public event EventHandler? SpeechFinished;
     public event EventHandler? SpeechPaused;
     public event EventHandler? SpeechResumed;
+    public event EventHandler? ProgressChanged;
 
     public bool IsSpeaking => isSpeaking;
     public bool IsPaused => isPaused;
@@ -56,20 +86,9 @@ public class TextToSpeech
         synthesizer = new SpeechSynthesizer();
         synthesizer.SetOutputToDefaultAudioDevice();
         
-        synthesizer.SpeakStarted += (s, e) =>
-        {
-            isSpeaking = true;
-            SpeechStarted?.Invoke(this, EventArgs.Empty);
-        };
-        
-        synthesizer.SpeakCompleted += (s, e) =>
-        {
-            isSpeaking = false;
-            isPaused = false;
-            progress = 0;
-            currentWordIndex = 0;
-            SpeechFinished?.Invoke(this, EventArgs.Empty);
-        };
+        synthesizer.SpeakStarted += OnSpeakStarted;
+        synthesizer.SpeakProgress += OnSpeakProgress;
+        synthesizer.SpeakCompleted += OnSpeakCompleted;
     }
 
     public List<Voice> GetAvailableVoices()
@@ -113,14 +132,137 @@ public class TextToSpeech
             Stop();
         }
 
-        totalWords = text.Split(' ', StringSplitOptions.RemoveEmptyEntries).Length;
+        totalWords = TextSegmenter.CountWords(text);
         currentWordIndex = 0;
         progress = 0;
+        wordsSpokenInPrompt = 0;
 
         isSpeaking = true;
         isPaused = false;
-        
-        synthesizer.SpeakAsync(text);
+        isBuildingPrompts = true;
+
+        var cancellation = new CancellationTokenSource();
+        var slots = new SemaphoreSlim(PromptsAhead + 1);
+        playbackCancellation = cancellation;
+        promptSlots = slots;
+
+        // Prompts are queued on this thread so the synthesizer raises its events here too
+        var context = SynchronizationContext.Current;
+        void Post(Action action)
+        {
+            if (context != null)
+            {
+                context.Post(_ => action(), null);
+            }
+            else
+            {
+                action();
+            }
+        }
+
+        Task.Run(async () =>
+        {
+            try
+            {
+                int wordOffset = 0;
+                int index = 0;
+                foreach (var segment in TextSegmenter.Split(text))
+                {
+                    await slots.WaitAsync(cancellation.Token);
+                    PipelineEventSource.Log.BuildPromptStart(index);
+                    var builder = new PromptBuilder();
+                    builder.AppendText(segment.Text);
+                    var queued = new QueuedPrompt { Prompt = new Prompt(builder), Index = index++, WordOffset = wordOffset, WordCount = segment.WordCount };
+                    PipelineEventSource.Log.BuildPromptStop(queued.Index, segment.WordCount);
+                    wordOffset += segment.WordCount;
+                    Post(() => Enqueue(queued, cancellation));
+                }
+            }
+            catch (OperationCanceledException)
+            {
+                return; // Stopped; Stop has already cleared the queue
+            }
+            Post(() => OnPromptsBuilt(cancellation));
+        });
+    }
+
+    private void Enqueue(QueuedPrompt queued, CancellationTokenSource cancellation)
+    {
+        if (cancellation != playbackCancellation || cancellation.IsCancellationRequested)
+        {
+            return;
+        }
+        queuedPrompts.Enqueue(queued);
+        PipelineEventSource.Log.PromptQueued(queued.Index);
+        synthesizer.SpeakAsync(queued.Prompt);
+    }
+
+    private void OnPromptsBuilt(CancellationTokenSource cancellation)
+    {
+        if (cancellation != playbackCancellation)
+        {
+            return;
+        }
+        isBuildingPrompts = false;
+        if (queuedPrompts.Count == 0)
+        {
+            FinishSpeaking(); // Nothing to say, or every prompt has already been spoken
+        }
+    }
+
+    private void OnSpeakStarted(object? sender, SpeakStartedEventArgs e)
+    {
+        if (!queuedPrompts.TryPeek(out var current) || current.Prompt != e.Prompt)
+        {
+            return;
+        }
+        PipelineEventSource.Log.PromptStarted(current.Index);
+        if (current.WordOffset == 0)
+        {
+            SpeechStarted?.Invoke(this, EventArgs.Empty);
+        }
+    }
+
+    private void OnSpeakProgress(object? sender, SpeakProgressEventArgs e)
+    {
+        if (!queuedPrompts.TryPeek(out var current) || current.Prompt != e.Prompt)
+        {
+            return;
+        }
+        wordsSpokenInPrompt = Math.Min(wordsSpokenInPrompt + 1, current.WordCount);
+        currentWordIndex = current.WordOffset + wordsSpokenInPrompt;
+        progress = totalWords > 0 ? (float)currentWordIndex / totalWords : 0;
+        ProgressChanged?.Invoke(this, EventArgs.Empty);
+    }
+
+    private void OnSpeakCompleted(object? sender, SpeakCompletedEventArgs e)
+    {
+        // Prompts cancelled by Stop complete after their queue is gone
+        if (!queuedPrompts.TryPeek(out var current) || current.Prompt != e.Prompt)
+        {
+            return;
+        }
+        queuedPrompts.Dequeue();
+        PipelineEventSource.Log.PromptCompleted(current.Index);
+        wordsSpokenInPrompt = 0;
+        promptSlots?.Release();
+
+        if (queuedPrompts.Count == 0 && !isBuildingPrompts)
+        {
+            FinishSpeaking();
+        }
+    }
+
+    private void FinishSpeaking()
+    {
+        playbackCancellation?.Dispose();
+        playbackCancellation = null;
+        promptSlots = null;
+        isSpeaking = false;
+        isPaused = false;
+        progress = 0;
+        currentWordIndex = 0;
+        SpeechFinished?.Invoke(this, EventArgs.Empty);
     }
 
     public void Pause()
@@ -147,13 +289,31 @@ public class TextToSpeech
     {
         if (isSpeaking)
         {
+            playbackCancellation?.Cancel();
+            queuedPrompts.Clear();
+            isBuildingPrompts = false;
             synthesizer.SpeakAsyncCancelAll();
-            isSpeaking = false;
-            isPaused = false;
-            progress = 0;
-            currentWordIndex = 0;
-            SpeechFinished?.Invoke(this, EventArgs.Empty);
+            if (isPaused)
+            {
+                synthesizer.Resume(); // A paused synthesizer would hold the next text back
+            }
+            FinishSpeaking();
         }
     }
-}
 
+    /// <summary>
+    /// Renders <paramref name="pages"/> to an M4A file with the current voice and settings,
+    /// faster than real time and without playing anything.
+    /// </summary>
+    public Task<AudioExporter.ExportResult> ExportAsync(IEnumerable<(int PageNumber, string Text)> pages, int pageCount, string outputPath,
+        IProgress<double>? progress = null, CancellationToken cancellationToken = default)
+    {
+        var exporter = new AudioExporter
+        {
+            VoiceName = synthesizer.Voice.Name,
+            Rate = synthesizer.Rate,
+            Volume = synthesizer.Volume
+        };
+        return exporter.ExportAsync(pages, pageCount, outputPath, progress, cancellationToken);
+    }
+}